@@ -0,0 +1,383 @@
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include "benders.h"
+
+CBenders::CBenders(const char* name): CMIP(name),
+	m_iSubNum(0), m_iMaxHd(0), m_dCutTol(1.0e-6),
+	m_iLinkRowNum(0), m_iLinkNzNum(0), m_iLastSub(0),
+	m_ipEtaHd(0), m_dpLhs(0), m_ipLinkOf(0),
+	m_ppSub(0), m_dpY(0), m_ipHdPos(0), m_cpCutType(0)
+{
+} // end of CBenders::CBenders()
+
+#ifndef __ONE_THREAD_
+CBenders::CBenders(const CBenders &other, int thread): CMIP(other,thread)
+{
+	m_iSubNum=other.m_iSubNum;
+	m_iMaxHd=other.m_iMaxHd;
+	setWorkerNum(other.getWorkerNum());
+	setDeterministic(other.isDeterministic());
+	m_dCutTol=other.m_dCutTol;
+	m_iLinkRowNum=other.m_iLinkRowNum;
+	m_iLinkNzNum=other.m_iLinkNzNum;
+	m_iLastSub=other.m_iLastSub;
+	m_ipEtaHd=other.m_ipEtaHd;
+	m_ipRowBeg=other.m_ipRowBeg;
+	m_ipRow=other.m_ipRow;
+	m_dpLhs=other.m_dpLhs;
+	m_dpRhs=other.m_dpRhs;
+	m_ipNzBeg=other.m_ipNzBeg;
+	m_ipNzHd=other.m_ipNzHd;
+	m_dpNzVal=other.m_dpNzVal;
+	m_ipColBeg=other.m_ipColBeg;
+	m_ipColHd=other.m_ipColHd;
+	m_ipNzPos=other.m_ipNzPos;
+	m_ipMapBeg=other.m_ipMapBeg;
+	m_ipLinkOf=other.m_ipLinkOf;
+	m_ppSub=0; m_dpY=0; m_ipHdPos=0; m_cpCutType=0;
+	if (m_ipLinkOf)
+		allocThreadData();
+} // end of CBenders::CBenders(const CBenders &other, int thread)
+#endif
+
+CBenders::~CBenders()
+{
+	freeThreadData();
+#ifndef __ONE_THREAD_
+	if (!m_iThread) {
+#endif
+		if (m_ipEtaHd)
+			delete[] m_ipEtaHd;
+		if (m_dpLhs)
+			delete[] m_dpLhs;
+		if (m_ipLinkOf)
+			delete[] m_ipLinkOf;
+#ifndef __ONE_THREAD_
+	}
+#endif
+} // end of CBenders::~CBenders()
+
+void CBenders::openBenders(int subNum, int rowNum, int nzNum)
+{
+	m_iSubNum=subNum;
+	m_iLinkRowNum=m_iLinkNzNum=m_iLastSub=0;
+	if (!(m_ipEtaHd = new(std::nothrow) int[4*(subNum+1)+2*rowNum+3*nzNum+1]))
+		throw new CMemoryException("CBenders::openBenders");
+	if (!(m_dpLhs = new(std::nothrow) double[2*rowNum+nzNum]))
+		throw new CMemoryException("CBenders::openBenders");
+	m_ipRowBeg=m_ipEtaHd+subNum;
+	m_ipRow=m_ipRowBeg+subNum+1;
+	m_ipNzBeg=m_ipRow+rowNum;
+	m_ipNzHd=m_ipNzBeg+rowNum+1;
+	m_ipNzPos=m_ipNzHd+nzNum;
+	m_ipColBeg=m_ipNzPos+nzNum;
+	m_ipColHd=m_ipColBeg+subNum+1;
+	m_ipMapBeg=m_ipColHd+nzNum;
+	m_dpRhs=m_dpLhs+rowNum;
+	m_dpNzVal=m_dpRhs+rowNum;
+	m_ipRowBeg[0]=m_ipNzBeg[0]=0;
+	for (int k=0; k < subNum; ++k)
+		m_ipEtaHd[k]=-1;
+// Linked master variables are referenced by their positions in the node LP solution,
+// and these positions must not be changed by the preprocessor.
+	preprocOff();
+} // end of CBenders::openBenders
+
+void CBenders::addLinkRow(int k, int row, double lhs, double rhs,
+		int sz, const double* dpVal, const int* ipHd)
+{
+	if (k < m_iLastSub || k >= m_iSubNum)
+		throw new CDataException("CBenders::addLinkRow: linked rows must be ordered by subproblems");
+	for (; m_iLastSub < k; ++m_iLastSub)
+		m_ipRowBeg[m_iLastSub+1]=m_iLinkRowNum;
+	int r=m_iLinkRowNum++;
+	m_ipRow[r]=row;
+	m_dpLhs[r]=lhs;
+	m_dpRhs[r]=rhs;
+	int q=m_ipNzBeg[r];
+	for (int i=0; i < sz; ++i, ++q) {
+		m_ipNzHd[q]=ipHd[i];
+		m_dpNzVal[q]=dpVal[i];
+	}
+	m_ipNzBeg[r+1]=m_iLinkNzNum=q;
+} // end of CBenders::addLinkRow
+
+void CBenders::closeBenders()
+{
+	int K=m_iSubNum;
+	for (; m_iLastSub < K; ++m_iLastSub)
+		m_ipRowBeg[m_iLastSub+1]=m_iLinkRowNum;
+
+	int maxHd=0;
+	for (int k=0; k < K; ++k) {
+		if (m_ipEtaHd[k] < 0)
+			throw new CDataException("CBenders::closeBenders: eta variable is not set");
+		if (m_ipEtaHd[k] > maxHd)
+			maxHd=m_ipEtaHd[k];
+	}
+	for (int i=0; i < m_iLinkNzNum; ++i) {
+		if (m_ipNzHd[i] > maxHd)
+			maxHd=m_ipNzHd[i];
+	}
+	m_iMaxHd=++maxHd;
+
+// For each subproblem, list the master variables it is linked to,
+// and build the maps from subproblem rows to linked rows.
+	int *ipMark, *ipWhere;
+	if (!(ipMark = new(std::nothrow) int[2*maxHd]))
+		throw new CMemoryException("CBenders::closeBenders");
+	ipWhere=ipMark+maxHd;
+	for (int h=0; h < maxHd; ++h)
+		ipMark[h]=-1;
+	int cnt=0, mapSize=0;
+	for (int k=0; k < K; ++k) {
+		m_ipColBeg[k]=cnt;
+		m_ipMapBeg[k]=mapSize;
+		int rowNum=0;
+		for (int r=m_ipRowBeg[k]; r < m_ipRowBeg[k+1]; ++r) {
+			if (m_ipRow[r] >= rowNum)
+				rowNum=m_ipRow[r]+1;
+			for (int i=m_ipNzBeg[r]; i < m_ipNzBeg[r+1]; ++i) {
+				int h=m_ipNzHd[i];
+				if (ipMark[h] != k) {
+					ipMark[h]=k;
+					ipWhere[h]=cnt;
+					m_ipColHd[cnt++]=h;
+				}
+				m_ipNzPos[i]=ipWhere[h];
+			}
+		}
+		mapSize+=rowNum;
+	}
+	m_ipColBeg[K]=cnt;
+	m_ipMapBeg[K]=mapSize;
+	delete[] ipMark;
+
+	if (!(m_ipLinkOf = new(std::nothrow) int[mapSize+1]))
+		throw new CMemoryException("CBenders::closeBenders");
+	for (int i=0; i < mapSize; ++i)
+		m_ipLinkOf[i]=-1;
+	for (int k=0; k < K; ++k) {
+		for (int r=m_ipRowBeg[k]; r < m_ipRowBeg[k+1]; ++r)
+			m_ipLinkOf[m_ipMapBeg[k]+m_ipRow[r]]=r;
+	}
+	allocThreadData();
+} // end of CBenders::closeBenders
+
+void CBenders::allocThreadData()
+{
+	int K=m_iSubNum, maxLen=0;
+	for (int k=0; k < K; ++k) {
+		if (m_ipColBeg[k+1]-m_ipColBeg[k] > maxLen)
+			maxLen=m_ipColBeg[k+1]-m_ipColBeg[k];
+	}
+	++maxLen; // for eta
+	if (!(m_ppSub = new(std::nothrow) CLP*[K]))
+		throw new CMemoryException("CBenders::allocThreadData");
+	memset(m_ppSub,0,K*sizeof(CLP*));
+	if (!(m_dpY = new(std::nothrow) double[m_iMaxHd+m_ipColBeg[K]+K+maxLen]))
+		throw new CMemoryException("CBenders::allocThreadData");
+	m_dpCoeff=m_dpY+m_iMaxHd;
+	m_dpCutRhs=m_dpCoeff+m_ipColBeg[K];
+	m_dpCutVal=m_dpCutRhs+K;
+	if (!(m_ipHdPos = new(std::nothrow) int[m_iMaxHd+maxLen]))
+		throw new CMemoryException("CBenders::allocThreadData");
+	m_ipCutCol=m_ipHdPos+m_iMaxHd;
+	if (!(m_cpCutType = new(std::nothrow) char[K]))
+		throw new CMemoryException("CBenders::allocThreadData");
+} // end of CBenders::allocThreadData
+
+void CBenders::freeThreadData()
+{
+	if (m_ppSub) {
+		for (int k=0; k < m_iSubNum; ++k) {
+			if (m_ppSub[k])
+				delete m_ppSub[k];
+		}
+		delete[] m_ppSub;
+		m_ppSub=0;
+	}
+	if (m_dpY) {
+		delete[] m_dpY;
+		m_dpY=0;
+	}
+	if (m_ipHdPos) {
+		delete[] m_ipHdPos;
+		m_ipHdPos=0;
+	}
+	if (m_cpCutType) {
+		delete[] m_cpCutType;
+		m_cpCutType=0;
+	}
+} // end of CBenders::freeThreadData
+
+CLP* CBenders::getSubproblem(int k)
+{
+	if (!m_ppSub[k]) {
+		char name[32];
+		sprintf(name,"sub%d_%d",k,m_iThread); // names must differ in order not to mix log streams
+		CLP* pLp;
+		if (!(pLp = new(std::nothrow) CLP(name)))
+			throw new CMemoryException("CBenders::getSubproblem");
+		buildSubproblem(k,pLp);
+		pLp->preprocOff();
+		pLp->switchLpInfoMsg(false);
+		pLp->closeMatrix();
+		m_ppSub[k]=pLp;
+	}
+	return m_ppSub[k];
+} // end of CBenders::getSubproblem
+
+void CBenders::setMasterSolution(int n, const double* dpX, const tagHANDLE* ipColHd)
+{
+	for (int h=0; h < m_iMaxHd; ++h) {
+		m_ipHdPos[h]=-1;
+		m_dpY[h]=0.0;
+	}
+	for (int j=0; j < n; ++j) {
+		int h=ipColHd[j];
+		if (h >= 0 && h < m_iMaxHd) {
+			m_ipHdPos[h]=j;
+			m_dpY[h]=dpX[j];
+		}
+	}
+} // end of CBenders::setMasterSolution
+
+void CBenders::solveSubproblem(int k)
+{
+	CLP* pLp=m_ppSub[k];
+	const double *y=m_dpY;
+	double *dpCoeff=m_dpCoeff;
+	int *beg=m_ipNzBeg;
+
+// Set bounds of linked rows.
+	for (int r=m_ipRowBeg[k]; r < m_ipRowBeg[k+1]; ++r) {
+		double s=0.0, l=m_dpLhs[r], u=m_dpRhs[r];
+		for (int i=beg[r]; i < beg[r+1]; ++i)
+			s+=m_dpNzVal[i]*y[m_ipNzHd[i]];
+		pLp->setCtrBounds(m_ipRow[r],(l > -INF)? l-s: -INF,(u < INF)? u-s: INF);
+	}
+	pLp->optimize();
+
+	int c0=m_ipColBeg[k], c1=m_ipColBeg[k+1];
+	for (int t=c0; t < c1; ++t)
+		dpCoeff[t]=0.0;
+	m_cpCutType[k]=0;
+
+	if (pLp->isSolution()) {
+	// optimality cut: eta(k) + sum(t) coeff(t)*y(t) >= phi + sum(t) coeff(t)*y*(t),
+	// where coeff(t) = sum(r) p(r)*T(r,t), p(r) is shadow price of linked row r,
+	// and phi is the optimal value of subproblem k.
+		double *dpP=0;
+		int *ipHd=0;
+		pLp->getShadowPrices(dpP,ipHd);
+		double phi=pLp->getObjVal();
+		if (y[m_ipEtaHd[k]] < phi-m_dCutTol*(1.0+fabs(phi))) {
+			for (int r=m_ipRowBeg[k]; r < m_ipRowBeg[k+1]; ++r) {
+				double p=dpP[m_ipRow[r]];
+				if (p != 0.0) {
+					for (int i=beg[r]; i < beg[r+1]; ++i)
+						dpCoeff[m_ipNzPos[i]]+=p*m_dpNzVal[i];
+				}
+			}
+			for (int t=c0; t < c1; ++t)
+				phi+=dpCoeff[t]*y[m_ipColHd[t]];
+			m_dpCutRhs[k]=phi;
+			m_cpCutType[k]=1;
+		}
+	}
+	else if (pLp->isLpInfeasible()) {
+	// feasibility cut: sum(t) coeff(t)*y(t) <= R + sum(t) coeff(t)*y*(t),
+	// where coeff(t) = sum(r) u(r)*T(r,t), u is Farkas certificate,
+	// and R < 0 is the value of the certificate at y*.
+		int m, n, *ipRowHd=0, *ipColHd=0;
+		double *dpYctr=0, *dpYbd=0, R=0.0;
+		pLp->whyLpInfeasible(m,ipRowHd,dpYctr,n,ipColHd,dpYbd);
+		int *ipLinkOf=m_ipLinkOf+m_ipMapBeg[k],
+			mapSize=m_ipMapBeg[k+1]-m_ipMapBeg[k];
+		for (int i=0; i < m; ++i) {
+			double u=dpYctr[i];
+			int row=ipRowHd[i];
+			if (u > 0.0)
+				R+=u*pLp->getRHS(row);
+			else if (u < 0.0)
+				R+=u*pLp->getLHS(row);
+			else
+				continue;
+			int r;
+			if (row < mapSize && (r=ipLinkOf[row]) >= 0) {
+				for (int q=beg[r]; q < beg[r+1]; ++q)
+					dpCoeff[m_ipNzPos[q]]+=u*m_dpNzVal[q];
+			}
+		}
+		for (int j=0; j < n; ++j) {
+			if (dpYbd[j] > 0.0)
+				R+=dpYbd[j]*pLp->getVarUpBound(ipColHd[j]);
+			else if (dpYbd[j] < 0.0)
+				R+=dpYbd[j]*pLp->getVarLoBound(ipColHd[j]);
+		}
+		for (int t=c0; t < c1; ++t)
+			R+=dpCoeff[t]*y[m_ipColHd[t]];
+		m_dpCutRhs[k]=R;
+		m_cpCutType[k]=2;
+	}
+} // end of CBenders::solveSubproblem
+
+int CBenders::solveAllSubproblems()
+{
+	int K=m_iSubNum;
+// Subproblems are built by the calling thread, so that exceptions are not thrown in worker threads.
+	for (int k=0; k < K; ++k)
+		getSubproblem(k);
+	runJobs(K);
+	int cutNum=0;
+	for (int k=0; k < K; ++k) {
+		if (m_cpCutType[k])
+			++cutNum;
+	}
+	return cutNum;
+} // end of CBenders::solveAllSubproblems
+
+bool CBenders::separate(int n, const double* dpX, const tagHANDLE* ipColHd, bool genFlag)
+{
+	setMasterSolution(n,dpX,ipColHd);
+	int cutNum=solveAllSubproblems();
+	if (!genFlag || !cutNum)
+		return (cutNum > 0);
+
+	cutNum=0;
+	for (int k=0; k < m_iSubNum; ++k) { // cuts are added in order of subproblems
+		if (!m_cpCutType[k])
+			continue;
+		int sz=0;
+		bool bOK=true;
+		if (m_cpCutType[k] == 1) {
+			m_dpCutVal[0]=1.0;
+			m_ipCutCol[0]=m_ipHdPos[m_ipEtaHd[k]];
+			sz=1;
+		}
+		for (int t=m_ipColBeg[k]; t < m_ipColBeg[k+1]; ++t) {
+			if (fabs(m_dpCoeff[t]) > 1.0e-12) {
+				if ((m_ipCutCol[sz]=m_ipHdPos[m_ipColHd[t]]) < 0) {
+					bOK=false;
+					break;
+				}
+				m_dpCutVal[sz++]=m_dpCoeff[t];
+			}
+		}
+		if (!bOK || !sz || m_ipCutCol[0] < 0)
+			continue;
+		if (m_cpCutType[k] == 1)
+			addCut(-1,0,m_dpCutRhs[k],INF,sz,m_dpCutVal,m_ipCutCol,false);
+		else
+			addCut(-1,0,-INF,m_dpCutRhs[k],sz,m_dpCutVal,m_ipCutCol,false);
+		++cutNum;
+	}
+	return (cutNum > 0);
+} // end of CBenders::separate
+
+bool CBenders::isFeasible(int n, const double* dpX, const tagHANDLE* ipColHd)
+{
+	return !separate(n,dpX,ipColHd,false);
+} // end of CBenders::isFeasible
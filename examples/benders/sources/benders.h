@@ -0,0 +1,156 @@
+#ifndef __BENDERS__H
+#define __BENDERS__H
+
+#include <cmip.h>
+#include <except.h>
+#include <jobPool.h>
+
+/// Generic Benders decomposition driver.
+/**
+ * The master problem is an ordinary `CMIP` built by the derived class;
+ * for each subproblem `k`, it must contain a continuous variable `eta(k)`
+ * that estimates from below the optimal value of subproblem `k`.
+ *
+ * Subproblem `k` is an LP (minimization) that is built by the derived class in `buildSubproblem()`.
+ * Some rows of a subproblem are _linked_ to master variables: if `y` is the master solution,
+ * the bounds of linked row `i` are `lhs(i) - T(i)y` and `rhs(i) - T(i)y`.
+ *
+ * Given a master solution `(y,eta)`, `separate()` solves all subproblems
+ * (the LPs are kept in memory, and each LP is reoptimized starting from its previous basis), and
+ *   - if subproblem `k` is infeasible, a _feasibility cut_ is built from a Farkas certificate;
+ *   - if the optimal value of subproblem `k` is greater than `eta(k)`,
+ *      an _optimality cut_ is built from the shadow prices.
+ *
+ * Each thread of the solver has its own copies of the subproblem LPs.
+ * In addition, independent subproblems processed by one thread can be solved in parallel
+ * by the workers of `CJobPool` (see `setSubThreadNum()`); cuts are always added in the order of subproblem indices.
+ */
+class CBenders: public CMIP, private CJobPool
+{
+protected:
+	int m_iSubNum; ///< number of subproblems.
+	int m_iMaxHd; ///< all master variables in linked rows have handles less than `m_iMaxHd`.
+	double m_dCutTol; ///< relative tolerance for violation of optimality cuts.
+
+// Linked rows; these data are shared by all threads.
+	int m_iLinkRowNum, m_iLinkNzNum; ///< number of linked rows, and number of nonzeros in all `T(i)`.
+	int m_iLastSub; ///< subproblem of the last added linked row.
+	int *m_ipEtaHd; ///< `m_ipEtaHd[k]` is handle of variable `eta(k)`.
+	int *m_ipRowBeg; ///< linked rows of subproblem `k` are `m_ipRowBeg[k],...,m_ipRowBeg[k+1]-1`.
+	int *m_ipRow; ///< `m_ipRow[r]` is index (in its subproblem) of linked row `r`.
+	double *m_dpLhs, *m_dpRhs; ///< constant parts of left and right hand sides of linked rows.
+	int *m_ipNzBeg; ///< nonzeros of `T(r)` are stored in positions `m_ipNzBeg[r],...,m_ipNzBeg[r+1]-1`.
+	int *m_ipNzHd; ///< master handles of nonzero entries of linked rows.
+	double *m_dpNzVal; ///< nonzero entries of linked rows.
+	int *m_ipColBeg; ///< master variables linked to subproblem `k` are in positions `m_ipColBeg[k],...,m_ipColBeg[k+1]-1` of `m_ipColHd`.
+	int *m_ipColHd; ///< handles of master variables linked to subproblems.
+	int *m_ipNzPos; ///< `m_ipColHd[m_ipNzPos[i]]` is equal to `m_ipNzHd[i]`.
+	int *m_ipMapBeg; ///< for row `i` of subproblem `k`, `m_ipLinkOf[m_ipMapBeg[k]+i]` is index of linked row, or `-1`.
+	int *m_ipLinkOf; ///< see `m_ipMapBeg`.
+
+// Per thread data.
+	CLP** m_ppSub; ///< `m_ppSub[k]` is LP of subproblem `k`, or `0` if it has not been built yet.
+	double *m_dpY; ///< `m_dpY[hd]` is value of master variable with handle `hd`.
+	int *m_ipHdPos; ///< `m_ipHdPos[hd]` is position of master variable `hd` in the current solution, or `-1`.
+	double *m_dpCoeff; ///< `m_dpCoeff[i]` is coefficient of variable `m_ipColHd[i]` in the cut produced by its subproblem.
+	double *m_dpCutRhs; ///< `m_dpCutRhs[k]` is right hand side of the cut produced by subproblem `k`.
+	char *m_cpCutType; ///< `m_cpCutType[k]` is `0` (no cut), `1` (optimality cut), or `2` (feasibility cut).
+	double *m_dpCutVal; ///< buffer for storing coefficients of the cut being added.
+	int *m_ipCutCol; ///< buffer for storing columns of the cut being added.
+
+public:
+	/**
+	 * \param[in] name problem name.
+	 */
+	CBenders(const char* name);
+#ifndef __ONE_THREAD_
+	CBenders(const CBenders &other, int thread); ///< clone constructor.
+#endif
+	virtual ~CBenders();
+
+	/**
+	 * The function allocates memory for storing linked rows.
+	 * \param[in] subNum number of subproblems;
+	 * \param[in] rowNum total number of linked rows in all subproblems;
+	 * \param[in] nzNum total number of nonzero entries in all linked rows.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void openBenders(int subNum, int rowNum, int nzNum);
+
+	/**
+	 * \param[in] k subproblem index;
+	 * \param[in] hd handle of master variable `eta(k)`.
+	 */
+	void setEtaVar(int k, int hd)
+		{m_ipEtaHd[k]=hd;}
+
+	/**
+	 * The function declares that row `row` of subproblem `k` is linked to the master variables.
+	 * Linked rows must be added in non-decreasing order of subproblem indices.
+	 * \param[in] k subproblem index;
+	 * \param[in] row row index in subproblem `k`;
+	 * \param[in] lhs,rhs constant parts of left and right hand sides;
+	 * \param[in] sz number of nonzero entries in `T(row)`;
+	 * \param[in] dpVal,ipHd `dpVal[i]` is coefficient of master variable with handle `ipHd[i]`.
+	 * \throws CDataException when subproblems are not ordered.
+	 */
+	void addLinkRow(int k, int row, double lhs, double rhs,
+			int sz, const double* dpVal, const int* ipHd);
+
+	/**
+	 * The function must be called after all linked rows have been added.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void closeBenders();
+
+	/**
+	 * \param[in] threadNum number of threads used to solve subproblems within one call to `separate()`;
+	 * \param[in] deterministic if `true`, each worker always solves the same block of subproblems
+	 * (see `CJobPool::setDeterministic()`), so a subproblem LP is always reoptimized by the same thread.
+	 */
+	void setSubThreadNum(int threadNum, bool deterministic=true)
+		{setWorkerNum(threadNum); setDeterministic(deterministic);}
+
+	/**
+	 * \param[in] tol new relative tolerance for violation of optimality cuts.
+	 */
+	void setCutTolerance(double tol)
+		{m_dCutTol=tol;}
+
+protected:
+	/**
+	 * The function builds subproblem `k`. It is called at most once for each subproblem and each thread
+	 * (of the solver), when that thread first calls `separate()`.
+	 * \param[in] k subproblem index;
+	 * \param[in,out] pLp empty LP to be filled in; the function must call `pLp->openMatrix()`,
+	 * and then add all variables and rows; `CBenders` closes the matrix.
+	 * \remark Row indices must coincide with row handles.
+	 */
+	virtual void buildSubproblem(int k, CLP* pLp)=0;
+
+	bool separate(int n, const double* dpX, const tagHANDLE* ipColHd, bool genFlag);
+	bool isFeasible(int n, const double* dpX, const tagHANDLE* ipColHd);
+
+private:
+	void allocThreadData();
+	void freeThreadData();
+	void setMasterSolution(int n, const double* dpX, const tagHANDLE* ipColHd);
+	CLP* getSubproblem(int k);
+
+	/**
+	 * The function solves subproblem `k` for the master solution stored in `m_dpY`,
+	 * and stores in thread data a violated cut (if any).
+	 */
+	void solveSubproblem(int k);
+
+	/**
+	 * The function solves all subproblems, possibly in parallel.
+	 * \return number of violated cuts.
+	 */
+	int solveAllSubproblems();
+
+	void runJob(int k, int /*worker*/)
+		{solveSubproblem(k);}
+};
+
+#endif // __BENDERS__H
@@ -0,0 +1,130 @@
+#include <iostream>
+#include "fcnfBenders.h"
+
+#ifndef __ONE_THREAD_
+CFcnfBenders::CFcnfBenders(const CFcnfBenders &other, int thread): CBenders(other,thread)
+{
+	m_bMemory=false;
+	m_iVertNum=other.m_iVertNum;
+	m_iEdgeNum=other.m_iEdgeNum;
+	m_ipTail=other.m_ipTail;
+	m_ipHead=other.m_ipHead;
+	m_ipCap=other.m_ipCap;
+	m_ipFxCost=other.m_ipFxCost;
+	m_ipCost=other.m_ipCost;
+	m_ipDem=other.m_ipDem;
+}
+
+CMIP* CFcnfBenders::clone(const CMIP *pMip, int thread)
+{
+	return static_cast<CMIP*>(new CFcnfBenders(*static_cast<CFcnfBenders*>(const_cast<CMIP*>(pMip)),thread));
+}
+#endif
+
+CFcnfBenders::~CFcnfBenders()
+{
+	if (m_bMemory && m_ipTail)
+		delete[] m_ipTail;
+}
+
+void CFcnfBenders::readNet(const char* fileName)
+{
+	std::ifstream fin(fileName);
+	if (!fin.is_open()) {
+		throw new CFileException("CFcnfBenders::readNet",fileName);
+	}
+
+	int n,m;
+	fin >> n >> m;
+	m_iVertNum=n; m_iEdgeNum=m;
+
+	if (!(m_ipTail = new(std::nothrow) int[5*m+n])) {
+		fin.close();
+		throw new CMemoryException("CFcnfBenders::readNet");
+	}
+	m_bMemory=true;
+
+	m_ipDem=(m_ipCost=(m_ipFxCost=(m_ipCap=(m_ipHead=m_ipTail+m)+m)+m)+m)+m;
+
+	for (int i=0; i < n; ++i) {
+		fin >> m_ipDem[i];
+	}
+
+	for (int i=0; i < m; ++i) {
+		fin >> m_ipTail[i] >> m_ipHead[i] >> m_ipCap[i]
+			>> m_ipFxCost[i] >> m_ipCost[i];
+	}
+
+	fin.close();
+} // end of CFcnfBenders::readNet
+
+void CFcnfBenders::model()
+{
+	int n=m_iVertNum, m=m_iEdgeNum, r;
+	double w;
+
+// The master problem includes a cover inequality for each vertex with non-zero demand:
+// the capacity of open arcs entering (leaving) a sink (source) must not be less than its demand.
+	openMatrix(n,m+1,2*m+1);
+	setObjSense(false);
+	for (int v=0; v < n; ++v) {
+		w=(m_ipDem[v] > 0)? m_ipDem[v]: -m_ipDem[v];
+		addCtr(v,0,w,INF);
+	}
+	for (int e=0; e < m; ++e) {
+		addVar(e,VAR_BIN,m_ipFxCost[e],0.0,1.0);
+		if (m_ipDem[r=m_ipHead[e]] > 0)
+			addEntry(m_ipCap[e],r,e);
+		if (m_ipDem[r=m_ipTail[e]] < 0)
+			addEntry(m_ipCap[e],r,e);
+	}
+	addVar(m,0,1.0,0.0,VAR_INF); // eta
+
+	openBenders(1,m,m);
+	setEtaVar(0,m);
+	for (int e=0; e < m; ++e) { // f(e) <= cap(e)*y(e)
+		w=-m_ipCap[e];
+		addLinkRow(0,n+e,-INF,0.0,1,&w,&e);
+	}
+	closeMatrix();
+	closeBenders();
+} // end of CFcnfBenders::model
+
+void CFcnfBenders::buildSubproblem(int /*k*/, CLP* pLp)
+{
+	int n=m_iVertNum, m=m_iEdgeNum, ipRow[3];
+	double dpVal[3];
+	pLp->openMatrix(n+m,m,3*m);
+	pLp->setObjSense(false);
+	for (int v=0; v < n; ++v) {
+		pLp->addCtr(v,0,m_ipDem[v],m_ipDem[v]);
+	}
+	for (int e=0; e < m; ++e) {
+		pLp->addCtr(n+e,0,-INF,0.0);
+	}
+	dpVal[0]=-1.0; dpVal[1]=dpVal[2]=1.0;
+	for (int e=0; e < m; ++e) {
+		ipRow[0]=m_ipTail[e]; ipRow[1]=m_ipHead[e]; ipRow[2]=n+e;
+		pLp->addColumn(e,0,m_ipCost[e],0.0,VAR_INF,3,dpVal,ipRow);
+	}
+} // end of CFcnfBenders::buildSubproblem
+
+void CFcnfBenders::printSolution(const char* name)
+{
+	double *dpX;
+	int m,*ipHd;
+	m=m_iEdgeNum;
+	std::ofstream fout(name);
+	if (isSolution()) {
+		getSolution(dpX,ipHd);
+		fout << "Open arcs:\n";
+		for (int i=0; i <= m; ++i) {
+			if (ipHd[i] < m && dpX[i] > 0.5) {
+				fout << "(" << m_ipTail[ipHd[i]] << ","
+					<< m_ipHead[ipHd[i]] << ")" << std::endl;
+			}
+		}
+	}
+	else fout << "Problem has no solution!\n";
+	fout.close();
+} // end of CFcnfBenders::printSolution
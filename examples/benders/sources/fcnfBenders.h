@@ -0,0 +1,39 @@
+#ifndef __FCNF_BENDERS__H
+#define __FCNF_BENDERS__H
+
+#include "benders.h"
+
+/// Benders decomposition for the fixed charge network flow problem.
+/**
+ * The master problem selects the arcs to open (binary variables `y(e)`, handles `0,...,m-1`),
+ * and estimates the flow cost by variable `eta` (handle `m`);
+ * the only subproblem is the min-cost flow problem on the opened arcs:
+ * flow `f(e)` on arc `e` is bounded by `cap(e)*y(e)`.
+ */
+class CFcnfBenders: public CBenders
+{
+	bool m_bMemory;
+	int m_iVertNum,m_iEdgeNum;
+	int *m_ipHead, *m_ipTail,
+		*m_ipFxCost, *m_ipCost,
+		*m_ipCap,*m_ipDem;
+public:
+	CFcnfBenders(const char* name): CBenders(name), m_bMemory(false), m_ipTail(0)
+	{};  ///< constructor
+
+#ifndef __ONE_THREAD_
+	CFcnfBenders(const CFcnfBenders &other, int thread);
+	CMIP* clone(const CMIP *pMip, int thread);
+#endif
+
+	virtual ~CFcnfBenders(); ///< destructor
+
+	// implementation
+	void readNet(const char* fileName);
+	void model();
+	void printSolution(const char* fileName); ///< overrides base class function
+protected:
+	void buildSubproblem(int k, CLP* pLp);
+};
+
+#endif // __FCNF_BENDERS__H
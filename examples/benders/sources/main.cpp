@@ -0,0 +1,31 @@
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include "fcnfBenders.h"
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		std::cerr << "File name is omitted!\n";
+		return 1;
+	}
+	try {
+		CFcnfBenders prob("FCNF_Benders");
+		prob.readNet(argv[1]);
+		prob.model();
+		if (argc > 2)
+			prob.setSubThreadNum(atoi(argv[2]));
+		prob.optimize();
+
+		char name[128];
+		strcpy(name,argv[1]);
+		strcat(name,".bsol");
+		prob.printSolution(name);
+	}
+	catch(CException* pe) {
+		std::cerr << pe->what() << std::endl;
+		delete pe;
+		return 1;
+	}
+	return 0;
+}
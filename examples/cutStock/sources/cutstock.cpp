@@ -13,8 +13,16 @@ CCutStock::CCutStock(const char* name): m_dpF(0), CMIP(name)
 }
 
 #ifndef __ONE_THREAD_
-CCutStock::CCutStock(const CCutStock &other, int thread): CMIP(other,thread)
+CCutStock::CCutStock(const CCutStock &other, int thread): CMIP(other,thread), m_dpF(0)
 {
+// problem data are shared; scratch memory is allocated when the clone first calls generateColumns()
+	m_ipFinalLength=other.m_ipFinalLength;
+	m_ipFinalNum=other.m_ipFinalNum;
+	m_iRawLength=other.m_iRawLength;
+	m_iFinalTypeNum=other.m_iFinalTypeNum;
+	m_stab.setAlpha(other.m_stab.getAlpha());
+	m_stab.setBox(other.m_stab.getBox());
+	m_stab.setWentges(other.m_stab.isWentges());
 }
 
 CMIP* CCutStock::clone(const CMIP *pMip, int thread)
@@ -25,9 +33,6 @@ CMIP* CCutStock::clone(const CMIP *pMip, int thread)
 
 CCutStock::~CCutStock()
 {
-#ifndef __ONE_THREAD_
-	if (!m_iThread)
-#endif
 	if (m_dpF)
 		delete[] m_dpF;
 }
@@ -101,23 +106,42 @@ bool CCutStock::generateColumns(int m, const tagHANDLE* ipRowHd, const double* d
 		return false;
 	double *c{m_dpArray+m};
 	int *x{m_ipArray+m};
-	bool flag{false};
-	for (int i{0}; i < m; ++i)
-		c[i]=-dpY[i];
-	if (intKnapsack(m,c,m_ipFinalLength,m_iRawLength,x,m_dpF) > 1.0+getVarTol()) {
-		int sz{0};
-		for (int i{0}; i < m; ++i) {
-			if (x[i] > 0) {
-				m_dpArray[sz]=(double)x[i];
-				m_ipArray[sz++]=i;
+	double tol{1.0+getVarTol()};
+	if (!m_dpF && !(m_dpF = new(std::nothrow) double[m_iRawLength+1]))
+		throw new CMemoryException("CCutStock::generateColumns()");
+	const double *pi{m_stab.stabilize(m,ipRowHd,dpY)};
+	do {
+		for (int i{0}; i < m; ++i)
+			c[i]=-pi[i];
+		double w{intKnapsack(m,c,m_ipFinalLength,m_iRawLength,x,m_dpF)};
+		if (m_stab.isWentges()) { // Farley bound: (sum of demands weighted by duals)/max(1,w)
+			double z{0.0};
+			for (int i{0}; i < m; ++i)
+				if (ipRowHd[i] < m_iFinalTypeNum)
+					z+=c[i]*m_ipFinalNum[ipRowHd[i]];
+			m_stab.updateCenter((w > 1.0)? z/w: z);
+		}
+		if (w > tol) {
+			double v{0.0};
+			for (int i{0}; i < m; ++i)
+				v-=x[i]*dpY[i];
+			if (v > tol) { // pattern is also improving for true duals
+				int sz{0};
+				for (int i{0}; i < m; ++i) {
+					if (x[i] > 0) {
+						m_dpArray[sz]=(double)x[i];
+						m_ipArray[sz++]=i;
+					}
+				}
+				addNewColumn(-1,VAR_INT,1.0,0.0,VAR_INF,
+				             sz,m_dpArray,m_ipArray,
+				             false,false,0,true);
+				m_stab.columnsGenerated();
+				return true;
 			}
 		}
-		addNewColumn(-1,VAR_INT,1.0,0.0,VAR_INF,
-                     sz,m_dpArray,m_ipArray,
-                     false,false,0,true);
-		flag=true;
-	}
-	return flag;
+	} while ((pi=m_stab.mispricing()));
+	return false;
 } // end of CCutStock::generateColumns()
 
 double CCutStock::intKnapsack(int n, double *c, int* a, int b, int *x, double *dpMem)
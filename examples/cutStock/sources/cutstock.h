@@ -1,4 +1,5 @@
 #include <cmip.h>
+#include <dualStab.h>
 
 class CCutStock: public CMIP
 {
@@ -7,6 +8,7 @@ class CCutStock: public CMIP
 	int *m_ipFinalNum;
 	int m_iRawLength;
 	int m_iFinalTypeNum;
+	CDualStabilizer m_stab; ///< smooths dual values passed to generateColumns()
 
 public:
 	CCutStock(const char* name);
@@ -20,6 +22,14 @@ public:
 	void init(int m, int *l, int *q, int L);
 	void newColumn(int &k, int *S, int *b, int &sz);
 
+	/**
+	 * \param[in] alpha dual smoothing parameter, `alpha=0` switches off smoothing;
+	 * \param[in] box if positive, half-width of the box around stability center;
+	 * \param[in] wentges if `true`, the center is moved only when the Farley bound is improved (Wentges' scheme).
+	 */
+	void setDualStabilization(double alpha, double box=0.0, bool wentges=false)
+		{m_stab.setAlpha(alpha); m_stab.setBox(box); m_stab.setWentges(wentges);}
+
 	bool generateColumns(int m, const tagHANDLE *ipRowHd, const double *dpY) final;
 	static double intKnapsack(int n, double *c, int *a, int b, int*x, double *dpMem=0);
 
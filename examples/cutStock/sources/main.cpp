@@ -1,6 +1,7 @@
 #include <iostream>
 #include <except.h>
 #include <cstring>
+#include <cstdlib>
 #include <fstream>
 
 #include "cutstock.h"
@@ -39,6 +40,8 @@ int main(int argc, char** argv)
 		readData(argv[1],m,L,l,q);
 		CCutStock prob("CutStock");
 		prob.init(m,l,q,L);
+		if (argc > 2) // smoothing parameter, and (optionally) 1 to use Wentges' scheme
+			prob.setDualStabilization(atof(argv[2]),0.0,argc > 3 && atoi(argv[3]));
 		prob.optimize();
 		char sol[256];
 		strcpy(sol,argv[1]);
@@ -8,7 +8,8 @@
 CGenAssign::CGenAssign(const char* name, int m, int n, int* l, int* c, int* p):
 	CMIP(name), m_bOK{true},
 	m_iTskNum(m), m_iMachNum(n),
-	m_ipMachCap(l), m_ipCost(c), m_ipProcTime(p)
+	m_ipMachCap(l), m_ipCost(c), m_ipProcTime(p),
+	m_iPrcWorkerNum{0}, m_ipCol{0}, m_iPrcNode{-1}
 {
 	int q{m*n};
 	int k{q>>4};
@@ -19,15 +20,15 @@ CGenAssign::CGenAssign(const char* name, int m, int n, int* l, int* c, int* p):
         if (l[j] > q)
             q=l[j];
     }
+	m_iQ=q;
 	try {
 		m_ipAssign= new(std::nothrow) int[m];
 		m_ipNd = new(std::nothrow) int[m_iSizeOfNodeData=k];
-		KNAPSACK::getMemForBinKnapsack(m,m_iQ=q,m_dpKn,m_ipKn);
-	} catch(std::bad_alloc* e) {
+		allocPricingMem(1);
+	} catch(std::bad_alloc& e) {
 		m_bOK=false;
 		strcpy(m_sWarningMsg,"CGenAssign::CGenAssign(: ");
-		strncat(m_sWarningMsg,e->what(),128);
-		delete e;
+		strncat(m_sWarningMsg,e.what(),128);
     }
 	if (m_bOK) {
 		memset(m_ipNd,0,m_iSizeOfNodeData*sizeof(int));
@@ -46,14 +47,20 @@ CGenAssign::CGenAssign(const CGenAssign &other, int thread): CMIP(other,thread)
 	m_ipCost=other.m_ipCost;
 	m_ipProcTime=other.m_ipProcTime;
 	m_ipAssign=other.m_ipAssign;
+	m_iPrcWorkerNum=0;
+	m_ipCol=0;
+	m_iPrcNode=-1;
+	m_stab.setAlpha(other.m_stab.getAlpha());
+	m_stab.setBox(other.m_stab.getBox());
+	setWorkerNum(other.getWorkerNum());
+	setDeterministic(other.isDeterministic());
 	try {
+	// pricing memory is allocated when the clone first calls generateColumns()
 		m_ipNd=new(std::nothrow) int[m_iSizeOfNodeData=other.m_iSizeOfNodeData];
-		KNAPSACK::getMemForBinKnapsack(m_iTskNum,m_iQ,m_dpKn,m_ipKn);
-	} catch(std::bad_alloc* e) {
+	} catch(std::bad_alloc& e) {
 		m_bOK=false;
 		strcpy(m_sWarningMsg,"CGenAssign::CGenAssign(: ");
-		strncat(m_sWarningMsg,e->what(),128);
-		delete e;
+		strncat(m_sWarningMsg,e.what(),128);
     }
 	if (m_bOK)
 		memset(m_ipNd,0,m_iSizeOfNodeData*sizeof(int));
@@ -81,16 +88,46 @@ CGenAssign::~CGenAssign()
         delete[] m_ipNd;
         m_ipNd=0;
 	}
-	if (m_dpKn) {
-		delete[] m_dpKn;
-		m_dpKn=0;
+	for (int t{0}; t < m_iPrcWorkerNum; ++t) {
+		delete[] m_dpKn[t];
+		delete[] m_ipKn[t];
+		delete[] m_dpPrc[t];
+		delete[] m_ipPrc[t];
 	}
-	if (m_ipKn) {
-		delete[] m_ipKn;
-		m_ipKn=0;
+	if (m_ipCol) {
+		delete[] m_ipCol;
+		m_ipCol=0;
 	}
 }
 
+void CGenAssign::allocPricingMem(int workerNum)
+{
+	int m{m_iTskNum}, n{m_iMachNum};
+	if (!m_ipCol) {
+		m_ipCol=new int[n*(m+3)];
+		m_ipColCost=(m_ipColSz=m_ipCol+n*(m+1))+n;
+	}
+	for (int t{m_iPrcWorkerNum}; t < workerNum; m_iPrcWorkerNum=++t) {
+		KNAPSACK::getMemForBinKnapsack(m,m_iQ,m_dpKn[t],m_ipKn[t]);
+		m_dpPrc[t]=new double[m];
+		m_ipPrc[t]=new int[3*m];
+	}
+} // end of CGenAssign::allocPricingMem()
+
+void CGenAssign::setPricingThreadNum(int threadNum, bool deterministic)
+{
+	if (threadNum > MAX_WORKER_NUM)
+		threadNum=MAX_WORKER_NUM;
+	try {
+		allocPricingMem(threadNum);
+	}
+	catch(std::bad_alloc&) {
+		throw new CMemoryException("CGenAssign::setPricingThreadNum");
+	}
+	setWorkerNum(threadNum);
+	setDeterministic(deterministic);
+} // end of CGenAssign::setPricingThreadNum()
+
 void CGenAssign::buildMaster()
 {
 	int *l{m_ipMachCap}, *c{m_ipCost};
@@ -238,60 +275,98 @@ bool CGenAssign::updateBranch(int k)
 	return true;
 } // end of CGenAssign::updateBranch()
 
-bool CGenAssign::generateColumns(int ctrNum, const tagHANDLE* ipRowHd, const double* dpY)
+void CGenAssign::runJob(int j, int worker)
 {
-    double c0, z, tol=getRedCostTol();
-    int b, num, m{m_iTskNum}, n{m_iMachNum};
-    double *w{m_dpArray+(m+1)};
-	int *x, *a, *ipTsk, *ipRow{m_ipArray},
-        *c{m_ipCost}, *p{m_ipProcTime}, *l{m_ipMachCap};
-   ipTsk=ipRow +(m+1); x=(a=ipTsk+m)+m;
+    double c0{0.0}, z, tol{m_dRedCostTol};
+    const double *dpY{m_dpY};
+    int m{m_iTskNum}, b{m_ipMachCap[j]}, q{0}, sz{0}, k{0};
+    int *c{m_ipCost+j*m}, *p{m_ipProcTime+j*m},
+        *ipRow{m_ipCol+j*(m+1)};
+    double *w{m_dpPrc[worker]};
+    int *ipTsk{m_ipPrc[worker]}, *a{ipTsk+m}, *x{a+m};
 
-    for (int i{0}; i <= m; ++i) {
-        m_dpArray[i]=1.0;
-    }
-
-    num=0;
-    for (int j{0}; j < n; ++j) {
-    	int q{0}, sz{0}, k{0};
-        b=l[j];
-        c0=0.0;
-        for (int e, i{0}; i < m; ++i) {
-            if (!(e=getGammaEntry(i,j))) {
-				if (p[i] <= l[j]) {
-					z=-c[i]-dpY[i];
-					if (z > tol) {
-						ipTsk[k]=i;
-						w[k]=z;
-						a[k++]=p[i];
-					}
-				}
+    m_ipColSz[j]=0;
+    for (int e, i{0}; i < m; ++i) {
+        if (!(e=getGammaEntry(i,j))) {
+            if (p[i] <= m_ipMachCap[j]) {
+                z=-c[i]-dpY[i];
+                if (z > tol) {
+                    ipTsk[k]=i;
+                    w[k]=z;
+                    a[k++]=p[i];
+                }
             }
-            else if (e == 1) {
-                q+=c[i];
-                ipRow[sz++]=i;
-                b-=p[i];
-                c0-=(c[i]+dpY[i]);
+        }
+        else if (e == 1) {
+            q+=c[i];
+            ipRow[sz++]=i;
+            b-=p[i];
+            c0-=(c[i]+dpY[i]);
+        }
+    }
+    if (k && b > 0) {
+        if (KNAPSACK::binKnapsack(k,w,a,b,x,m_dpKn[worker],m_ipKn[worker]) > dpY[m+j]-c0+tol) {
+            for (int i{0}; i < k; ++i) {
+                if (x[i]) {
+                    q+=c[ipTsk[i]];
+                    ipRow[sz++]=ipTsk[i];
+                }
             }
+            ipRow[sz++]=m+j;
+            m_ipColCost[j]=q;
+            m_ipColSz[j]=sz;
         }
-        if (k && b > 0) {
-	        if (KNAPSACK::binKnapsack(k,w,a,b,x,m_dpKn,m_ipKn) > dpY[m+j]-c0+tol) {
-				for (int i{0}; i < k; ++i) {
-	                if (x[i]) {
-	                    q+=c[ipTsk[i]];
-	                    ipRow[sz++]=ipTsk[i];
-	                }
-	            }
-	            ipRow[sz++]=m+j;
-	            sz=addNewColumn(-1,VAR_BIN,-q,0.0,1.0,sz,m_dpArray,m_ipArray,false,false,0,true);
-	            ++num;
-			    w=m_dpArray+(m+1); ///< it is possible that memory for `m_ipArray` and `m_dpArray` has been reallocated
-				x=(a=(ipTsk=(ipRow=m_ipArray)+(m+1))+m)+m;
-			}
+    }
+} // end of CGenAssign::runJob()
+
+bool CGenAssign::generateColumns(int ctrNum, const tagHANDLE* ipRowHd, const double* dpY)
+{
+    int num{0}, m{m_iTskNum}, n{m_iMachNum};
+    double tol{m_dRedCostTol=getRedCostTol()};
+    if (getCurrentNode() != m_iPrcNode) { // duals of different nodes are not comparable
+        m_iPrcNode=getCurrentNode();
+        m_stab.reset();
+    }
+    if (m_iPrcWorkerNum < getWorkerNum()) {
+        try {
+            allocPricingMem(getWorkerNum());
+        }
+        catch(std::bad_alloc&) {
+            throw new CMemoryException("CGenAssign::generateColumns");
         }
-        p+=m; c+=m;
     }
-    return (num)? true: false;
+    m_dpY=m_stab.stabilize(ctrNum,ipRowHd,dpY);
+    do {
+        runJobs(n);
+
+    // columns are added in order of machines, so the result does not depend on the number of workers
+        for (int j{0}; j < n; ++j) {
+            int sz{m_ipColSz[j]};
+            if (sz > 0) {
+                int *ipCol{m_ipCol+j*(m+1)};
+                if (m_dpY != dpY) { // column has been priced out for stabilized duals
+                    double z{-static_cast<double>(m_ipColCost[j])};
+                    for (int i{0}; i < sz; ++i)
+                        z-=dpY[ipCol[i]];
+                    if (z <= tol)
+                        continue;
+                }
+                // memory for `m_ipArray` and `m_dpArray` may have been reallocated by addNewColumn()
+                double *dpVal{m_dpArray};
+                int *ipRow{m_ipArray};
+                memcpy(ipRow,ipCol,sz*sizeof(int));
+                for (int i{0}; i < sz; ++i)
+                    dpVal[i]=1.0;
+                addNewColumn(-1,VAR_BIN,-m_ipColCost[j],0.0,1.0,sz,m_dpArray,m_ipArray,false,false,0,true);
+                ++num;
+            }
+        }
+        if (num) {
+            m_stab.columnsGenerated();
+            return true;
+        }
+    } while ((m_dpY=m_stab.mispricing()));
+    return false;
 } // end of CGenAssign::generateColumns()
 
 void CGenAssign::changeRecord(double objVal,
@@ -1,6 +1,8 @@
 #include <cmip.h>
+#include <jobPool.h>
+#include <dualStab.h>
 
-class CGenAssign: public CMIP
+class CGenAssign: public CMIP, private CJobPool
 {
 	bool m_bOK;
 	int m_iTskNum, m_iMachNum; ///< number of tasks and number of machines
@@ -21,8 +23,24 @@ class CGenAssign: public CMIP
 	 */
 	int m_iCurTsk, m_iCurMach;
 	int m_iQ; ///< max machine capacity
-	double *m_dpKn;
-	int *m_ipKn;
+	/**
+	 * Pricing problems (one for each machine) are solved in parallel by the workers of `CJobPool`;
+	 * each worker uses its own scratch memory.
+	 */
+	int m_iPrcWorkerNum; ///< number of workers for which scratch memory has been allocated
+	double *m_dpKn[MAX_WORKER_NUM]; ///< knapsack memory of each worker
+	int *m_ipKn[MAX_WORKER_NUM]; ///< knapsack memory of each worker
+	double *m_dpPrc[MAX_WORKER_NUM]; ///< profits of knapsack items, one array for each worker
+	int *m_ipPrc[MAX_WORKER_NUM]; ///< tasks, weights and solution of knapsack problem, one array for each worker
+	const double *m_dpY; ///< dual values passed to generateColumns()
+	double m_dRedCostTol; ///< reduced cost tolerance used in current pricing round
+	/**
+	 * if m_ipColSz[j] > 0, column of size m_ipColSz[j] and cost m_ipColCost[j]
+	 * generated for machine j is stored in m_ipCol[j*(m+1)],...,m_ipCol[j*(m+1)+m_ipColSz[j]-1]
+	 */
+	int *m_ipCol, *m_ipColSz, *m_ipColCost;
+	CDualStabilizer m_stab; ///< smooths dual values passed to generateColumns()
+	int m_iPrcNode; ///< node for which columns were generated last time
 
 public:
 	CGenAssign(const char* name, int m, int n, int* l, int* c, int* p);
@@ -31,7 +49,24 @@ public:
 	CMIP* clone(const CMIP *pMip, int thread);
 #endif	
 	virtual ~CGenAssign();
+
+	/**
+	 * \param[in] threadNum number of threads used to solve pricing problems within one call to generateColumns();
+	 * \param[in] deterministic if `true`, each worker always solves the pricing problems of the same machines
+	 * (see `CJobPool::setDeterministic()`).
+	 * \throws CMemoryException lack of memory.
+	 */
+	void setPricingThreadNum(int threadNum, bool deterministic=true);
+
+	/**
+	 * \param[in] alpha dual smoothing parameter, `alpha=0` switches off smoothing;
+	 * \param[in] box if positive, half-width of the box around stability center.
+	 */
+	void setDualStabilization(double alpha, double box=0.0)
+		{m_stab.setAlpha(alpha); m_stab.setBox(box);}
 private:
+	void allocPricingMem(int workerNum);
+	void runJob(int j, int worker); ///< solves pricing problem for machine j
 	void buildMaster(); ///< builds master problem
 	void setGammaEntry(int i, int j, int val);
 	int getGammaEntry(int i, int j);
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <cstring>
+#include <cstdlib>
 #include <except.h>
 #include "genAssign.h"
 
@@ -44,6 +45,8 @@ int main(int argc, char* argv[])
 	readData(argv[1],m,n,ipMachCap,ipCost,ipProcTime);
 	try {
 		CGenAssign prob("genAssign",m,n,ipMachCap,ipCost,ipProcTime);
+		if (argc > 2)
+			prob.setPricingThreadNum(atoi(argv[2]));
 		prob.optimize();
 		prob.printSolution(argv[1]);
 	}
@@ -0,0 +1,31 @@
+#ifndef __CHECKS__H
+#define __CHECKS__H
+
+/**
+ * Each check prints what it has done, and returns `true` on success.
+ * The checks do not solve LPs, except for a few tiny ones in `diving`, so they run quickly;
+ * in multithreaded builds, they are also meant to be run under ThreadSanitizer (`-fsanitize=thread`).
+ */
+
+/// Runs jobs of `CJobPool` with different numbers of workers, in both scheduling modes.
+bool checkJobPool();
+
+/// Encodes and decodes node data by `CNodeCoder`, and spills and reloads records of `CNodeStore`.
+bool checkNodeStore();
+
+/// Calls `CReliabilityBranching::select()` from several threads that share one `CPseudocostTable`.
+bool checkRelBranch();
+
+/**
+ * Runs `CDivingPortfolio` on a small maximization problem with cutoffs set before the first dive.
+ * The check is skipped (and reported as passed) if a one-variable LP shows that the headers do not match the library.
+ */
+bool checkDiving();
+
+/// Finds automorphisms of small graphs by `CSymmetryDetector`, and writes and reads back a `CSymmetryCache`.
+bool checkSymmetry();
+
+/// Preprocesses a small odd system in `CMod2Matrix`, and finds its {0,1/2}-cuts.
+bool checkMod2();
+
+#endif // __CHECKS__H
@@ -0,0 +1,80 @@
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <diving.h>
+#include "checks.h"
+
+/// Dives on the knapsack problem `max 3x_0+2x_1+2x_2: 2x_0+2x_1+2x_2 <= 5, x_j in {0,1}` with optimal value `5`.
+class CKnapsackDiving: public CDivingPortfolio
+{
+public:
+	enum {N=3};
+	static const double c[N], a[N];
+	static const int col[N];
+
+	CKnapsackDiving(const CRowPropagator* pModel): CDivingPortfolio(pModel)
+		{setWorkerNum(2);}
+
+protected:
+	CLP* newLp(int /*w*/)
+	{
+		CLP* pLp=new CLP("knapsack");
+		pLp->preprocOff();
+		pLp->openMatrix(1,N,N);
+		pLp->addCtr(0,0,-CLP::INF,5.0);
+		for (int j=0; j < N; ++j) {
+			pLp->addVar(j,0,c[j],0.0,1.0);
+			pLp->addEntry(a[j],0,j);
+		}
+		pLp->closeMatrix();
+		pLp->setObjSense(true);
+		return pLp;
+	}
+};
+
+const double CKnapsackDiving::c[N]={3.0,2.0,2.0};
+const double CKnapsackDiving::a[N]={2.0,2.0,2.0};
+const int CKnapsackDiving::col[N]={0,1,2};
+
+/**
+ * The function solves `max x: x <= 1` to check that inline accessors of `CLP` compiled
+ * from the headers agree with the library (they do not if the library has been built from other headers).
+ * \return `true` if the solution is reported correctly.
+ */
+static bool checkLpAccessors()
+{
+	CLP lp("probe");
+	lp.preprocOff();
+	lp.openMatrix(1,1,1);
+	lp.addCtr(0,0,-CLP::INF,1.0);
+	lp.addVar(0,0,1.0,0.0,CLP::VAR_INF);
+	lp.addEntry(1.0,0,0);
+	lp.closeMatrix();
+	lp.setObjSense(true);
+	lp.optimize();
+	return lp.isSolution() && fabs(lp.getObjVal()-1.0) < 1.0e-9;
+}
+
+bool checkDiving()
+{
+	if (!checkLpAccessors()) {
+		printf("skipped: the headers do not match the library, so LP solutions cannot be read\n");
+		return true;
+	}
+	CRowPropagator model(1,CKnapsackDiving::N,CKnapsackDiving::N);
+	for (int j=0; j < CKnapsackDiving::N; ++j)
+		model.setVar(j,0.0,1.0,true);
+	model.addRow(-CRowPropagator::INF,5.0,CKnapsackDiving::N,CKnapsackDiving::a,CKnapsackDiving::col);
+	model.init();
+
+	// the cutoff is set before the objective sense is known
+	CKnapsackDiving weak(&model), strong(&model);
+	weak.setCutoff(4.0);
+	bool found=weak.runDives(10);
+	printf("cutoff=4: improved=%d objective=%g\n",found,weak.getObjVal());
+	strong.setCutoff(5.0);
+	bool foundStrong=strong.runDives(10);
+	printf("cutoff=5: improved=%d objective=%g\n",foundStrong,strong.getObjVal());
+	return found && fabs(weak.getObjVal()-5.0) < 1.0e-6 &&
+		!foundStrong && strong.getObjVal() == 5.0;
+}
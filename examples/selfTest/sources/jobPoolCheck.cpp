@@ -0,0 +1,81 @@
+#include <iostream>
+#include <cstdio>
+#include <jobPool.h>
+#include "checks.h"
+
+/// Jobs write results into their own slots; each worker also keeps a trace of the jobs it has run.
+class CPoolCheck: private CJobPool
+{
+	enum {MAX_JOB_NUM=64};
+	unsigned m_uRes[MAX_JOB_NUM]; ///< `m_uRes[j]` is result of job `j`.
+	unsigned m_uTrace[MAX_WORKER_NUM]; ///< `m_uTrace[t]` is hash of the sequence of jobs run by worker `t`.
+public:
+	CPoolCheck(int workerNum, bool deterministic)
+	{
+		setWorkerNum(workerNum);
+		setDeterministic(deterministic);
+		for (int t=0; t < MAX_WORKER_NUM; ++t)
+			m_uTrace[t]=0;
+	}
+
+	using CJobPool::getStealNum;
+
+	/**
+	 * The function runs `rounds` calls to `runJobs()` with different numbers of jobs.
+	 * \return hash of all results taken in the order of job indices.
+	 */
+	unsigned run(int rounds)
+	{
+		unsigned h=2166136261u;
+		for (int r=0; r < rounds; ++r) {
+			int jobNum=1+(r*7) % MAX_JOB_NUM;
+			runJobs(jobNum);
+			for (int j=0; j < jobNum; ++j)
+				h=(h ^ m_uRes[j])*16777619u;
+		}
+		return h;
+	}
+
+	/**
+	 * \return hash of the traces of all workers.
+	 */
+	unsigned getTrace() const
+	{
+		unsigned h=0;
+		for (int t=0; t < MAX_WORKER_NUM; ++t)
+			h=h*31u+m_uTrace[t];
+		return h;
+	}
+
+private:
+	void runJob(int job, int worker)
+	{
+		unsigned v=static_cast<unsigned>(job)+1u;
+		for (int i=0; i < (job % 5)*200; ++i) // jobs of different sizes
+			v=v*1103515245u+12345u;
+		m_uRes[job]=v;
+		m_uTrace[worker]=m_uTrace[worker]*131u+static_cast<unsigned>(job);
+	}
+};
+
+bool checkJobPool()
+{
+	const int rounds=500;
+	bool ok=true;
+	unsigned ref=0;
+	for (int det=0; det < 2; ++det) {
+		for (int w=1; w <= 8; w*=2) {
+			CPoolCheck pool1(w,det != 0), pool2(w,det != 0);
+			unsigned h=pool1.run(rounds);
+			pool2.run(rounds);
+			if (!det && w == 1)
+				ref=h;
+			bool same=(pool1.getTrace() == pool2.getTrace());
+			printf("workers=%d deterministic=%d results=%08x steals=%d same schedule twice: %s\n",
+				w,det,h,pool1.getStealNum(),(same)? "yes": "no");
+			if (h != ref || (det && !same)) // with stealing, schedules may differ
+				ok=false;
+		}
+	}
+	return ok;
+}
@@ -0,0 +1,46 @@
+#include <iostream>
+#include <cstring>
+#include <except.h>
+#include "checks.h"
+
+struct tagCheck {
+	const char* name;
+	bool (*run)();
+};
+
+static const tagCheck checks[] = {
+	{"jobPool",checkJobPool},
+	{"nodeStore",checkNodeStore},
+	{"relBranch",checkRelBranch},
+	{"diving",checkDiving},
+	{"symmetry",checkSymmetry},
+	{"mod2",checkMod2}
+};
+
+int main(int argc, char *argv[])
+{
+	int failNum=0, runNum=0;
+	try {
+		for (const tagCheck &c : checks) {
+			if (argc > 1 && strcmp(argv[1],c.name))
+				continue;
+			++runNum;
+			std::cout << "== " << c.name << std::endl;
+			if (!c.run()) {
+				std::cout << c.name << ": FAILED\n";
+				++failNum;
+			}
+		}
+	}
+	catch(CException* pe) {
+		std::cerr << pe->what() << std::endl;
+		delete pe;
+		return 1;
+	}
+	if (!runNum) {
+		std::cerr << "Unknown check " << argv[1] << "!\n";
+		return 1;
+	}
+	std::cout << runNum-failNum << " of " << runNum << " checks passed\n";
+	return (failNum)? 1: 0;
+}
@@ -0,0 +1,68 @@
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <mod2.h>
+#include "checks.h"
+
+/**
+ * The function builds the parity matrix of the system
+ * ~~~
+ * r0: x0+x1+x3 <= 1    (slack 0)
+ * r1: x1+x2 <= 1       (slack 0)
+ * r2: x0+x2 <= 1       (slack 0)
+ * r3: x3 <= 0          (slack 0.1, unit row)
+ * r4: x1+x2 <= 1       (slack 0.3, duplicate of r1)
+ * r5: x0+x6 <= 1       (slack 1.0, heavy row)
+ * r6: x2+x4+x5 <= 2    (slack 0.05, columns 4 and 5 are duplicates)
+ * ~~~
+ * with column weights `0.5, 0.5, 0.5, 0.4, 0.1, 0.1, 0.3, 0.0`.
+ * Adding `r0`, `r1`, `r2`, dividing by `2`, and rounding down gives `x0+x1+x2+x3 <= 1`
+ * (after the unit row `r3` makes the odd column `x3` even); its violation is `(1-0.1)/2=0.45`.
+ * The next cuts, `r1+r6` and `r2+r6`, have odd columns `x4`, `x5` (merged into one of weight `0.2`) and `x0` or `x1`;
+ * their violation is `(1-0.05-0.2-0.5)/2=0.125`.
+ */
+static void buildOddSystem(CMod2Matrix &A)
+{
+	static const int rowSz[7]={3,2,2,1,2,2,3};
+	static const int col[7][3]={{0,1,3},{1,2},{0,2},{3},{1,2},{0,6},{2,4,5}};
+	static const bool odd[7]={true,true,true,false,true,true,false};
+	static const double slack[7]={0.0,0.0,0.0,0.1,0.3,1.0,0.05};
+	static const double w[8]={0.5,0.5,0.5,0.4,0.1,0.1,0.3,0.0};
+	for (int i=0; i < 7; ++i) {
+		for (int k=0; k < rowSz[i]; ++k)
+			A.setEntry(i,col[i][k]);
+		if (odd[i])
+			A.setRhs(i);
+		A.setRowSlack(i,slack[i]);
+	}
+	for (int j=0; j < 8; ++j)
+		A.setColWeight(j,w[j]);
+}
+
+bool checkMod2()
+{
+	CMod2Matrix A(7,8);
+	buildOddSystem(A);
+	A.preprocess();
+	printf("preprocessing: heavy rows=%d zero columns=%d unit rows=%d duplicate columns=%d duplicate rows=%d\n",
+		A.getHeavyRowNum(),A.getZeroColNum(),A.getUnitRowNum(),A.getDupColNum(),A.getDupRowNum());
+	printf("left: rows=%d columns=%d\n",A.getRowNum(),A.getColNum());
+	bool ok=A.getHeavyRowNum() == 1 && A.getZeroColNum() == 2 && A.getUnitRowNum() == 1 &&
+		A.getDupColNum() == 1 && A.getDupRowNum() == 1 && A.getRowNum() == 4 && A.getColNum() == 5;
+	int rank=A.eliminate();
+	int cutNum=A.findCuts();
+	printf("rank=%d cuts=%d\n",rank,cutNum);
+	if (!cutNum)
+		return false;
+	int row[7], sz=A.getCutRows(0,row);
+	bool in[7]={false,false,false,false,false,false,false};
+	printf("best cut: violation=%g rows:",A.getCutViolation(0));
+	for (int k=0; k < sz; ++k) {
+		printf(" %d",row[k]);
+		in[row[k]]=true;
+	}
+	printf("\n");
+	printf("next cut: violation=%g\n",(cutNum > 1)? A.getCutViolation(1): 0.0);
+	return ok && rank == 4 && fabs(A.getCutViolation(0)-0.45) < 1.0e-9 && sz == 4 &&
+		in[0] && in[1] && in[2] && in[3] && cutNum == 3 && fabs(A.getCutViolation(1)-0.125) < 1.0e-9;
+}
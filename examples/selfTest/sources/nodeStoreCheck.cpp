@@ -0,0 +1,118 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <nodeStore.h>
+#include "checks.h"
+
+/// Linear congruential generator, so that the check does not depend on the C library.
+static unsigned nextRand(unsigned &seed)
+{
+	seed=seed*1103515245u+12345u;
+	return seed >> 8;
+}
+
+/**
+ * The function encodes bounds and words of a "child" that differ from those of a "parent"
+ * in a few positions, and decodes them back.
+ * \return `true` if decoded data coincide with the encoded ones.
+ */
+static bool checkCoder(int n, unsigned seed)
+{
+	enum {N=500};
+	double lo0[N], up0[N], lo[N], up[N], lo1[N], up1[N];
+	unsigned w0[N], w[N], w1[N];
+	CNodeCoder coder;
+	for (int i=0; i < n; ++i) {
+		lo0[i]=lo[i]=0.0;
+		up0[i]=up[i]=static_cast<double>(nextRand(seed) % 100);
+		w0[i]=w[i]=nextRand(seed);
+	}
+	for (int k=n/10; k; --k) { // integral, fractional, and negative bounds
+		int i=nextRand(seed) % n;
+		switch (nextRand(seed) % 3) {
+			case 0: lo[i]=static_cast<double>(nextRand(seed) % 1000000); break;
+			case 1: up[i]=0.5+nextRand(seed) % 7; break;
+			default: lo[i]=-1.0e9; up[i]=-1.0-nextRand(seed) % 3;
+		}
+		w[nextRand(seed) % n]^=1u << (nextRand(seed) % 32);
+	}
+	coder.clear();
+	coder.putInt(-123456);
+	coder.putUInt(0xFFFFFFFFu);
+	coder.putDouble(-0.1);
+	coder.putBoundDiff(n,lo0,up0,lo,up);
+	coder.putWordDiff(n,w0,w);
+
+	int a;
+	unsigned b;
+	double c;
+	const unsigned char* p=coder.getData();
+	p=CNodeCoder::getInt(p,a);
+	p=CNodeCoder::getUInt(p,b);
+	p=CNodeCoder::getDouble(p,c);
+	memcpy(lo1,lo0,n*sizeof(double));
+	memcpy(up1,up0,n*sizeof(double));
+	memcpy(w1,w0,n*sizeof(unsigned));
+	p=CNodeCoder::getBoundDiff(p,lo1,up1);
+	p=CNodeCoder::getWordDiff(p,w1);
+	return a == -123456 && b == 0xFFFFFFFFu && c == -0.1 &&
+		p == coder.getData()+coder.getSize() &&
+		!memcmp(lo,lo1,n*sizeof(double)) && !memcmp(up,up1,n*sizeof(double)) &&
+		!memcmp(w,w1,n*sizeof(unsigned));
+}
+
+/**
+ * The function fills record `id` with bytes that depend on `id` and `ver`.
+ * \return record size.
+ */
+static int fillRecord(int id, int ver, unsigned char* pData)
+{
+	int size=1+(id*37+ver*11) % 300;
+	for (int i=0; i < size; ++i)
+		pData[i]=static_cast<unsigned char>(id*7+ver*13+i);
+	return size;
+}
+
+/**
+ * The function stores records in a store with a small memory limit, so that most
+ * of them are spilled to file, then reads them back in a random order,
+ * removes some of them, and stores new records in freed descriptors.
+ * \return `true` if all records read coincide with the records stored.
+ */
+static bool checkStore()
+{
+	enum {REC_NUM=2000};
+	int hd[REC_NUM], ver[REC_NUM], size;
+	unsigned char buf[512];
+	unsigned seed=7;
+	CNodeStore store(16*1024);
+	bool ok=true;
+	for (int k=0; k < REC_NUM; ++k) {
+		ver[k]=0;
+		hd[k]=store.put(fillRecord(k,0,buf),buf);
+	}
+	for (int r=0; r < 3*REC_NUM; ++r) {
+		int k=nextRand(seed) % REC_NUM;
+		if (nextRand(seed) % 8 == 0) { // replace record
+			store.remove(hd[k]);
+			hd[k]=store.put(fillRecord(k,++ver[k],buf),buf);
+		}
+		const unsigned char* p=store.get(hd[k],size);
+		if (size != fillRecord(k,ver[k],buf) || memcmp(p,buf,size))
+			ok=false;
+	}
+	printf("records=%d memory=%d spilled=%d loaded=%d\n",
+		REC_NUM,static_cast<int>(store.getMemSize()),store.getSpillNum(),store.getLoadNum());
+	return ok && store.getSpillNum() > 0 && store.getLoadNum() > 0 && store.getMemSize() <= 16*1024;
+}
+
+bool checkNodeStore()
+{
+	bool ok=true;
+	for (int n=1; n <= 500; n*=5) {
+		bool res=checkCoder(n,n);
+		printf("coder: n=%d round trip: %s\n",n,(res)? "ok": "wrong");
+		ok=ok && res;
+	}
+	return checkStore() && ok;
+}
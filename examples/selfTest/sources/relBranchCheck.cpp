@@ -0,0 +1,108 @@
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <relBranch.h>
+#include "checks.h"
+
+/// Strong branching without LPs: both pseudocosts of variable `j` are equal to `getCost(j)`.
+class CSyntheticBranching: public CReliabilityBranching
+{
+public:
+	CSyntheticBranching(CPseudocostTable* pTable, int workerNum):
+		CReliabilityBranching(pTable,4,8,20)
+		{setWorkerNum(workerNum);}
+
+	static double getCost(int j)
+		{return 1.0+(j % 13);}
+
+protected:
+	bool evaluate(int j, double val, int /*maxItNum*/, int /*worker*/, double &downGain, double &upGain)
+	{
+		double f=val-floor(val);
+		downGain=f*getCost(j);
+		upGain=(1.0-f)*getCost(j);
+		return true;
+	}
+};
+
+/// Several threads of a "solver" select branching variables at the same time, sharing one pseudocost table.
+class CBranchStress: private CJobPool
+{
+	enum {VAR_NUM=400, CAND_NUM=60, MAX_THREAD_NUM=4};
+	CPseudocostTable m_table;
+	CSyntheticBranching* m_pBr[MAX_THREAD_NUM];
+	int m_iThreadNum;
+	int m_iRounds;
+public:
+	/**
+	 * \param[in] threadNum number of threads calling `select()`;
+	 * \param[in] workerNum number of strong branching workers of each thread.
+	 */
+	CBranchStress(int threadNum, int workerNum): m_table(VAR_NUM), m_iThreadNum(threadNum), m_iRounds(0)
+	{
+		setWorkerNum(threadNum);
+		for (int t=0; t < threadNum; ++t)
+			m_pBr[t]=new CSyntheticBranching(&m_table,workerNum);
+	}
+
+	~CBranchStress()
+	{
+		for (int t=0; t < m_iThreadNum; ++t)
+			delete m_pBr[t];
+	}
+
+	/**
+	 * The function runs `rounds` calls to `select()` in each thread, and then verifies pseudocosts.
+	 * \return `true` if the table has one update per child of every evaluated candidate,
+	 *  and every pseudocost is equal to its exact value.
+	 */
+	bool run(int rounds)
+	{
+		m_iRounds=rounds;
+		runJobs(m_iThreadNum);
+		int updNum=0, evalNum=0, wrongNum=0;
+		for (int j=0; j < VAR_NUM; ++j) {
+			for (int side=0; side < 2; ++side) {
+				if (int num=m_table.getNum(j,side != 0)) {
+					updNum+=num;
+					if (fabs(m_table.get(j,side != 0)-CSyntheticBranching::getCost(j)) > 1.0e-9)
+						++wrongNum;
+				}
+			}
+		}
+		for (int t=0; t < m_iThreadNum; ++t)
+			evalNum+=m_pBr[t]->getStrongBrNum();
+		printf("threads=%d workers=%d evaluated=%d updates=%d wrong pseudocosts=%d\n",
+			m_iThreadNum,m_pBr[0]->getWorkerNum(),evalNum,updNum,wrongNum);
+		return updNum == 2*evalNum && !wrongNum;
+	}
+
+private:
+	void runJob(int t, int /*worker*/)
+	{
+		int var[CAND_NUM];
+		double val[CAND_NUM], score;
+		unsigned seed=1u+static_cast<unsigned>(t);
+		for (int r=0; r < m_iRounds; ++r) {
+			for (int i=0; i < CAND_NUM; ++i) {
+				seed=seed*1103515245u+12345u;
+				var[i]=(seed >> 8) % VAR_NUM;
+				val[i]=(seed >> 20)+0.05+((seed >> 4) & 0xFF)/300.0;
+			}
+			m_pBr[t]->select(CAND_NUM,var,val,score);
+		}
+	}
+};
+
+bool checkRelBranch()
+{
+	bool ok=true;
+	for (int threadNum=1; threadNum <= 4; threadNum*=2) {
+		for (int workerNum=1; workerNum <= 4; workerNum*=2) {
+			CBranchStress stress(threadNum,workerNum);
+			if (!stress.run(300))
+				ok=false;
+		}
+	}
+	return ok;
+}
@@ -0,0 +1,143 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <symmetry.h>
+#include "checks.h"
+
+/**
+ * The function computes the order of the group generated by the generators found by `det`,
+ * by multiplying elements found so far by generators until no new element appears.
+ * \param[in] n number of vertices, `n <= MAX_N`.
+ * \return group order, or `-1` if the group has more than `MAX_ORDER` elements.
+ */
+static int groupOrder(const CSymmetryDetector &det, int n)
+{
+	enum {MAX_N=16, MAX_ORDER=256};
+	static int elem[MAX_ORDER][MAX_N];
+	int gen[MAX_N], pi[MAX_N], num=1;
+	for (int v=0; v < n; ++v)
+		elem[0][v]=v;
+	for (int i=0; i < num; ++i) {
+		for (int k=0; k < det.getGenNum(); ++k) {
+			det.getGenerator(k,gen);
+			for (int v=0; v < n; ++v)
+				pi[v]=gen[elem[i][v]];
+			int e=0;
+			while (e < num && memcmp(elem[e],pi,n*sizeof(int)))
+				++e;
+			if (e == num) {
+				if (num == MAX_ORDER)
+					return -1;
+				memcpy(elem[num++],pi,n*sizeof(int));
+			}
+		}
+	}
+	return num;
+}
+
+/**
+ * The function builds the Petersen graph: outer cycle `0,...,4`, inner pentagram `5,...,9`, and spokes `(i,i+5)`.
+ */
+static void buildPetersen(CSymmetryDetector &det)
+{
+	for (int i=0; i < 5; ++i) {
+		det.addEdge(i,(i+1) % 5,0);
+		det.addEdge(5+i,5+(i+2) % 5,0);
+		det.addEdge(i,5+i,0);
+	}
+}
+
+/**
+ * \return `true` if both detectors have found the same generators.
+ */
+static bool sameGenerators(const CSymmetryDetector &a, const CSymmetryDetector &b)
+{
+	if (a.getGenNum() != b.getGenNum())
+		return false;
+	for (int k=0; k < a.getGenNum(); ++k) {
+		const int *ipA, *ipB;
+		int sz=a.getGenerator(k,ipA);
+		if (b.getGenerator(k,ipB) != sz || memcmp(ipA,ipB,(sz<<1)*sizeof(int)))
+			return false;
+	}
+	return true;
+}
+
+/// The Petersen graph has 120 automorphisms.
+static bool checkPetersen()
+{
+	CSymmetryDetector det(10,15);
+	buildPetersen(det);
+	det.search();
+	int order=groupOrder(det,10);
+	printf("Petersen graph: generators=%d group order=%d\n",det.getGenNum(),order);
+	return det.isComplete() && order == 120;
+}
+
+/// Two paths `0-1-2` and `3-4-5` with rigid coloring: the only automorphism swaps them.
+static bool checkComponents()
+{
+	CSymmetryDetector det(6,4);
+	for (int v=0; v < 6; ++v)
+		det.setColor(v,v % 3);
+	det.addEdge(0,1,0);
+	det.addEdge(1,2,0);
+	det.addEdge(3,4,0);
+	det.addEdge(4,5,0);
+	det.search();
+	int pi[6];
+	bool swap=false;
+	for (int k=0; k < det.getGenNum(); ++k) {
+		det.getGenerator(k,pi);
+		if (pi[0] == 3 && pi[1] == 4 && pi[2] == 5 && pi[3] == 0 && pi[4] == 1 && pi[5] == 2)
+			swap=true;
+	}
+	printf("two components: generators=%d swap found: %s\n",det.getGenNum(),(swap)? "yes": "no");
+	return swap && groupOrder(det,6) == 2;
+}
+
+/**
+ * The function stores generators of the Petersen graph in a cache, writes the cache to a file,
+ * reads it into another cache, and searches the same graph with that cache;
+ * then it corrupts a move index in the file and checks that reading it fails.
+ */
+static bool checkCache()
+{
+	const char* fileName="symmetryCheck.cache";
+	CSymmetryCache cache, copy, bad;
+	CSymmetryDetector det(10,15), cached(10,15);
+	buildPetersen(det);
+	buildPetersen(cached);
+	det.search(&cache);
+	cache.write(fileName);
+	bool ok=copy.read(fileName) && copy.getSize() == 1;
+	cached.search(&copy);
+	ok=ok && cached.isCached() && sameGenerators(det,cached);
+	printf("cache: entries read=%d cached=%d same generators: %s\n",
+		copy.getSize(),cached.isCached(),(sameGenerators(det,cached))? "yes": "no");
+
+	bool rejected=false;
+	if (FILE* pFile=fopen(fileName,"r+b")) {
+		int vert=10;
+		fseek(pFile,-static_cast<long>(sizeof(int)),SEEK_END); // last move index
+		fwrite(&vert,sizeof(int),1,pFile);
+		fclose(pFile);
+		try {
+			bad.read(fileName);
+		}
+		catch(CException* pe) {
+			rejected=true;
+			delete pe;
+		}
+	}
+	remove(fileName);
+	printf("cache: corrupted file rejected: %s\n",(rejected)? "yes": "no");
+	return ok && rejected;
+}
+
+bool checkSymmetry()
+{
+	bool ok=checkPetersen();
+	ok=checkComponents() && ok;
+	return checkCache() && ok;
+}
@@ -10,6 +10,8 @@ int main(int argc, char* argv[])
 	}
 	try {
 		CTsp gr(argv[1]);
+		if (argc > 2) // checkpoint log
+			gr.setCheckpoint(argv[2]);
 		gr.solve();
 		gr.printSolution(argv[1]);
 	}
@@ -27,16 +27,18 @@
 
 CTsp::CTsp(const char *name): CMIP("tsp")
 {
-	int k;
 	m_pTspPool=0;
+	m_pLog=0;
 	m_pNet=0;
 	m_dpCoordX=0;
 	m_ipNextOnTour=0;
 	readPoints(name);
 	
-	k=m_iPointNum*MAX_DEGREE;
-	m_pNet= new CFlowNet<double>(m_iPointNum+k,2*k,CFlowNet<double>::m_iUpCapMsk);
-	m_pNet->COMB_AND_CUT_getMem();
+	allocNet();
+#ifndef __ONE_THREAD_
+	if (getThreadNum() > CTspPool::MAX_THREAD_NUM) // the pool marks cuts by bits of thread indices
+		setThreadNum(CTspPool::MAX_THREAD_NUM);
+#endif
 	m_pTspPool = new CTspPool(m_iPointNum);
 	setMIP();
 } // end of CTsp::CTsp
@@ -44,6 +46,8 @@ CTsp::CTsp(const char *name): CMIP("tsp")
 #ifndef __ONE_THREAD_
 CTsp::CTsp(const CTsp &other, int thread): CMIP(other,thread)
 {
+	if (thread >= CTspPool::MAX_THREAD_NUM)
+		throw new CDataException("CTsp::CTsp: the cut pool supports at most CTspPool::MAX_THREAD_NUM threads");
 	m_enType=other.m_enType;
 	m_iPointNum=other.m_iPointNum;
 	m_dpCoordX=other.m_dpCoordX;
@@ -51,9 +55,8 @@ CTsp::CTsp(const CTsp &other, int thread): CMIP(other,thread)
 	m_dMaxDist=other.m_dMaxDist;
 	m_ipNextOnTour=other.m_ipNextOnTour;
 	m_pTspPool=other.m_pTspPool;
-	int u=m_iPointNum*MAX_DEGREE;
-	m_pNet= new CFlowNet<double>(m_iPointNum+u,2*u,CFlowNet<double>::m_iUpCapMsk);
-	m_pNet->COMB_AND_CUT_getMem();
+	m_pLog=other.m_pLog;
+	m_pNet=0; // allocated when the clone first builds a support graph
 } // end of CTsp::CTsp(const CTsp &other, int thread)
 
 CMIP* CTsp::clone(const CMIP *pMip, int thread)
@@ -73,6 +76,8 @@ CTsp::~CTsp()
 		delete[] m_ipNextOnTour;
 	if (m_pTspPool)
 		delete m_pTspPool;
+	if (m_pLog)
+		delete m_pLog;
 #ifndef __ONE_THREAD_
 	}
 #endif
@@ -80,6 +85,13 @@ CTsp::~CTsp()
 		delete m_pNet;
 } // end of CTsp::~CTsp()
 
+void CTsp::allocNet()
+{
+	int k=m_iPointNum*MAX_DEGREE;
+	m_pNet= new CFlowNet<double>(m_iPointNum+k,2*k,CFlowNet<double>::m_iUpCapMsk);
+	m_pNet->COMB_AND_CUT_getMem();
+} // end of CTsp::allocNet()
+
 double CTsp::dist(int i, int j)
 {
 	double d,dx,dy;
@@ -320,25 +332,23 @@ int CTsp::separateFromPool(int n, const double* dpX, const int* ipColHd,
 	cutNum=0;
 	thread=m_iThread;
 	m=m_iM;
-	m_pTspPool->wrLockPool();
 	for (int i=m_iM0; i < m; ++i) {
 		if (m_ipRowHd[i] >= 0)
 			m_pTspPool->markCtr(m_ipRowHd[i],thread);
 	}
-	m_pTspPool->wrUnlockPool();
+	// getNextCut() locks the cut it returns
 	for (int hd=0; sz= m_pTspPool->getNextCut(thread,hd,n,dpX,ipColHd,m_ipArray,m_dpArray,rhs); ++hd) {
 		++cutNum;
-		if (!bGenFlag)
+		if (!bGenFlag) {
+			m_pTspPool->unlockCtr(hd);
 			break;
+		}
 		safeAddCut(hd,CTR_INT,-INF,rhs,sz,m_dpArray,m_ipArray);
-		m_pTspPool->lockCtr(hd);
 	}
-	m_pTspPool->wrLockPool();
 	for (int i=m_iM0; i < m; ++i) {
 		if (m_ipRowHd[i] >= 0)
 			m_pTspPool->unmarkCtr(m_ipRowHd[i],thread);
 	}
-	m_pTspPool->wrUnlockPool();
 	return cutNum;
 } // end of CTsp::separateFromPool
 
@@ -346,6 +356,8 @@ void CTsp::buildSupportGraph(int n, const double* dpX, const tagHANDLE* ipColHd)
 {
 	double tol=getIntTol();
 	int hd;
+	if (!m_pNet)
+		allocNet();
 	m_pNet->reset(m_iPointNum);
 	for (int e=0; e < n; ++e)
 		if (dpX[e] > tol) {
@@ -399,7 +411,7 @@ int CTsp::cutSeparate(int varNum, const double* dpX, const tagHANDLE* ipColHd, b
 					m_ipArray[k++]=e;
 				}
 			}
-			hd=m_pTspPool->addCut(b,ipCut);
+			hd=addPoolCut(b,ipCut);
 			safeAddCut(hd,CTR_INT,-INF,b,k,m_dpArray,m_ipArray);
 		}
 	}
@@ -443,11 +455,34 @@ void CTsp::addCombCut(int b, int* ipComb,
 			int n, const double* dpX, const tagHANDLE* ipColHd)
 {
 	double b0;
-	int hd=m_pTspPool->addCut(b,ipComb);
+	int hd=addPoolCut(b,ipComb);
 	int sz=m_pTspPool->buildRow(hd,n,ipColHd,m_dpArray,m_ipArray,b0);
 	safeAddCut(hd,0,-INF,b0,sz,m_dpArray,m_ipArray);
 } // end of CTsp::addCombCut()
 
+int CTsp::addPoolCut(int b, int* ipCut)
+{
+	int hd=m_pTspPool->addCut(m_iThread,b,ipCut);
+	if (m_pLog) {
+		int k=0;
+		m_coder.clear();
+		m_coder.putUInt(b);
+		for (int v=0; v < m_iPointNum; ++v)
+			if (ipCut[v])
+				++k;
+		m_coder.putUInt(k);
+		for (int prev=0, v=0; v < m_iPointNum; ++v) {
+			if (ipCut[v]) {
+				m_coder.putUInt(v-prev);
+				m_coder.putUInt(ipCut[v]);
+				prev=v;
+			}
+		}
+		m_pLog->append(REC_CUT,m_coder.getSize(),m_coder.getData());
+	}
+	return hd;
+} // end of CTsp::addPoolCut()
+
 bool CTsp::generateColumns(int m, const tagHANDLE* ipRowHd, const double* dpY)
 {
 	double redCost,cost, bestRedCost,cq;
@@ -481,6 +516,8 @@ bool CTsp::generateColumns(int m, const tagHANDLE* ipRowHd, const double* dpY)
 
 void CTsp::buildSupportGraph()
 {
+	if (!m_pNet)
+		allocNet();
 	m_pNet->reset(m_iPointNum);
 	int hd,n=getVarNum();
 	for (int i=0; i < n; ++i) {
@@ -512,14 +549,113 @@ void CTsp::changeRecord(double dObjVal,
 	}
 	for (m_ipNextOnTour[w=0]=v=ipFirst[0]; v; v=m_ipNextOnTour[w=v])
 		m_ipNextOnTour[v]=(ipFirst[v] == w)? ipSecond[v]: ipFirst[v];
+	if (m_pLog)
+		m_pLog->appendIncumbent(dObjVal,n,dpX,ipHd);
 } // end of CTsp::changeRecord()
 
+void CTsp::setCheckpoint(const char* fileName)
+{
+	int type, size, k, n=m_iPointNum;
+	const unsigned char* pData;
+	if (!(m_pLog = new(std::nothrow) CCheckpointLog()))
+		throw new CMemoryException("CTsp::setCheckpoint");
+	if (m_pLog->openForReading(fileName)) {
+	// cuts are copied to a compacted log at once, and only the best tour is written there at the end
+		int *ipCut=new(std::nothrow) int[2*n];
+		double *dpX=new(std::nothrow) double[n];
+		char *copyName=new(std::nothrow) char[strlen(fileName)+5];
+		unsigned char *cpBest=0;
+		if (!ipCut || !dpX || !copyName) {
+			if (ipCut)
+				delete[] ipCut;
+			if (dpX)
+				delete[] dpX;
+			if (copyName)
+				delete[] copyName;
+			throw new CMemoryException("CTsp::setCheckpoint");
+		}
+		int cutNum=0, recNum=0, keptNum=0;
+		try {
+			strcpy(copyName,fileName);
+			strcat(copyName,".new");
+			CCheckpointLog copy;
+			copy.open(copyName,true);
+			int *ipHd=ipCut+n, bestSize=0;
+			while (m_pLog->next(type,size,pData)) {
+				++recNum;
+				if (type == CCheckpointLog::REC_INCUMBENT) {
+					double objVal, length=0.0;
+					CCheckpointLog::getIncumbent(pData,objVal,k,0,0);
+					if (k != n)
+						continue; // not a tour
+					CCheckpointLog::getIncumbent(pData,objVal,k,dpX,ipHd);
+					for (int e=0; e < k; ++e)
+						length+=dist(ipHd[e] >> 16,ipHd[e] & 0x0000FFFF);
+					if (length < m_dTourLength) {
+						changeRecord(objVal,k,dpX,ipHd);
+						m_dTourLength=length;
+						if (cpBest)
+							delete[] cpBest;
+						if (!(cpBest = new(std::nothrow) unsigned char[size]))
+							throw new CMemoryException("CTsp::setCheckpoint");
+						memcpy(cpBest,pData,bestSize=size);
+					}
+				}
+				else if (type == REC_CUT) {
+					copy.append(REC_CUT,size,pData);
+					unsigned b, u, x;
+					pData=CNodeCoder::getUInt(pData,b);
+					pData=CNodeCoder::getUInt(pData,u);
+					memset(ipCut,0,n*sizeof(int));
+					for (int v=0; u; --u) {
+						pData=CNodeCoder::getUInt(pData,x);
+						v+=x;
+						pData=CNodeCoder::getUInt(pData,x);
+						ipCut[v]=static_cast<int>(x);
+					}
+					m_pTspPool->unlockCtr(m_pTspPool->addCut(0,static_cast<int>(b),ipCut));
+					++cutNum;
+				}
+			}
+			if (cpBest)
+				copy.append(CCheckpointLog::REC_INCUMBENT,bestSize,cpBest);
+			keptNum=copy.getRecNum();
+			copy.close();
+			m_pLog->close();
+			CCheckpointLog::replace(fileName,copyName);
+		}
+		catch(CException* pe) {
+			if (cpBest)
+				delete[] cpBest;
+			delete[] copyName;
+			delete[] dpX;
+			delete[] ipCut;
+			throw pe;
+		}
+		if (cpBest)
+			delete[] cpBest;
+		delete[] copyName;
+		delete[] dpX;
+		delete[] ipCut;
+		char str[160];
+		sprintf(str,"Checkpoint: %d records read, tour length = %lf, %d cuts restored, %d records kept",
+			recNum,m_dTourLength,cutNum,keptNum);
+		infoMessage(str);
+	}
+	m_pLog->open(fileName);
+} // end of CTsp::setCheckpoint()
+
 void CTsp::solve()
 {
 	setAutoCutPattern(-1,-1);
 	changeObjBound(m_iPointNum*m_dMaxDist-m_dTourLength);
 	optimize();
 	m_dTourLength=m_dMaxDist*m_iPointNum-getObjVal();
+	char str[128];
+	sprintf(str,"Cut pool: %d cuts, %d lock contentions, %d retries, %d reclaim waits",
+		m_pTspPool->getCutNum(),m_pTspPool->getContentionNum(),
+		m_pTspPool->getRetryNum(),m_pTspPool->getReclaimWaitNum());
+	infoMessage(str);
 } // end of CTsp::solve()
 
 void CTsp::printSolution(const char* fileName)
@@ -4,6 +4,7 @@
 #define __TSP__H
 
 #include <cmip.h>
+#include <ckptLog.h>
 #include "flowNet.h"
 
 class CTspPool;
@@ -20,6 +21,10 @@ class CTsp: public CMIP
 	double m_dTourLength; ///< length of best tour found so far
 	int *m_ipNextOnTour; ///< best tour
 	CTspPool *m_pTspPool; ///< pool for storing cuts
+	CCheckpointLog *m_pLog; ///< if not `0`, cuts and tours are written to this log
+	CNodeCoder m_coder; ///< encodes cuts written to `m_pLog`
+
+	enum {REC_CUT=CCheckpointLog::REC_USER}; ///< type of log records storing cuts
 
 public:
 	CTsp(const char *name); ///< base constructor
@@ -30,7 +35,18 @@ public:
 		
 	virtual ~CTsp(); ///< destructor
 
+	/**
+	 * The function restores the best tour and the cut pool from a checkpoint log written by a previous run
+	 * (if the log exists), and then opens the log to append new cuts and tours.
+	 * An existing log is compacted: only its cuts and the best tour are kept.
+	 * \param[in] fileName name of log file.
+	 * \throws CMemoryException lack of memory;
+	 * \throws CFileException if the log cannot be opened.
+	 */
+	void setCheckpoint(const char* fileName);
+
 private:
+	void allocNet(); ///< allocates memory for `m_pNet`
 	double dist(int i, int j); ///< computes the distance between points `i` and `j`
 
 	void allocMemForCoords();
@@ -61,6 +77,7 @@ private:
 	int BLOSSOM_separate(int n, const double* dpX, const tagHANDLE* ipColHd);
 	void addCombCut(int b, int* ipComb,
 		int n, const double* dpX, const tagHANDLE* ipColHd);
+	int addPoolCut(int b, int* ipCut); ///< adds cut to the pool and writes it to the log
 
 	bool generateColumns(int m, const tagHANDLE* ipRowHd, const double* dpY);
 	void buildSupportGraph();
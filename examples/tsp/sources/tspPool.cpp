@@ -1,62 +1,62 @@
 #include <iostream>
 #include <cstring>
 #include <new>
+#include <thread>
 #include <except.h>
 #include "tspPool.h"
 
-CTspPool::CTspPool(int ptNum): m_iPointNum(ptNum) 
+CTspPool::CTspPool(int ptNum): m_iPointNum(ptNum)
 {
-	_MUTEX_ASSIGN_P(m_pMemMutex,0)
-	m_iMaxPoolSize=10*ptNum;
-	m_iPoolSize=0;
-	m_iFirstFreeInPool=-1;
-	allocMem();
-	_RWLOCK_INIT(m_rwLock)
-}
-
-void CTspPool::allocMem()
-{
-	m_pEntry = new(std::nothrow) tagPoolEntry[m_iMaxPoolSize];
-	m_ipBuf=new(std::nothrow) int[m_iMaxPoolSize*m_iPointNum];
-	if (!m_pEntry || !m_ipBuf ) {
-		throw new CMemoryException("CTspPool::allocMem");
+	for (int s=0; s < SHARD_NUM; ++s) {
+		tagShard &shard=m_Shard[s];
+		shard.size=0;
+		shard.segNum=0;
+		shard.freeHd=shard.retiredHd=-1;
+		shard.retiredEpoch=0;
+		shard.waitNum=0;
+		shard.contentionNum=0;
+		shard.reclaimWaitNum=0;
+#ifndef __ONE_THREAD_
+		_MUTEX_INIT(shard.mutex)
+#endif
 	}
-} // end of CTspPool::allocMem
+	for (int t=0; t < MAX_THREAD_NUM; ++t)
+		m_Epoch[t].val=0;
+	m_uEpoch=1;
+	m_iRetryNum=0;
+	allocSegment(m_Shard[0]); // its buffer is also used by CTsp::approximate()
+} // end of CTspPool::CTspPool
 
 CTspPool::~CTspPool()
 {
-	if (m_pEntry)
-		delete[] m_pEntry;
-	if (m_ipBuf)
-		delete[] m_ipBuf;
-}
-	
-void CTspPool::reallocMem()
-{
-	int *ipBuf;
-	tagPoolEntry *pEntry=0;
-	int sz=m_iMaxPoolSize+m_iMaxPoolSize/3;
-	_MUTEX_SAFE_LOCK(m_pMemMutex)
-	pEntry=new(std::nothrow) tagPoolEntry[sz];
-	ipBuf=new(std::nothrow) int[sz*m_iPointNum];
- 	_MUTEX_SAFE_UNLOCK(m_pMemMutex)
-	if (!ipBuf || !pEntry) {
-		throw new CMemoryException("CTspPool::reallocMem");
+	for (int s=0; s < SHARD_NUM; ++s) {
+		tagShard &shard=m_Shard[s];
+		for (int k=0; k < shard.segNum; ++k) {
+			delete[] shard.pEntry[k];
+			delete[] shard.ipBuf[k];
+		}
+#ifndef __ONE_THREAD_
+		_MUTEX_DESTROY(shard.mutex)
+#endif
 	}
-	memcpy(ipBuf,m_ipBuf,m_iMaxPoolSize*m_iPointNum*sizeof(int));
-	for (int i=0; i < m_iMaxPoolSize; ++i) {
-		pEntry[i].state=m_pEntry[i].state;
-		pEntry[i].ct=m_pEntry[i].ct;
-		pEntry[i].b=m_pEntry[i].b;
+} // end of CTspPool::~CTspPool
+
+void CTspPool::allocSegment(tagShard &shard)
+{
+	if (shard.segNum >= MAX_SEG_NUM)
+		throw new CMemoryException("CTspPool::allocSegment");
+	tagPoolEntry *pEntry=new(std::nothrow) tagPoolEntry[SEG_SIZE];
+	int *ipBuf=new(std::nothrow) int[SEG_SIZE*m_iPointNum];
+	if (!pEntry || !ipBuf) {
+		if (pEntry)
+			delete[] pEntry;
+		if (ipBuf)
+			delete[] ipBuf;
+		throw new CMemoryException("CTspPool::allocSegment");
 	}
-	_MUTEX_SAFE_LOCK(m_pMemMutex)
-	delete m_pEntry;
-	delete m_ipBuf;
- 	_MUTEX_SAFE_UNLOCK(m_pMemMutex)
-	m_ipBuf=ipBuf;
-	m_pEntry=pEntry;
-	m_iMaxPoolSize=sz;
-} // end of CTspPool::reallocMem
+	shard.pEntry[shard.segNum]=pEntry;
+	shard.ipBuf[shard.segNum++]=ipBuf;
+} // end of CTspPool::allocSegment
 
 ////////// P O O L  handling
 
@@ -74,49 +74,111 @@ int CTspPool::getCoefficient(int yv, int yw)
 	return l;
 } // end of Ctsp::getCoefficient
 
-int CTspPool::addCut(int b, int *ipComb)
+bool CTspPool::isSafeToReuse(unsigned epoch) const
+{
+	for (int t=0; t < MAX_THREAD_NUM; ++t) {
+		unsigned e=m_Epoch[t].val;
+		if (e && e <= epoch)
+			return false; // thread t may still be reading entries freed at `epoch`
+	}
+	return true;
+} // end of CTspPool::isSafeToReuse
+
+void CTspPool::freeNotUsedCuts(tagShard &shard)
 {
-	int hd;
-	_RWLOCK_WRLOCK(&m_rwLock)
-	if (m_iFirstFreeInPool < 0) {
-		if (m_iPoolSize >= m_iMaxPoolSize) {
-			freeNotUsedCuts();
-			if (m_iFirstFreeInPool < 0)
-				reallocMem();
+	int num=0, size=shard.size;
+	for (int i=0; i < size; ++i) {
+		tagPoolEntry &entry=shard.pEntry[i >> SEG_BITS][i & (SEG_SIZE-1)];
+		int ct=0;
+		if (!entry.state && entry.ct.compare_exchange_strong(ct,FREE_CUT)) {
+			entry.next=shard.retiredHd;
+			shard.retiredHd=i;
+			++num;
 		}
 	}
-	if (m_iFirstFreeInPool < 0)
-		hd=m_iPoolSize++;		
-	else  {
-		hd=m_iFirstFreeInPool;
-		m_iFirstFreeInPool=m_pEntry[hd].ct;
+	if (num) // readers that entered getNextCut() after this point do not see freed entries
+		shard.retiredEpoch=m_uEpoch++;
+} // end of CTspPool::freeNotUsedCuts
+
+int CTspPool::getFreeEntry(tagShard &shard)
+{
+	if (shard.freeHd < 0 && shard.retiredHd >= 0 && isSafeToReuse(shard.retiredEpoch)) {
+		shard.freeHd=shard.retiredHd;
+		shard.retiredHd=-1;
 	}
-	m_pEntry[hd].state=0;
-	m_pEntry[hd].ct=1;
-	m_pEntry[hd].b=b;
-	memcpy(m_ipBuf+(hd*m_iPointNum),ipComb,m_iPointNum*sizeof(int));
-	_RWLOCK_UNLOCK_WRLOCK(&m_rwLock)
-	return hd;
-} // end of CTspPool::addCut
+	if (shard.freeHd < 0 && shard.size == shard.segNum*SEG_SIZE) {
+		freeNotUsedCuts(shard);
+		if (shard.retiredHd >= 0 && !isSafeToReuse(shard.retiredEpoch)) {
+			++shard.reclaimWaitNum;
+			if (shard.segNum < MAX_SEG_NUM) {
+				allocSegment(shard);
+				return shard.size;
+			}
+			return -1; // the caller releases the mutex and retries; readers leave getNextCut() quickly
+		}
+		if (shard.retiredHd < 0)
+			allocSegment(shard);
+		else {
+			shard.freeHd=shard.retiredHd;
+			shard.retiredHd=-1;
+		}
+	}
+	if (shard.freeHd < 0)
+		return shard.size;
+	int i=shard.freeHd;
+	shard.freeHd=shard.pEntry[i >> SEG_BITS][i & (SEG_SIZE-1)].next;
+	return i;
+} // end of CTspPool::getFreeEntry
 
-void CTspPool::freeNotUsedCuts()
+int CTspPool::addCut(int thread, int b, int *ipComb)
 {
-	tagPoolEntry *pEntry=m_pEntry;
-	for (int i=0; i < m_iMaxPoolSize; ++i, ++pEntry) {
-		if (!pEntry->state && !pEntry->ct) {
-			pEntry->state=-1;
-			pEntry->ct=m_iFirstFreeInPool;
-			m_iFirstFreeInPool=i;
+	int i, s=thread & (SHARD_NUM-1);
+	tagShard &shard=m_Shard[s];
+	if (shard.waitNum++ > 0)
+		++shard.contentionNum;
+#ifndef __ONE_THREAD_
+	_MUTEX* pMutex=&shard.mutex;
+#endif
+	for (;;) {
+#ifndef __ONE_THREAD_
+		_MUTEX_LOCK(pMutex)
+#endif
+		try {
+			i=getFreeEntry(shard);
+		}
+		catch(CMemoryException* pe) {
+#ifndef __ONE_THREAD_
+			_MUTEX_UNLOCK(pMutex)
+#endif
+			--shard.waitNum;
+			throw pe;
 		}
+		if (i >= 0)
+			break;
+#ifndef __ONE_THREAD_
+		_MUTEX_UNLOCK(pMutex)
+		std::this_thread::yield(); // let readers leave getNextCut(), and other writers of this shard proceed
+#endif
 	}
-} // end of CTspPool::freeNotUsedCuts
+	tagPoolEntry &entry=shard.pEntry[i >> SEG_BITS][i & (SEG_SIZE-1)];
+	memcpy(shard.ipBuf[i >> SEG_BITS]+(i & (SEG_SIZE-1))*m_iPointNum,ipComb,m_iPointNum*sizeof(int));
+	entry.b=b;
+	entry.state=0;
+	entry.ct.store(1,std::memory_order_release); // a reused entry becomes visible to readers
+	if (i == shard.size)
+		shard.size.store(i+1,std::memory_order_release); // a new entry becomes visible to readers
+#ifndef __ONE_THREAD_
+	_MUTEX_UNLOCK(pMutex)
+#endif
+	--shard.waitNum;
+	return (i << SHARD_BITS) | s;
+} // end of CTspPool::addCut
 
 int CTspPool::buildRow(int hd, int n, const int *ipColHd,
 				   double* dpVal, int* ipCol, double &rhs)
 {
 	int l,colHd, sz, *data;
-	_RWLOCK_RDLOCK(&m_rwLock)
-	data=m_ipBuf+(hd*m_iPointNum);
+	data=getCutData(hd);
 	for (int i=sz=0; i < n; ++i) {
 		colHd=ipColHd[i];
 		if  (l=getCoefficient(data[colHd >> 16],data[colHd & 0x0000FFFF])) {
@@ -124,8 +186,7 @@ int CTspPool::buildRow(int hd, int n, const int *ipColHd,
 			ipCol[sz++]=i;
 		}
 	}
-	rhs=m_pEntry[hd].b;
-	_RWLOCK_UNLOCK_RDLOCK(&m_rwLock)
+	rhs=getEntry(hd).b;
 	return sz;
 } // end of CTspPool::buildRow
 
@@ -135,17 +196,15 @@ int CTspPool::buildColumn(int v, int w, int m, const int* ipRowHd,
 	int l,*data,sz=2;
 	dpVal[0]=dpVal[1]=1.0;
 	ipRow[0]=v; ipRow[1]=w;
-	_RWLOCK_RDLOCK(&m_rwLock)
 	for (int i=m_iPointNum; i < m; ++i) {
 		if ((l=ipRowHd[i]) >= 0) {
-			data=m_ipBuf+(l*m_iPointNum);
+			data=getCutData(l);
 			if (l=getCoefficient(data[v],data[w])) {
 				dpVal[sz]=l;
 				ipRow[sz++]=i;
 			}
 		}
 	}	// for (register int i=0;
-	_RWLOCK_UNLOCK_RDLOCK(&m_rwLock)
 	return sz;
 } // end of CTsp::buildColumn
 
@@ -154,31 +213,71 @@ int CTspPool::getNextCut(int thread, int &hd,
 		int *ipCol, double *dpVal, double &rhs)
 {
 	double w;
-	int sz, colHd, a, *data;
-	tagPoolEntry *pEntry;
+	int sz, ct, colHd, a, maxSize, size[SHARD_NUM], *data;
+	std::atomic<unsigned> &epoch=m_Epoch[thread].val;
+	unsigned ep;
+	do { // announce the epoch in which entries are being read
+		epoch=ep=m_uEpoch;
+	} while (ep != m_uEpoch);
+	for (int s=maxSize=0; s < SHARD_NUM; ++s)
+		if (maxSize < (size[s]=m_Shard[s].size.load(std::memory_order_acquire)))
+			maxSize=size[s];
 	sz=0;
-	_RWLOCK_RDLOCK(&m_rwLock)
-	data=m_ipBuf+(hd*m_iPointNum);
-	pEntry=m_pEntry+hd;
-	for (; hd < m_iPoolSize; ++hd, ++pEntry) {
-		if (pEntry->state >= 0 && !(pEntry->state & (1 << thread))) {
-			w=pEntry->b;
-			for (int e=0; e < n; ++e) {
-				colHd=ipColHd[e];
-				a=getCoefficient(data[colHd >> 16],data[colHd & 0x0000FFFF]);
-				if (a > 0) {
-					w-=dpX[e]*(dpVal[sz]=a);
-					ipCol[sz++]=e;
-				}
+	for (int hdNum=maxSize << SHARD_BITS; hd < hdNum; ++hd) {
+		if ((hd >> SHARD_BITS) >= size[hd & (SHARD_NUM-1)])
+			continue;
+		tagPoolEntry &entry=getEntry(hd);
+		if ((ct=entry.ct.load(std::memory_order_acquire)) == FREE_CUT || (entry.state & (1 << thread)))
+			continue;
+		w=entry.b;
+		data=getCutData(hd);
+		for (int e=0; e < n; ++e) {
+			colHd=ipColHd[e];
+			a=getCoefficient(data[colHd >> 16],data[colHd & 0x0000FFFF]);
+			if (a > 0) {
+				w-=dpX[e]*(dpVal[sz]=a);
+				ipCol[sz++]=e;
 			}
-			if (w < -0.001) {
-				rhs=pEntry->b;
+		}
+		if (w < -0.001) {
+		// the cut is locked for the caller unless it has been freed in the meantime
+			while (ct != FREE_CUT && !entry.ct.compare_exchange_weak(ct,ct+1));
+			if (ct != FREE_CUT) {
+				rhs=entry.b;
 				break;
 			}
-			sz=0;
+			++m_iRetryNum;
 		}
-		data+=m_iPointNum;
+		sz=0;
 	}
-	_RWLOCK_UNLOCK_RDLOCK(&m_rwLock)
+	epoch=0;
 	return sz;
 } // end of CTspPool::getNextCut
+
+int CTspPool::getCutNum() const
+{
+	int num=0;
+	for (int s=0; s < SHARD_NUM; ++s) {
+		const tagShard &shard=m_Shard[s];
+		for (int i=shard.size-1; i >= 0; --i)
+			if (shard.pEntry[i >> SEG_BITS][i & (SEG_SIZE-1)].ct != FREE_CUT)
+				++num;
+	}
+	return num;
+} // end of CTspPool::getCutNum
+
+int CTspPool::getContentionNum() const
+{
+	int num=0;
+	for (int s=0; s < SHARD_NUM; ++s)
+		num+=m_Shard[s].contentionNum;
+	return num;
+} // end of CTspPool::getContentionNum
+
+int CTspPool::getReclaimWaitNum() const
+{
+	int num=0;
+	for (int s=0; s < SHARD_NUM; ++s)
+		num+=m_Shard[s].reclaimWaitNum;
+	return num;
+} // end of CTspPool::getReclaimWaitNum
@@ -9,70 +9,119 @@
 // each word y[v] is divided into 2 halfwords y_h[v] and y_l[v] where
 // y_l[v] = i if  v\in H_i; and y_l[v] = 0 otherwise
 // y_h[v] = j if  v\in T_j; and y_l[v] = 0 otherwise
+//
+// The pool is divided into shards; thread t adds its cuts to shard t % SHARD_NUM,
+// and the handle of a cut stored in entry i of shard s is (i << SHARD_BITS) | s.
+// Each shard stores its cuts in segments that are never moved, so that
+// readers (getNextCut(), buildRow(), buildColumn()) do not lock the pool;
+// only writers of the same shard are serialized by the shard mutex.
+// Reference counts and thread marks are atomic. A free entry is reused only
+// when all threads that might be reading it have left getNextCut() (epoch-based reclamation).
 
-
+#include <atomic>
+#include <climits>
 #include <thread.h>
 
 struct tagPoolEntry {
-    int state; // number of node LPs that use this constraint
-	int ct; // number of active nodes using this cut
+	std::atomic<int> state; // bit t is set if the cut is in the LP of thread t
+	std::atomic<int> ct; // number of active nodes using this cut, or FREE_CUT
 	int b;
+	int next; // next entry in the free list of a shard
 };
 
 class CTspPool {
-	int m_iPointNum, m_iPoolSize, m_iMaxPoolSize, m_iFirstFreeInPool; // describe the state of the pool
-	tagPoolEntry* m_pEntry; // pool for storing cuts
-	int* m_ipBuf; // memory buffer for storing cut coefficients
+public:
+	enum {
+		SHARD_BITS=3,
+		SHARD_NUM=1 << SHARD_BITS, // number of shards
+		SEG_BITS=8,
+		SEG_SIZE=1 << SEG_BITS, // number of cuts in one segment
+		MAX_SEG_NUM=1024, // maximum number of segments in one shard
+		MAX_THREAD_NUM=32, // thread marks are bits of an int, so thread indices must be less than MAX_THREAD_NUM
+		FREE_CUT=INT_MIN // value of `ct` of free entries
+	};
+
+private:
+	struct alignas(64) tagShard {
+		std::atomic<int> size; // entries 0,...,size-1 have been used
+		int segNum; // number of allocated segments
+		tagPoolEntry* pEntry[MAX_SEG_NUM]; // segments of entries
+		int* ipBuf[MAX_SEG_NUM]; // segments of cut coefficients
+		int freeHd; // first entry in the list of free entries
+		int retiredHd; // first entry in the list of entries freed at epoch retiredEpoch or earlier
+		unsigned retiredEpoch;
 #ifndef __ONE_THREAD_
-	_RWLOCK m_rwLock;
-	_MUTEX *m_pMemMutex;
+		_MUTEX mutex; // serializes writers
 #endif
+		std::atomic<int> waitNum; // number of writers holding or waiting for mutex
+		std::atomic<int> contentionNum; // number of times a writer found mutex busy
+		std::atomic<int> reclaimWaitNum; // number of times freed entries could not be reused yet
+	};
+
+	struct alignas(64) tagEpoch {
+		std::atomic<unsigned> val; // epoch at which thread entered getNextCut(), or 0
+	};
+
+	int m_iPointNum;
+	tagShard m_Shard[SHARD_NUM];
+	tagEpoch m_Epoch[MAX_THREAD_NUM];
+	std::atomic<unsigned> m_uEpoch; // global epoch, incremented when entries are freed
+	std::atomic<int> m_iRetryNum; // number of cuts freed while getNextCut() was evaluating them
+
 public:
 	CTspPool(int ptNum);
 	~CTspPool();
-	void allocMem();
-	void reallocMem();
 
 	static int getCoefficient(int yv, int yw);
-	int addCut(int b, int *ipComb);
-	void freeNotUsedCuts();
+	int addCut(int thread, int b, int *ipComb);
 
 	int buildRow(int hd, int n, const int *ipColHd, double* dpVal, int* ipCol, double &rhs);
 	int buildColumn(int v, int w, int m, const int* ipRowHd, double* dpVal, int* ipRow);
 
+	// If a violated cut is found, its handle is returned in hd, and its reference count
+	// is incremented; the caller must call unlockCtr(hd) if the cut is not used.
 	int getNextCut(int thread, int &hd, int n, const double* dpX, const int* ipColHd,
 			int *ipCol, double *dpVal, double &rhs);
 
 	void markCtr(int hd, int thread)
-		{m_pEntry[hd].state|= 1 << thread;}
+		{getEntry(hd).state.fetch_or(1 << thread);}
 	void unmarkCtr(int hd, int thread)
-		{m_pEntry[hd].state&=~(1 << thread);}
-	
+		{getEntry(hd).state.fetch_and(~(1 << thread));}
+
 	void lockCtr(int hd)
-	{
-		_RWLOCK_WRLOCK(&m_rwLock)
-		++m_pEntry[hd].ct;
-		_RWLOCK_UNLOCK_WRLOCK(&m_rwLock)
-	}
+		{++getEntry(hd).ct;}
 	void unlockCtr(int hd)
+		{--getEntry(hd).ct;}
+
+	int* getBufPtr()
+		{return m_Shard[0].ipBuf[0];}
+
+// statistics
+	int getCutNum() const; // number of cuts stored in the pool
+	int getContentionNum() const; // number of times writers had to wait for shard mutexes
+	int getRetryNum() const
+		{return m_iRetryNum;}
+	int getReclaimWaitNum() const; // number of times freed entries could not be reused because of readers
+
+private:
+	tagPoolEntry& getEntry(int hd)
 	{
-		_RWLOCK_WRLOCK(&m_rwLock)
-		--m_pEntry[hd].ct;
-		_RWLOCK_UNLOCK_WRLOCK(&m_rwLock)
+		tagShard &shard=m_Shard[hd & (SHARD_NUM-1)];
+		hd>>=SHARD_BITS;
+		return shard.pEntry[hd >> SEG_BITS][hd & (SEG_SIZE-1)];
 	}
-	
-	void wrLockPool()
-		{_RWLOCK_WRLOCK(&m_rwLock)}
-		
-	void wrUnlockPool()
-		{_RWLOCK_UNLOCK_WRLOCK(&m_rwLock)}
 
-	void rdUnlockPool()
-		{_RWLOCK_UNLOCK_RDLOCK(&m_rwLock)}
-
-	int* getBufPtr()
-		{return m_ipBuf;}
+	int* getCutData(int hd)
+	{
+		tagShard &shard=m_Shard[hd & (SHARD_NUM-1)];
+		hd>>=SHARD_BITS;
+		return shard.ipBuf[hd >> SEG_BITS]+(hd & (SEG_SIZE-1))*m_iPointNum;
+	}
 
+	void allocSegment(tagShard &shard);
+	void freeNotUsedCuts(tagShard &shard);
+	bool isSafeToReuse(unsigned epoch) const;
+	int getFreeEntry(tagShard &shard); // returns -1 if freed entries cannot be reused yet and no segment can be allocated
 }; //========================================
 
 #endif /*TSPPOOL_H_*/
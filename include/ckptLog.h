@@ -0,0 +1,365 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file ckptLog.h Interface for `CCheckpointLog` class
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __CKPTLOG_H_
+#define __CKPTLOG_H_
+
+#include <cstdio>
+#include <cstring>
+#include <new>
+#ifdef _WINDOWS
+#include <io.h>
+#else
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+#include "except.h"
+#include "thread.h"
+#include "nodeStore.h"
+
+/// Incremental checkpoint log.
+/**
+ * A checkpoint log is a binary file to which records are appended while a problem is being solved:
+ * incumbents, cuts, or any other data that allow a restarted run to avoid repeating work.
+ * Each record consists of a 12 byte header (type, size, and checksum of data) followed by data;
+ * a record that has been written only partially (for example, because the process was killed)
+ * is detected by its size or checksum, and reading stops there.
+ *
+ * Any thread of the solver may call `append()`; records are written under a mutex.
+ * Records of type `REC_INCUMBENT` are flushed to disk immediately.
+ *
+ * To restart a run, the user reads the log with `openForReading()` and `next()`,
+ * restores the data, and then calls `open()` to continue appending to the same file.
+ *
+ * As records are only appended, the log grows with every restart. To compact it,
+ * the user writes the records that are still needed (for example, the cuts and the best incumbent)
+ * into another log opened with `truncate=true`, closes it, and calls `replace()`.
+ */
+class CCheckpointLog
+{
+public:
+	/// Record types; user defined types must be not less than `REC_USER`.
+	enum {
+		REC_INCUMBENT=1, ///< incumbent written by `appendIncumbent()`.
+		REC_USER=16 ///< first user record type.
+	};
+
+private:
+	FILE* m_pFile; ///< log file.
+	bool m_bReading; ///< `true` if file is open for reading.
+	unsigned char* m_cpBuf; ///< buffer for reading records.
+	int m_iBufSize; ///< size of `m_cpBuf`.
+	int m_iRecNum; ///< number of records written or read.
+	long long m_llFileSize; ///< size of the file open for reading.
+	CNodeCoder m_coder; ///< encodes incumbents.
+#ifndef __ONE_THREAD_
+	_MUTEX m_mutex; ///< serializes writers.
+#endif
+
+public:
+	CCheckpointLog(): m_pFile(0), m_bReading(false), m_cpBuf(0), m_iBufSize(0), m_iRecNum(0), m_llFileSize(0)
+	{
+#ifndef __ONE_THREAD_
+		_MUTEX_INIT(m_mutex)
+#endif
+	} ///< The constructor.
+
+	~CCheckpointLog()
+	{
+		close();
+		if (m_cpBuf)
+			delete[] m_cpBuf;
+#ifndef __ONE_THREAD_
+		_MUTEX_DESTROY(m_mutex)
+#endif
+	} ///< The destructor.
+
+	/**
+	 * The function opens the log for appending records. The file is truncated after
+	 * the last complete record, so an incomplete tail left by a killed run is deleted.
+	 * \param[in] fileName file name;
+	 * \param[in] truncate if `true`, records already stored in the file are deleted.
+	 * \throws CFileException if file cannot be opened.
+	 */
+	void open(const char* fileName, bool truncate=false)
+	{
+		long long pos=0;
+		if (!truncate && openForReading(fileName)) {
+			int type, size;
+			const unsigned char* pData;
+			while (next(type,size,pData))
+				pos=tell();
+			close();
+			if ((m_pFile=fopen(fileName,"r+b")) && (truncateAt(pos) || fseek(m_pFile,0,SEEK_END))) {
+				fclose(m_pFile);
+				m_pFile=0;
+			}
+		}
+		else {
+			close();
+			m_pFile=fopen(fileName,"wb");
+		}
+		if (!m_pFile)
+			throw new CFileException("CCheckpointLog::open",fileName);
+		m_bReading=false;
+		m_iRecNum=0;
+	}
+
+	/**
+	 * The function replaces a log by its compacted copy. Both files must be closed.
+	 * On POSIX systems, the replacement is atomic, so that a killed run leaves either the old or the new log.
+	 * \param[in] fileName name of the log to be replaced;
+	 * \param[in] copyName name of the compacted copy, which is renamed to `fileName`.
+	 * \throws CFileException if the copy cannot be renamed.
+	 */
+	static void replace(const char* fileName, const char* copyName)
+	{
+#ifdef _WINDOWS
+		remove(fileName); // rename() does not overwrite existing files
+#endif
+		if (rename(copyName,fileName))
+			throw new CFileException("CCheckpointLog::replace",fileName);
+	}
+
+	/**
+	 * The function opens the log for reading records.
+	 * \param[in] fileName file name.
+	 * \return `false` if the file does not exist.
+	 */
+	bool openForReading(const char* fileName)
+	{
+		close();
+		if (!(m_pFile=fopen(fileName,"rb")))
+			return false;
+		m_llFileSize=(fseek(m_pFile,0,SEEK_END))? 0: tell();
+		rewind(m_pFile);
+		m_bReading=true;
+		m_iRecNum=0;
+		return true;
+	}
+
+	void close()
+	{
+		if (m_pFile) {
+			fclose(m_pFile);
+			m_pFile=0;
+		}
+	} ///< The function closes the log file.
+
+	bool isOpen() const
+		{return m_pFile && !m_bReading;} ///< \return `true` if records can be appended.
+
+	int getRecNum() const
+		{return m_iRecNum;} ///< \return number of records written (or read) since the file has been opened.
+
+	void flush()
+	{
+		if (m_pFile && !m_bReading)
+			fflush(m_pFile);
+	} ///< The function writes buffered records to disk.
+
+	/**
+	 * The function appends a record to the log; if the log is not open, the function does nothing.
+	 * \param[in] type record type;
+	 * \param[in] size size of record data in bytes;
+	 * \param[in] pData record data.
+	 * \throws CFileException if the record cannot be written.
+	 */
+	void append(int type, int size, const void* pData)
+	{
+		if (!isOpen())
+			return;
+#ifndef __ONE_THREAD_
+		_MUTEX* pMutex=&m_mutex;
+		_MUTEX_LOCK(pMutex)
+#endif
+		bool ok=writeRecord(type,size,static_cast<const unsigned char*>(pData));
+#ifndef __ONE_THREAD_
+		_MUTEX_UNLOCK(pMutex)
+#endif
+		if (!ok)
+			throw new CFileException("CCheckpointLog::append","checkpoint log");
+	}
+
+	/**
+	 * The function appends an incumbent; only nonzero components are stored.
+	 * \param[in] objVal objective value;
+	 * \param[in] n number of variables;
+	 * \param[in] dpX,ipHd `dpX[j]` is value of variable with handle `ipHd[j]`.
+	 * \throws CMemoryException lack of memory;
+	 * \throws CFileException if the record cannot be written.
+	 */
+	void appendIncumbent(double objVal, int n, const double* dpX, const int* ipHd)
+	{
+		if (!isOpen())
+			return;
+		bool ok;
+#ifndef __ONE_THREAD_
+		_MUTEX* pMutex=&m_mutex;
+		_MUTEX_LOCK(pMutex)
+#endif
+		try {
+			m_coder.clear();
+			m_coder.putDouble(objVal);
+			int k=0;
+			for (int j=0; j < n; ++j)
+				if (dpX[j] != 0.0)
+					++k;
+			m_coder.putUInt(k);
+			for (int j=0; j < n; ++j) {
+				if (dpX[j] != 0.0) {
+					m_coder.putInt(ipHd[j]);
+					m_coder.putDouble(dpX[j]);
+				}
+			}
+		}
+		catch(CMemoryException* pe) {
+#ifndef __ONE_THREAD_
+			_MUTEX_UNLOCK(pMutex)
+#endif
+			throw pe;
+		}
+		ok=writeRecord(REC_INCUMBENT,m_coder.getSize(),m_coder.getData());
+#ifndef __ONE_THREAD_
+		_MUTEX_UNLOCK(pMutex)
+#endif
+		if (!ok)
+			throw new CFileException("CCheckpointLog::appendIncumbent","checkpoint log");
+	}
+
+	/**
+	 * The function reads the next record from a log opened by `openForReading()`.
+	 * \param[out] type record type;
+	 * \param[out] size size of record data in bytes;
+	 * \param[out] pData pointer to record data, which is valid until the next call to `next()`.
+	 * \return `false` if there are no more complete records.
+	 * \throws CMemoryException lack of memory.
+	 */
+	bool next(int &type, int &size, const unsigned char* &pData)
+	{
+		unsigned header[3];
+		if (!m_pFile || !m_bReading || fread(header,sizeof(unsigned),3,m_pFile) != 3)
+			return false;
+		if ((size=static_cast<int>(header[1])) < 0 || size > m_llFileSize-tell())
+			return false; // corrupted size, which must not cause a huge allocation
+		if (size > m_iBufSize) {
+			if (m_cpBuf)
+				delete[] m_cpBuf;
+			if (!(m_cpBuf = new(std::nothrow) unsigned char[size])) {
+				m_iBufSize=0;
+				throw new CMemoryException("CCheckpointLog::next");
+			}
+			m_iBufSize=size;
+		}
+		if (fread(m_cpBuf,1,size,m_pFile) != static_cast<size_t>(size) ||
+			checksum(size,m_cpBuf) != header[2])
+			return false; // the tail of the log has not been written completely
+		type=static_cast<int>(header[0]);
+		pData=m_cpBuf;
+		++m_iRecNum;
+		return true;
+	}
+
+	/**
+	 * The function decodes an incumbent record.
+	 * \param[in] pData record data;
+	 * \param[out] objVal objective value;
+	 * \param[out] n number of nonzero components;
+	 * \param[out] dpX,ipHd if not `0`, arrays of sufficient size to store values and handles of nonzero components.
+	 */
+	static void getIncumbent(const unsigned char* pData, double &objVal, int &n, double* dpX, int* ipHd)
+	{
+		unsigned k;
+		pData=CNodeCoder::getDouble(pData,objVal);
+		pData=CNodeCoder::getUInt(pData,k);
+		n=static_cast<int>(k);
+		if (dpX && ipHd) {
+			for (int j=0; j < n; ++j) {
+				pData=CNodeCoder::getInt(pData,ipHd[j]);
+				pData=CNodeCoder::getDouble(pData,dpX[j]);
+			}
+		}
+	}
+
+private:
+	/**
+	 * \return current position in the log file; `ftell()` returns a `long`, which is 32-bit on Windows.
+	 */
+	long long tell()
+	{
+#ifdef _WINDOWS
+		return _ftelli64(m_pFile);
+#else
+		return static_cast<long long>(ftello(m_pFile));
+#endif
+	}
+
+	/**
+	 * The function cuts the log file at a given position.
+	 * \param[in] pos new file size.
+	 * \return `0` on success.
+	 */
+	int truncateAt(long long pos)
+	{
+		fflush(m_pFile);
+#ifdef _WINDOWS
+		return _chsize_s(_fileno(m_pFile),pos);
+#else
+		return ftruncate(fileno(m_pFile),static_cast<off_t>(pos));
+#endif
+	}
+
+	/**
+	 * The function writes a record; the caller must hold `m_mutex`.
+	 * \return `false` if the record cannot be written.
+	 */
+	bool writeRecord(int type, int size, const unsigned char* cpData)
+	{
+		unsigned header[3]={static_cast<unsigned>(type),static_cast<unsigned>(size),checksum(size,cpData)};
+		bool ok=fwrite(header,sizeof(unsigned),3,m_pFile) == 3 &&
+				fwrite(cpData,1,size,m_pFile) == static_cast<size_t>(size);
+		if (ok && type == REC_INCUMBENT)
+			ok=!fflush(m_pFile);
+		++m_iRecNum;
+		return ok;
+	}
+
+	/**
+	 * \return FNV-1a hash of `size` bytes starting at `cpData`.
+	 */
+	static unsigned checksum(int size, const unsigned char* cpData)
+	{
+		unsigned h=2166136261u;
+		for (int i=0; i < size; ++i) {
+			h^=cpData[i];
+			h*=16777619u;
+		}
+		return h;
+	}
+};
+
+#endif // __CKPTLOG_H_
@@ -0,0 +1,638 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file cliqueTable.h Interface for `CCliqueTable` class
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __CLIQUETABLE_H_
+#define __CLIQUETABLE_H_
+
+#include <new>
+#include "except.h"
+#include "lp.h"
+#include "cutBuffer.h"
+
+/// Clique table of binary variables.
+/**
+ * A _literal_ is either a binary variable \f$x_j\f$ (literal `2*j`) or its complement \f$1-x_j\f$ (literal `2*j+1`).
+ * A _clique_ is a set of literals of which at most one can be equal to `1`.
+ * An implication \f$x_j=v\Rightarrow x_i=u\f$ is the clique of two literals \f$x_j=v\f$ and \f$x_i=1-u\f$.
+ *
+ * Cliques are stored as compressed sparse rows (literals of each clique are sorted), together with
+ * the occurrence lists of all literals, so that clique separation and implication queries
+ * are linear scans over contiguous memory.
+ *
+ * `build()` is called after all cliques have been added (usually in presolve); it
+ *   - sorts cliques and removes repeated literals; a clique containing both a literal and its complement
+ *     forces all its other literals to `0` (see `getFixedLitNum()`), and is removed; a clique containing
+ *     two such pairs makes the problem infeasible (see `isInfeasible()`);
+ *   - merges cliques of two literals: each such clique is greedily extended by literals adjacent to both its literals
+ *     and to all literals already added;
+ *   - removes cliques contained in other cliques.
+ *
+ * Queries (`isAdjacent()`, `getImplied()`, `separate()`) are valid only after `build()`.
+ * For example, implications found by probing can be collected as follows:
+ * ~~~
+ * for (int k=0; k < prober.getImplNum(); ++k) {
+ *     prober.getImplication(k,j,val,i,iVal);
+ *     table.addImplication(j,val,i,iVal);
+ * }
+ * table.build();
+ * ~~~
+ */
+class CCliqueTable
+{
+	int m_iN; ///< number of variables.
+	int m_iCliqueNum; ///< number of cliques.
+	int m_iCliqueCap; ///< size of `m_ipStart` minus `1`.
+	int* m_ipStart; ///< literals of clique `k` are `m_ipLit[m_ipStart[k]],...,m_ipLit[m_ipStart[k+1]-1]`.
+	int m_iLitCap; ///< size of `m_ipLit`.
+	int* m_ipLit; ///< literals of cliques.
+	int* m_ipOccStart; ///< cliques containing literal `l` are `m_ipOcc[m_ipOccStart[l]],...,m_ipOcc[m_ipOccStart[l+1]-1]`.
+	int* m_ipOcc; ///< occurrence lists.
+	int* m_ipMark; ///< marks of literals.
+	int m_iStamp; ///< last mark used.
+	char* m_cpRemoved; ///< `m_cpRemoved[k]` is `1` if clique `k` is to be removed.
+	int* m_ipCover; ///< `m_ipCover[l]` is the last clique created by merging that contains literal `l`, or `-1`.
+	int* m_ipBuf; ///< buffer of size `2*n`.
+	int m_iFixedNum; ///< number of literals fixed to `0`.
+	int* m_ipFixed; ///< literals fixed to `0`.
+	char* m_cpFixed; ///< `m_cpFixed[l]` is `1` if literal `l` is fixed to `0`.
+	bool m_bBuilt; ///< `true` if occurrence lists are up to date.
+	bool m_bInfeasible; ///< `true` if a clique contains two pairs of complementary literals.
+	int m_iMergedNum; ///< number of cliques created by merging.
+	int m_iDominatedNum; ///< number of cliques removed as contained in other cliques.
+
+public:
+	/**
+	 * The constructor.
+	 * \param[in] n number of variables.
+	 * \throws CMemoryException lack of memory.
+	 */
+	CCliqueTable(int n): m_iN(n), m_iCliqueNum(0), m_iCliqueCap(256), m_ipStart(0), m_iLitCap(1024), m_ipLit(0),
+		m_ipOccStart(0), m_ipOcc(0), m_ipMark(0), m_iStamp(0), m_cpRemoved(0), m_ipCover(0), m_ipBuf(0), m_iFixedNum(0), m_ipFixed(0), m_cpFixed(0),
+		m_bBuilt(false), m_bInfeasible(false), m_iMergedNum(0), m_iDominatedNum(0)
+	{
+		int litNum=(n<<1)+1;
+		if (!(m_ipStart = new(std::nothrow) int[m_iCliqueCap+1]) ||
+			!(m_ipLit = new(std::nothrow) int[m_iLitCap]) ||
+			!(m_cpRemoved = new(std::nothrow) char[m_iCliqueCap]) ||
+			!(m_ipOccStart = new(std::nothrow) int[litNum+1]) ||
+			!(m_ipMark = new(std::nothrow) int[litNum]) ||
+			!(m_ipCover = new(std::nothrow) int[litNum]) ||
+			!(m_ipBuf = new(std::nothrow) int[litNum]) ||
+			!(m_ipFixed = new(std::nothrow) int[litNum]) ||
+			!(m_cpFixed = new(std::nothrow) char[litNum])) {
+			clear();
+			throw new CMemoryException("CCliqueTable::CCliqueTable");
+		}
+		m_ipStart[0]=0;
+		for (int l=0; l < litNum; ++l) {
+			m_ipMark[l]=m_ipOccStart[l]=0;
+			m_cpFixed[l]=0;
+		}
+		m_ipOccStart[litNum]=0;
+	}
+
+	~CCliqueTable()
+		{clear();} ///< The destructor.
+
+	/**
+	 * \param[in] j variable index;
+	 * \param[in] val value of variable.
+	 * \return literal that is `1` if \f$x_j=val\f$.
+	 */
+	static int literal(int j, int val)
+		{return (j<<1)|(val? 0: 1);}
+
+	/**
+	 * The function adds a clique.
+	 * \param[in] sz number of literals;
+	 * \param[in] ipLit array of size `sz` of literals.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void addClique(int sz, const int* ipLit)
+	{
+		if (m_iCliqueNum == m_iCliqueCap)
+			growCliques();
+		int start=m_ipStart[m_iCliqueNum];
+		if (start+sz > m_iLitCap)
+			growLiterals(start+sz);
+		for (int i=0; i < sz; ++i)
+			m_ipLit[start+i]=ipLit[i];
+		m_cpRemoved[m_iCliqueNum]=0;
+		m_ipStart[++m_iCliqueNum]=start+sz;
+		m_bBuilt=false;
+	}
+
+	/**
+	 * The function adds the implication \f$x_j=val\Rightarrow x_i=iVal\f$.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void addImplication(int j, int val, int i, int iVal)
+	{
+		int lit[2]={literal(j,val),literal(i,1-iVal)};
+		addClique(2,lit);
+	}
+
+	/**
+	 * The function prepares the table for queries: it normalizes, merges, and removes dominated cliques,
+	 * and builds occurrence lists.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void build()
+	{
+		normalize();
+		buildOccurrences();
+		mergeEdges();
+		buildOccurrences();
+		removeDominated();
+		buildOccurrences();
+		m_bBuilt=true;
+	}
+
+	bool isBuilt() const
+		{return m_bBuilt;} ///< \return `true` if `build()` has been called after the last clique was added.
+	bool isInfeasible() const
+		{return m_bInfeasible;} ///< \return `true` if a clique contains two pairs of complementary literals.
+	int getCliqueNum() const
+		{return m_iCliqueNum;} ///< \return number of cliques.
+	int getMergedNum() const
+		{return m_iMergedNum;} ///< \return number of cliques created by merging.
+	int getDominatedNum() const
+		{return m_iDominatedNum;} ///< \return number of cliques removed as contained in other cliques.
+	int getFixedLitNum() const
+		{return m_iFixedNum;} ///< \return number of literals that must be `0`.
+
+	/**
+	 * \param[in] k index, `0 <= k < getFixedLitNum()`.
+	 * \return `k`-th literal that must be `0`.
+	 */
+	int getFixedLit(int k) const
+		{return m_ipFixed[k];}
+
+	/**
+	 * \param[in] k clique index;
+	 * \param[out] ipLit pointer to sorted literals of clique `k`.
+	 * \return size of clique `k`.
+	 */
+	int getClique(int k, const int* &ipLit) const
+	{
+		ipLit=m_ipLit+m_ipStart[k];
+		return m_ipStart[k+1]-m_ipStart[k];
+	}
+
+	/**
+	 * \param[in] l literal;
+	 * \param[out] ipClique pointer to indices of cliques containing `l`.
+	 * \return number of cliques containing `l`.
+	 */
+	int getOccurrences(int l, const int* &ipClique) const
+	{
+		ipClique=m_ipOcc+m_ipOccStart[l];
+		return m_ipOccStart[l+1]-m_ipOccStart[l];
+	}
+
+	/**
+	 * \param[in] l1,l2 literals.
+	 * \return `true` if `l1` and `l2` belong to a common clique, that is, they cannot be both `1`.
+	 */
+	bool isAdjacent(int l1, int l2) const
+	{
+		if (m_ipOccStart[l1+1]-m_ipOccStart[l1] > m_ipOccStart[l2+1]-m_ipOccStart[l2]) {
+			int l=l1;
+			l1=l2;
+			l2=l;
+		}
+		for (int o=m_ipOccStart[l1]; o < m_ipOccStart[l1+1]; ++o) {
+			int k=m_ipOcc[o], lo=m_ipStart[k], hi=m_ipStart[k+1]-1;
+			while (lo < hi) {
+				int mid=(lo+hi) >> 1;
+				if (m_ipLit[mid] < l2)
+					lo=mid+1;
+				else
+					hi=mid;
+			}
+			if (m_ipLit[lo] == l2)
+				return true;
+		}
+		return false;
+	}
+
+	/**
+	 * The function lists literals that must be `0` if literal `l` is `1`.
+	 * \param[in] l literal;
+	 * \param[out] ipLit array of size `2*n`.
+	 * \return number of literals.
+	 */
+	int getImplied(int l, int* ipLit)
+	{
+		int num=0, s=++m_iStamp;
+		m_ipMark[l]=s;
+		for (int o=m_ipOccStart[l]; o < m_ipOccStart[l+1]; ++o) {
+			int k=m_ipOcc[o];
+			for (int e=m_ipStart[k]; e < m_ipStart[k+1]; ++e)
+				if (m_ipMark[m_ipLit[e]] != s) {
+					m_ipMark[m_ipLit[e]]=s;
+					ipLit[num++]=m_ipLit[e];
+				}
+		}
+		return num;
+	}
+
+	/**
+	 * The function separates clique inequalities
+	 * \f$\sum_{j:\,2j\in C} x_j+\sum_{j:\,2j+1\in C}(1-x_j)\le 1\f$.
+	 * Each violated clique is extended by literals with positive values adjacent to all its literals,
+	 * and written into a buffer with variable indices as columns.
+	 * \param[in] dpX array of size `n`, `dpX[j]` is value of variable `j`;
+	 * \param[out] buf buffer for cuts;
+	 * \param[in] hd,type handle and type of cuts (see `CMIP::addCut()`);
+	 * \param[in] minViol minimum violation.
+	 * \return number of cuts written.
+	 * \throws CMemoryException lack of memory.
+	 */
+	int separate(const double* dpX, CCutBuffer &buf, CLP::tagHANDLE hd, unsigned type, double minViol=1.0e-3)
+	{
+		int cutNum=0;
+		double* dpVal=0;
+		try {
+			for (int k=0; k < m_iCliqueNum; ++k) {
+				double act=0.0;
+				for (int e=m_ipStart[k]; e < m_ipStart[k+1]; ++e)
+					act+=value(m_ipLit[e],dpX);
+				if (act <= 1.0+minViol)
+					continue;
+				int sz=extend(k,dpX), negNum=0;
+				if (!dpVal && !(dpVal = new(std::nothrow) double[m_iN+1]))
+					throw new CMemoryException("CCliqueTable::separate");
+				for (int i=0; i < sz; ++i) {
+					int l=m_ipBuf[i];
+					if (l & 1) {
+						dpVal[i]=-1.0;
+						++negNum;
+					}
+					else
+						dpVal[i]=1.0;
+					m_ipBuf[i]=l >> 1;
+				}
+				buf.add(hd,type,-CLP::INF,1.0-negNum,sz,dpVal,m_ipBuf);
+				++cutNum;
+			}
+		}
+		catch(CMemoryException* pe) {
+			delete[] dpVal;
+			throw pe;
+		}
+		delete[] dpVal;
+		return cutNum;
+	}
+
+private:
+	void clear()
+	{
+		delete[] m_ipStart;
+		delete[] m_ipLit;
+		delete[] m_cpRemoved;
+		delete[] m_ipOccStart;
+		delete[] m_ipOcc;
+		delete[] m_ipMark;
+		delete[] m_ipCover;
+		delete[] m_ipBuf;
+		delete[] m_ipFixed;
+		delete[] m_cpFixed;
+		m_ipStart=m_ipLit=m_ipOccStart=m_ipOcc=m_ipMark=m_ipCover=m_ipBuf=m_ipFixed=0;
+		m_cpRemoved=m_cpFixed=0;
+	}
+
+	/**
+	 * \return value of literal `l` at solution `dpX`.
+	 */
+	static double value(int l, const double* dpX)
+		{return (l & 1)? 1.0-dpX[l >> 1]: dpX[l >> 1];}
+
+	/**
+	 * \return size of clique `k`.
+	 */
+	int getSize(int k) const
+		{return m_ipStart[k+1]-m_ipStart[k];}
+
+	/**
+	 * The function doubles the maximum number of cliques.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void growCliques()
+	{
+		int cap=m_iCliqueCap<<1;
+		int* ipStart=new(std::nothrow) int[cap+1];
+		char* cpRemoved=new(std::nothrow) char[cap];
+		if (!ipStart || !cpRemoved) {
+			delete[] ipStart;
+			delete[] cpRemoved;
+			throw new CMemoryException("CCliqueTable::growCliques");
+		}
+		for (int k=0; k <= m_iCliqueNum; ++k)
+			ipStart[k]=m_ipStart[k];
+		for (int k=0; k < m_iCliqueNum; ++k)
+			cpRemoved[k]=m_cpRemoved[k];
+		delete[] m_ipStart;
+		delete[] m_cpRemoved;
+		m_ipStart=ipStart;
+		m_cpRemoved=cpRemoved;
+		m_iCliqueCap=cap;
+	}
+
+	/**
+	 * The function reallocates memory for at least `num` literals.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void growLiterals(int num)
+	{
+		int cap=m_iLitCap<<1;
+		if (cap < num)
+			cap=num;
+		int* ipLit=new(std::nothrow) int[cap];
+		if (!ipLit)
+			throw new CMemoryException("CCliqueTable::growLiterals");
+		for (int e=0; e < m_ipStart[m_iCliqueNum]; ++e)
+			ipLit[e]=m_ipLit[e];
+		delete[] m_ipLit;
+		m_ipLit=ipLit;
+		m_iLitCap=cap;
+	}
+
+	/**
+	 * The function sorts `sz` integers in increasing order (Shell sort).
+	 */
+	static void sortInt(int sz, int* ipVal)
+	{
+		int gap=1;
+		while (gap < sz/3)
+			gap=3*gap+1;
+		for (; gap > 0; gap/=3)
+			for (int i=gap; i < sz; ++i) {
+				int x=ipVal[i], k=i;
+				for (; k >= gap && ipVal[k-gap] > x; k-=gap)
+					ipVal[k]=ipVal[k-gap];
+				ipVal[k]=x;
+			}
+	}
+
+	/**
+	 * The function removes cliques marked in `m_cpRemoved`, and packs literals of the other cliques;
+	 * negative literals mark the end of a clique.
+	 */
+	void compact()
+	{
+		int num=0, nz=0, start=0;
+		for (int k=0; k < m_iCliqueNum; ++k) {
+			int end=m_ipStart[k+1];
+			if (m_cpRemoved[k]) {
+				start=end;
+				continue;
+			}
+			for (int e=start; e < end && m_ipLit[e] >= 0; ++e)
+				m_ipLit[nz++]=m_ipLit[e];
+			m_cpRemoved[num]=0;
+			m_ipStart[++num]=nz;
+			start=end;
+		}
+		m_iCliqueNum=num;
+	}
+
+	/**
+	 * The function records that literal `l` must be `0`.
+	 */
+	void fixLiteral(int l)
+	{
+		if (!m_cpFixed[l]) {
+			m_cpFixed[l]=1;
+			m_ipFixed[m_iFixedNum++]=l;
+		}
+	}
+
+	/**
+	 * The function sorts literals of each clique, removes repeated literals and literals fixed to `0`,
+	 * and removes cliques of less than two literals.
+	 */
+	void normalize()
+	{
+		for (int k=0; k < m_iCliqueNum; ++k) {
+			int start=m_ipStart[k], sz=m_ipStart[k+1]-start, num=0, comp=-1, compNum=0;
+			int* ipLit=m_ipLit+start;
+			sortInt(sz,ipLit);
+			for (int i=0; i < sz; ++i) {
+				if (num && ipLit[num-1] == ipLit[i])
+					continue;
+				if (num && ipLit[num-1] == (ipLit[i] ^ 1)) {
+					comp=ipLit[i] >> 1;
+					++compNum;
+				}
+				ipLit[num++]=ipLit[i];
+			}
+			if (comp >= 0) {
+				if (compNum > 1)
+					m_bInfeasible=true;
+				else
+					for (int i=0; i < num; ++i)
+						if ((ipLit[i] >> 1) != comp)
+							fixLiteral(ipLit[i]);
+				m_cpRemoved[k]=1;
+			}
+			for (int i=num; i < sz; ++i)
+				ipLit[i]=-1;
+		}
+		for (int k=0; k < m_iCliqueNum; ++k) {
+			int start=m_ipStart[k], num=0;
+			for (int e=start; e < m_ipStart[k+1] && m_ipLit[e] >= 0; ++e)
+				if (!m_cpFixed[m_ipLit[e]])
+					m_ipLit[start+num++]=m_ipLit[e];
+			for (int e=start+num; e < m_ipStart[k+1]; ++e)
+				m_ipLit[e]=-1;
+			if (num < 2)
+				m_cpRemoved[k]=1;
+		}
+		compact();
+	}
+
+	/**
+	 * The function builds occurrence lists; cliques in each list are in increasing order.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void buildOccurrences()
+	{
+		int litNum=m_iN<<1, nz=m_ipStart[m_iCliqueNum];
+		for (int l=0; l <= litNum; ++l)
+			m_ipOccStart[l]=0;
+		for (int e=0; e < nz; ++e)
+			++m_ipOccStart[m_ipLit[e]+1];
+		for (int l=0; l < litNum; ++l)
+			m_ipOccStart[l+1]+=m_ipOccStart[l];
+		delete[] m_ipOcc;
+		if (!(m_ipOcc = new(std::nothrow) int[(nz)? nz: 1]))
+			throw new CMemoryException("CCliqueTable::buildOccurrences");
+		for (int l=0; l < litNum; ++l)
+			m_ipBuf[l]=m_ipOccStart[l];
+		for (int k=0; k < m_iCliqueNum; ++k)
+			for (int e=m_ipStart[k]; e < m_ipStart[k+1]; ++e)
+				m_ipOcc[m_ipBuf[m_ipLit[e]]++]=k;
+	}
+
+	/**
+	 * The function extends each clique `{a,b}` by literals adjacent to `a`, `b`, and all literals added before;
+	 * an extended clique replaces `{a,b}`, and cliques contained in it are removed later by `removeDominated()`.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void mergeEdges()
+	{
+		int litNum=m_iN<<1, num=m_iCliqueNum;
+		for (int l=0; l < litNum; ++l)
+			m_ipCover[l]=-1;
+		int* ipCand=new(std::nothrow) int[litNum+1];
+		if (!ipCand)
+			throw new CMemoryException("CCliqueTable::mergeEdges");
+		try {
+			for (int k=0; k < num; ++k) {
+				if (getSize(k) != 2)
+					continue;
+				int a=m_ipLit[m_ipStart[k]], b=m_ipLit[m_ipStart[k]+1];
+				if (m_ipCover[a] >= 0 && m_ipCover[a] == m_ipCover[b]) {
+					m_cpRemoved[k]=1;
+					continue;
+				}
+				int s1=++m_iStamp;
+				for (int o=m_ipOccStart[a]; o < m_ipOccStart[a+1]; ++o) {
+					int c=m_ipOcc[o];
+					for (int e=m_ipStart[c]; e < m_ipStart[c+1]; ++e)
+						m_ipMark[m_ipLit[e]]=s1;
+				}
+				int s2=++m_iStamp, candNum=0;
+				for (int o=m_ipOccStart[b]; o < m_ipOccStart[b+1]; ++o) {
+					int c=m_ipOcc[o];
+					for (int e=m_ipStart[c]; e < m_ipStart[c+1]; ++e) {
+						int l=m_ipLit[e];
+						if (m_ipMark[l] == s1 && l != a && l != b) {
+							m_ipMark[l]=s2;
+							ipCand[candNum++]=l;
+						}
+					}
+				}
+				if (!candNum)
+					continue;
+				int sz=0;
+				m_ipBuf[sz++]=a;
+				m_ipBuf[sz++]=b;
+				for (int t=0; t < candNum; ++t) {
+					int l=ipCand[t], i=2;
+					for (; i < sz; ++i)
+						if (!isAdjacent(l,m_ipBuf[i]))
+							break;
+					if (i == sz)
+						m_ipBuf[sz++]=l;
+				}
+				addClique(sz,m_ipBuf);
+				int c=m_iCliqueNum-1;
+				sortInt(sz,m_ipLit+m_ipStart[c]);
+				for (int i=0; i < sz; ++i)
+					m_ipCover[m_ipBuf[i]]=c;
+				m_cpRemoved[k]=1;
+				++m_iMergedNum;
+			}
+		}
+		catch(CMemoryException* pe) {
+			delete[] ipCand;
+			throw pe;
+		}
+		delete[] ipCand;
+		compact();
+	}
+
+	/**
+	 * The function removes cliques contained in other cliques; of identical cliques, the first one is kept.
+	 */
+	void removeDominated()
+	{
+		for (int k=0; k < m_iCliqueNum; ++k) {
+			int sz=getSize(k), s=++m_iStamp, lmin=-1;
+			for (int e=m_ipStart[k]; e < m_ipStart[k+1]; ++e) {
+				int l=m_ipLit[e];
+				m_ipMark[l]=s;
+				if (lmin < 0 || m_ipOccStart[l+1]-m_ipOccStart[l] < m_ipOccStart[lmin+1]-m_ipOccStart[lmin])
+					lmin=l;
+			}
+			for (int o=m_ipOccStart[lmin]; o < m_ipOccStart[lmin+1]; ++o) {
+				int d=m_ipOcc[o], dsz=getSize(d);
+				if (d == k || m_cpRemoved[d] || dsz < sz || (dsz == sz && d > k))
+					continue;
+				int cnt=0;
+				for (int e=m_ipStart[d]; e < m_ipStart[d+1]; ++e)
+					if (m_ipMark[m_ipLit[e]] == s)
+						++cnt;
+				if (cnt == sz) {
+					m_cpRemoved[k]=1;
+					++m_iDominatedNum;
+					break;
+				}
+			}
+		}
+		compact();
+	}
+
+	/**
+	 * The function copies clique `k` into `m_ipBuf`, and greedily extends it by literals positive at `dpX`
+	 * and adjacent to all literals of the clique.
+	 * \return size of the extended clique.
+	 */
+	int extend(int k, const double* dpX)
+	{
+		int sz=0, s=++m_iStamp, lmin=-1;
+		for (int e=m_ipStart[k]; e < m_ipStart[k+1]; ++e) {
+			int l=m_ipLit[e];
+			m_ipBuf[sz++]=l;
+			m_ipMark[l]=s;
+			if (lmin < 0 || m_ipOccStart[l+1]-m_ipOccStart[l] < m_ipOccStart[lmin+1]-m_ipOccStart[lmin])
+				lmin=l;
+		}
+		for (int o=m_ipOccStart[lmin]; o < m_ipOccStart[lmin+1]; ++o) {
+			int c=m_ipOcc[o];
+			for (int e=m_ipStart[c]; e < m_ipStart[c+1]; ++e) {
+				int l=m_ipLit[e];
+				if (m_ipMark[l] == s)
+					continue;
+				m_ipMark[l]=s;
+				if (value(l,dpX) <= 1.0e-6)
+					continue;
+				int i=0;
+				for (; i < sz; ++i)
+					if (m_ipBuf[i] != lmin && !isAdjacent(l,m_ipBuf[i]))
+						break;
+				if (i == sz)
+					m_ipBuf[sz++]=l;
+			}
+		}
+		return sz;
+	}
+};
+
+#endif // __CLIQUETABLE_H_
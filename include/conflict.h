@@ -0,0 +1,358 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file conflict.h Interface for `CConflictPool` class
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __CONFLICT_H_
+#define __CONFLICT_H_
+
+#include <new>
+#include <cstring>
+#include "except.h"
+#include "thread.h"
+#ifndef __ONE_THREAD_
+#include <atomic>
+#endif
+
+/// Pool of conflicts derived from infeasible or cut off nodes.
+/**
+ * When a node LP is infeasible, a certificate of infeasibility (see `CLP::whyLpInfeasible()`)
+ * tells which variable bounds take part in the contradiction. If all the constraints used in the certificate
+ * are globally valid, only bounds that have been tightened by branching are responsible for infeasibility.
+ * If all of them are bounds of binary variables, the node gives a _conflict_: a set of _literals_
+ * `x_j=v` that cannot all hold in a feasible (or better than the record) solution, that is,
+ * \f[
+ *    \sum_{(j,1)} x_j - \sum_{(j,0)} x_j \le |\{(j,1)\}| - 1.
+ * \f]
+ * For a node cut off by the objective bound, nonzero reduced costs play the role of the certificate.
+ *
+ * Short conflicts are stored (duplicates are rejected) and then used by `propagate()`
+ * to fix variables or to prune nodes in other subtrees; `getRow()` writes a conflict as an inequality,
+ * which can be added to the matrix by `CMIP::addCut()`.
+ * One pool may be shared by all threads of the solver.
+ */
+class CConflictPool
+{
+public:
+	enum {
+		MAX_LEN=64 ///< upper limit on the number of literals in a stored conflict.
+	};
+
+private:
+	int m_iVarNum; ///< number of variables.
+	int m_iMaxLen; ///< maximum number of literals in a stored conflict.
+	int m_iMaxNum; ///< maximum number of stored conflicts.
+	int m_iNum; ///< number of stored conflicts.
+	int m_iLitCap; ///< size of `m_ipLit`.
+	int* m_ipStart; ///< literals of conflict `c` are `m_ipLit[m_ipStart[c]],...,m_ipLit[m_ipStart[c+1]-1]`.
+	int* m_ipLit; ///< literal `(j<<1)|v` stands for `x_j=v`.
+	unsigned* m_ipHash; ///< `m_ipHash[c]` is hash value of conflict `c`.
+	int* m_ipNext; ///< `m_ipNext[c]` is next conflict in the hash chain of conflict `c`, or `-1`.
+	int m_iBucketNum; ///< number of hash buckets (a power of `2`).
+	int* m_ipBucket; ///< `m_ipBucket[h]` is first conflict in bucket `h`, or `-1`.
+#ifndef __ONE_THREAD_
+	std::atomic<int> m_iFailNum; ///< number of calls to `analyze()` that have not produced a conflict.
+	std::atomic<int> m_iDupNum; ///< number of rejected duplicates.
+	std::atomic<int> m_iFixNum; ///< number of variables fixed by `propagate()`.
+	std::atomic<int> m_iPruneNum; ///< number of nodes pruned by `propagate()`.
+	_RWLOCK m_rwLock; ///< writers (`addConflict()`) exclude readers (`propagate()`).
+#else
+	int m_iFailNum; ///< number of calls to `analyze()` that have not produced a conflict.
+	int m_iDupNum; ///< number of rejected duplicates.
+	int m_iFixNum; ///< number of variables fixed by `propagate()`.
+	int m_iPruneNum; ///< number of nodes pruned by `propagate()`.
+#endif
+
+public:
+	/**
+	 * The constructor.
+	 * \param[in] varNum number of variables;
+	 * \param[in] maxLen maximum number of literals in a stored conflict, at most `MAX_LEN`;
+	 * \param[in] maxNum maximum number of stored conflicts.
+	 * \throws CMemoryException lack of memory.
+	 */
+	CConflictPool(int varNum, int maxLen=10, int maxNum=10000):
+		m_iVarNum(varNum), m_iMaxLen(maxLen), m_iMaxNum(maxNum), m_iNum(0), m_iLitCap(maxNum*4), m_iBucketNum(1),
+		m_iFailNum(0), m_iDupNum(0), m_iFixNum(0), m_iPruneNum(0)
+	{
+		if (m_iMaxLen > MAX_LEN)
+			m_iMaxLen=MAX_LEN;
+		m_ipLit=m_ipStart=m_ipNext=m_ipBucket=0;
+		m_ipHash=0;
+		while (m_iBucketNum < maxNum)
+			m_iBucketNum<<=1;
+		if (!(m_ipStart = new(std::nothrow) int[maxNum+1]) ||
+			!(m_ipLit = new(std::nothrow) int[m_iLitCap]) ||
+			!(m_ipHash = new(std::nothrow) unsigned[maxNum]) ||
+			!(m_ipNext = new(std::nothrow) int[maxNum]) ||
+			!(m_ipBucket = new(std::nothrow) int[m_iBucketNum])) {
+			clear();
+			throw new CMemoryException("CConflictPool::CConflictPool");
+		}
+		m_ipStart[0]=0;
+		for (int h=0; h < m_iBucketNum; ++h)
+			m_ipBucket[h]=-1;
+#ifndef __ONE_THREAD_
+		_RWLOCK_INIT(m_rwLock)
+#endif
+	}
+
+	~CConflictPool()
+	{
+		clear();
+#ifndef __ONE_THREAD_
+		_RWLOCK_DESTROY(m_rwLock)
+#endif
+	} ///< The destructor.
+
+	int getConflictNum() const
+		{return m_iNum;} ///< \return number of stored conflicts.
+	int getFailNum() const
+		{return m_iFailNum;} ///< \return number of calls to `analyze()` that have not produced a conflict.
+	int getDupNum() const
+		{return m_iDupNum;} ///< \return number of rejected duplicates.
+	int getFixNum() const
+		{return m_iFixNum;} ///< \return number of variables fixed by `propagate()`.
+	int getPruneNum() const
+		{return m_iPruneNum;} ///< \return number of nodes pruned by `propagate()`.
+
+	/**
+	 * The function derives a conflict from a certificate and adds it to the pool.
+	 * \param[in] n number of variables in the certificate;
+	 * \param[in] ipVar,dpY if `dpY[i] > 0` (resp., `dpY[i] < 0`), then the upper (resp., lower) bound
+	 *     of variable `ipVar[i]` takes part in the certificate;
+	 * \param[in] dpD array of size `2*n`: `dpD[i<<1]` and `dpD[(i<<1)+1]` are lower and upper bounds
+	 *     of variable `ipVar[i]` at the node;
+	 * \param[in] dpD0 array of size `2*n` of global bounds in the same format.
+	 * \return index of the new conflict; `-1` if no conflict has been derived
+	 * (certificate uses a tightened bound of a non-binary variable, the conflict is too long, or it is a duplicate).
+	 * \attention If no bound has been tightened, the problem is infeasible (or no solution is better than the record);
+	 * in this case the function returns `-2`.
+	 */
+	int analyze(int n, const int* ipVar, const double* dpY, const double* dpD, const double* dpD0)
+	{
+		int len=0, ipLit[MAX_LEN];
+		for (int i=0; i < n; ++i) {
+			int lit;
+			if (dpY[i] > 1.0e-9) {
+				if (dpD[(i<<1)+1] > dpD0[(i<<1)+1]-0.5)
+					continue; // global bound
+				lit=ipVar[i] << 1; // x_j=0
+			}
+			else if (dpY[i] < -1.0e-9) {
+				if (dpD[i<<1] < dpD0[i<<1]+0.5)
+					continue;
+				lit=(ipVar[i] << 1) | 1; // x_j=1
+			}
+			else
+				continue;
+			if (dpD0[i<<1] != 0.0 || dpD0[(i<<1)+1] != 1.0 || len == m_iMaxLen) {
+				++m_iFailNum;
+				return -1;
+			}
+			ipLit[len++]=lit;
+		}
+		if (!len)
+			return -2;
+		return addConflict(len,ipLit);
+	}
+
+	/**
+	 * The function adds a conflict to the pool.
+	 * \param[in] len number of literals;
+	 * \param[in,out] ipLit list of `len` literals, on output it is sorted.
+	 * \return index of the new conflict, or `-1` if the conflict is a duplicate or the pool is full.
+	 */
+	int addConflict(int len, int* ipLit)
+	{
+		if (len > m_iMaxLen) {
+			++m_iFailNum;
+			return -1;
+		}
+		for (int i=1; i < len; ++i) { // conflicts are short
+			int lit=ipLit[i], k=i;
+			for (; k > 0 && ipLit[k-1] > lit; --k)
+				ipLit[k]=ipLit[k-1];
+			ipLit[k]=lit;
+		}
+		unsigned h=hash(len,ipLit);
+		int c=-1;
+#ifndef __ONE_THREAD_
+		_RWLOCK* pLock=&m_rwLock;
+		_RWLOCK_WRLOCK(pLock)
+#endif
+		if (!find(h,len,ipLit)) {
+			if (m_iNum < m_iMaxNum && m_ipStart[m_iNum]+len <= m_iLitCap) {
+				c=m_iNum;
+				memcpy(m_ipLit+m_ipStart[c],ipLit,len*sizeof(int));
+				m_ipHash[c]=h;
+				int b=static_cast<int>(h & static_cast<unsigned>(m_iBucketNum-1));
+				m_ipNext[c]=m_ipBucket[b];
+				m_ipBucket[b]=c;
+				m_ipStart[c+1]=m_ipStart[c]+len;
+				m_iNum=c+1;
+			}
+			else
+				++m_iFailNum;
+		}
+		else
+			++m_iDupNum;
+#ifndef __ONE_THREAD_
+		_RWLOCK_UNLOCK_WRLOCK(pLock)
+#endif
+		return c;
+	}
+
+	/**
+	 * The function fixes binary variables implied by stored conflicts. A conflict with all literals
+	 * but one satisfied by the node bounds forces the remaining literal to be false;
+	 * the procedure is repeated until no variable is fixed.
+	 * \param[in,out] dpD array of size `2*m_iVarNum`: `dpD[j<<1]` and `dpD[(j<<1)+1]` are lower and upper bounds of variable `j`;
+	 * \param[out] ipFixed if not `0`, list of variables fixed by the function.
+	 * \return number of fixed variables, or `-1` if all literals of some conflict are satisfied (the node can be pruned).
+	 */
+	int propagate(double* dpD, int* ipFixed=0)
+	{
+		int fixNum=0;
+#ifndef __ONE_THREAD_
+		_RWLOCK* pLock=&m_rwLock;
+		_RWLOCK_RDLOCK(pLock)
+#endif
+		for (bool bChange=true; bChange; ) {
+			bChange=false;
+			for (int c=0; c < m_iNum; ++c) {
+				int free=-1, i=m_ipStart[c], last=m_ipStart[c+1];
+				for (; i < last; ++i) {
+					int lit=m_ipLit[i], j=lit >> 1;
+					double v=lit & 1;
+					if (dpD[j<<1] == v && dpD[(j<<1)+1] == v)
+						continue; // literal is satisfied
+					if (dpD[j<<1] > v || dpD[(j<<1)+1] < v || free >= 0)
+						break; // literal is violated, or two literals are not fixed
+					free=lit;
+				}
+				if (i < last)
+					continue;
+				if (free < 0) {
+					fixNum=-1;
+					bChange=false;
+					break;
+				}
+				int j=free >> 1;
+				dpD[(j<<1)+(free & 1)]=(free & 1)? 0.0: 1.0; // x_j != v
+				if (ipFixed)
+					ipFixed[fixNum]=j;
+				++fixNum;
+				bChange=true;
+			}
+		}
+#ifndef __ONE_THREAD_
+		_RWLOCK_UNLOCK_RDLOCK(pLock)
+#endif
+		if (fixNum < 0)
+			++m_iPruneNum;
+		else
+			m_iFixNum+=fixNum;
+		return fixNum;
+	}
+
+	/**
+	 * The function writes conflict `c` as the inequality `sum(i in 0..sz-1) dpVal[i]*x(ipCol[i]) <= rhs`,
+	 * where `sz` is return value.
+	 * \param[in] c conflict index;
+	 * \param[out] dpVal,ipCol arrays of size at least `m_iMaxLen`;
+	 * \param[out] rhs right hand side.
+	 * \return number of entries.
+	 */
+	int getRow(int c, double* dpVal, int* ipCol, double &rhs) const
+	{
+		int sz=0;
+		rhs=-1.0;
+		for (int i=m_ipStart[c]; i < m_ipStart[c+1]; ++i, ++sz) {
+			int lit=m_ipLit[i];
+			ipCol[sz]=lit >> 1;
+			if (lit & 1) {
+				dpVal[sz]=1.0;
+				rhs+=1.0;
+			}
+			else
+				dpVal[sz]=-1.0;
+		}
+		return sz;
+	}
+
+private:
+	void clear()
+	{
+		if (m_ipStart) {
+			delete[] m_ipStart;
+			m_ipStart=0;
+		}
+		if (m_ipLit) {
+			delete[] m_ipLit;
+			m_ipLit=0;
+		}
+		if (m_ipHash) {
+			delete[] m_ipHash;
+			m_ipHash=0;
+		}
+		if (m_ipNext) {
+			delete[] m_ipNext;
+			m_ipNext=0;
+		}
+		if (m_ipBucket) {
+			delete[] m_ipBucket;
+			m_ipBucket=0;
+		}
+	}
+
+	/**
+	 * \return FNV-1a hash of `len` literals from `ipLit`.
+	 */
+	static unsigned hash(int len, const int* ipLit)
+	{
+		unsigned h=2166136261u;
+		for (int i=0; i < len; ++i) {
+			h^=static_cast<unsigned>(ipLit[i]);
+			h*=16777619u;
+		}
+		return h;
+	}
+
+	/**
+	 * Only the conflicts in the hash bucket of `h` are compared with `ipLit`.
+	 * \return `true` if a conflict with sorted literals `ipLit` is already in the pool; the caller must hold `m_rwLock`.
+	 */
+	bool find(unsigned h, int len, const int* ipLit) const
+	{
+		for (int c=m_ipBucket[h & static_cast<unsigned>(m_iBucketNum-1)]; c >= 0; c=m_ipNext[c])
+			if (m_ipHash[c] == h && m_ipStart[c+1]-m_ipStart[c] == len &&
+				!memcmp(m_ipLit+m_ipStart[c],ipLit,len*sizeof(int)))
+				return true;
+		return false;
+	}
+};
+
+#endif // __CONFLICT_H_
@@ -0,0 +1,299 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file cutBuffer.h Interface for `CCutBuffer` class
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __CUTBUFFER_H_
+#define __CUTBUFFER_H_
+
+#include <cmath>
+#include <cstring>
+#include <new>
+#include "except.h"
+#include "lp.h"
+
+/// Buffer of cuts.
+/**
+ * A separator writes cuts into a buffer instead of calling `CMIP::addCut()` directly,
+ * so that several separators can run concurrently, each with its own buffer,
+ * and the cuts can be filtered before they are added to the matrix.
+ * A cut is stored as \f$b_1\le \sum_{i=1}^{sz} a_i x_{c_i}\le b_2\f$ together with
+ * its type and handle (the arguments of `CMIP::addCut()`); its entries are sorted by columns.
+ * Memory grows as needed; `reset()` empties the buffer but keeps its memory.
+ */
+class CCutBuffer
+{
+	int m_iCutNum; ///< number of cuts.
+	int m_iCutCap; ///< maximum number of cuts before memory is reallocated.
+	int m_iNzCap; ///< maximum number of entries before memory is reallocated.
+	int* m_ipStart; ///< entries of cut `k` are `m_ipStart[k],...,m_ipStart[k+1]-1`.
+	int* m_ipCol; ///< columns of entries.
+	double* m_dpVal; ///< coefficients of entries.
+	double* m_dpB; ///< `m_dpB[k<<1]` and `m_dpB[(k<<1)+1]` are left and right hand sides of cut `k`.
+	unsigned* m_ipType; ///< types of cuts.
+	CLP::tagHANDLE* m_ipHd; ///< handles of cuts.
+
+public:
+	/**
+	 * The constructor.
+	 * \param[in] cutCap,nzCap initial numbers of cuts and entries the buffer can store.
+	 * \throws CMemoryException lack of memory.
+	 */
+	CCutBuffer(int cutCap=64, int nzCap=1024): m_iCutNum(0), m_iCutCap((cutCap > 0)? cutCap: 1), m_iNzCap((nzCap > 0)? nzCap: 1),
+		m_ipStart(0), m_ipCol(0), m_dpVal(0), m_dpB(0), m_ipType(0), m_ipHd(0)
+	{
+		if (!(m_ipStart = new(std::nothrow) int[m_iCutCap+1]) ||
+			!(m_dpB = new(std::nothrow) double[m_iCutCap<<1]) ||
+			!(m_ipType = new(std::nothrow) unsigned[m_iCutCap]) ||
+			!(m_ipHd = new(std::nothrow) CLP::tagHANDLE[m_iCutCap]) ||
+			!(m_ipCol = new(std::nothrow) int[m_iNzCap]) ||
+			!(m_dpVal = new(std::nothrow) double[m_iNzCap])) {
+			clear();
+			throw new CMemoryException("CCutBuffer::CCutBuffer");
+		}
+		m_ipStart[0]=0;
+	}
+
+	~CCutBuffer()
+		{clear();} ///< The destructor.
+
+	void reset()
+		{m_iCutNum=0;} ///< The function removes all cuts from the buffer.
+
+	int getCutNum() const
+		{return m_iCutNum;} ///< \return number of cuts in the buffer.
+
+	/**
+	 * The function adds a cut to the buffer.
+	 * \param[in] hd handle of the cut (see `CMIP::addCut()`);
+	 * \param[in] type type of the cut;
+	 * \param[in] b1,b2 left and right hand sides;
+	 * \param[in] sz number of nonzero entries;
+	 * \param[in] dpVal,ipCol arrays of size `sz`, `dpVal[i]` is coefficient in column `ipCol[i]`.
+	 * \return index of the cut in the buffer.
+	 * \throws CMemoryException lack of memory.
+	 */
+	int add(CLP::tagHANDLE hd, unsigned type, double b1, double b2, int sz, const double* dpVal, const int* ipCol)
+	{
+		if (m_iCutNum == m_iCutCap)
+			growCuts();
+		int start=m_ipStart[m_iCutNum];
+		if (start+sz > m_iNzCap)
+			growEntries(start+sz);
+		memcpy(m_ipCol+start,ipCol,sz*sizeof(int));
+		memcpy(m_dpVal+start,dpVal,sz*sizeof(double));
+		sortEntries(sz,m_ipCol+start,m_dpVal+start);
+		int k=m_iCutNum++;
+		m_ipStart[m_iCutNum]=start+sz;
+		m_dpB[k<<1]=b1;
+		m_dpB[(k<<1)+1]=b2;
+		m_ipType[k]=type;
+		m_ipHd[k]=hd;
+		return k;
+	}
+
+	/**
+	 * \param[in] k cut index.
+	 * \param[out] hd,type handle and type of cut `k`;
+	 * \param[out] b1,b2 left and right hand sides;
+	 * \param[out] dpVal,ipCol pointers to coefficients and columns of cut `k`; they remain valid until the next call to `add()`.
+	 * \return number of nonzero entries in cut `k`.
+	 */
+	int getCut(int k, CLP::tagHANDLE &hd, unsigned &type, double &b1, double &b2, double* &dpVal, int* &ipCol) const
+	{
+		int start=m_ipStart[k];
+		hd=m_ipHd[k];
+		type=m_ipType[k];
+		b1=m_dpB[k<<1];
+		b2=m_dpB[(k<<1)+1];
+		dpVal=m_dpVal+start;
+		ipCol=m_ipCol+start;
+		return m_ipStart[k+1]-start;
+	}
+
+	/**
+	 * \param[in] k cut index.
+	 * \return number of nonzero entries in cut `k`.
+	 */
+	int getCutSize(int k) const
+		{return m_ipStart[k+1]-m_ipStart[k];}
+
+	/**
+	 * \param[in] k cut index.
+	 * \return hash value of cut `k`, which does not change if the cut is multiplied by a positive number.
+	 */
+	unsigned hash(int k) const
+	{
+		double scale=maxAbs(k);
+		unsigned h=2166136261u;
+		for (int e=m_ipStart[k]; e < m_ipStart[k+1]; ++e) {
+			h=(h ^ static_cast<unsigned>(m_ipCol[e]))*16777619u;
+			h=(h ^ static_cast<unsigned>(static_cast<long long>(floor(m_dpVal[e]/scale*1.0e6+0.5))))*16777619u;
+		}
+		for (int s=0; s < 2; ++s) {
+			double b=m_dpB[(k<<1)+s];
+			long long q=(fabs(b) >= CLP::INF)? ((b > 0.0)? (1ll << 40): -(1ll << 40)): static_cast<long long>(floor(b/scale*1.0e6+0.5));
+			h=(h ^ static_cast<unsigned>(q))*16777619u;
+		}
+		return h;
+	}
+
+	/**
+	 * \param[in] k cut index in this buffer;
+	 * \param[in] other buffer;
+	 * \param[in] l cut index in `other`.
+	 * \return `true` if cut `k` is a positive multiple of cut `l` of `other` (within a relative tolerance of `1.0e-9`).
+	 */
+	bool isParallel(int k, const CCutBuffer &other, int l) const
+	{
+		int sz=getCutSize(k);
+		if (sz != other.getCutSize(l))
+			return false;
+		double s1=maxAbs(k), s2=other.maxAbs(l);
+		const int *ipCol1=m_ipCol+m_ipStart[k], *ipCol2=other.m_ipCol+other.m_ipStart[l];
+		const double *dpVal1=m_dpVal+m_ipStart[k], *dpVal2=other.m_dpVal+other.m_ipStart[l];
+		for (int i=0; i < sz; ++i)
+			if (ipCol1[i] != ipCol2[i] || fabs(dpVal1[i]/s1-dpVal2[i]/s2) > 1.0e-9)
+				return false;
+		for (int s=0; s < 2; ++s) {
+			double b1=m_dpB[(k<<1)+s], b2=other.m_dpB[(l<<1)+s];
+			bool inf1=(fabs(b1) >= CLP::INF), inf2=(fabs(b2) >= CLP::INF);
+			if (inf1 != inf2 || (!inf1 && fabs(b1/s1-b2/s2) > 1.0e-9*(1.0+fabs(b1/s1))))
+				return false;
+		}
+		return true;
+	}
+
+	/**
+	 * \param[in] k cut index.
+	 * \return maximum absolute value of coefficients of cut `k` (`1` if the cut is empty).
+	 */
+	double maxAbs(int k) const
+	{
+		double s=0.0;
+		for (int e=m_ipStart[k]; e < m_ipStart[k+1]; ++e)
+			if (fabs(m_dpVal[e]) > s)
+				s=fabs(m_dpVal[e]);
+		return (s > 0.0)? s: 1.0;
+	}
+
+private:
+	void clear()
+	{
+		delete[] m_ipStart;
+		delete[] m_ipCol;
+		delete[] m_dpVal;
+		delete[] m_dpB;
+		delete[] m_ipType;
+		delete[] m_ipHd;
+		m_ipStart=m_ipCol=0;
+		m_dpVal=m_dpB=0;
+		m_ipType=0;
+		m_ipHd=0;
+	}
+
+	/**
+	 * The function doubles the maximum number of cuts.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void growCuts()
+	{
+		int cap=m_iCutCap<<1;
+		int* ipStart=new(std::nothrow) int[cap+1];
+		double* dpB=new(std::nothrow) double[cap<<1];
+		unsigned* ipType=new(std::nothrow) unsigned[cap];
+		CLP::tagHANDLE* ipHd=new(std::nothrow) CLP::tagHANDLE[cap];
+		if (!ipStart || !dpB || !ipType || !ipHd) {
+			delete[] ipStart;
+			delete[] dpB;
+			delete[] ipType;
+			delete[] ipHd;
+			throw new CMemoryException("CCutBuffer::growCuts");
+		}
+		memcpy(ipStart,m_ipStart,(m_iCutNum+1)*sizeof(int));
+		memcpy(dpB,m_dpB,(m_iCutNum<<1)*sizeof(double));
+		memcpy(ipType,m_ipType,m_iCutNum*sizeof(unsigned));
+		memcpy(ipHd,m_ipHd,m_iCutNum*sizeof(CLP::tagHANDLE));
+		delete[] m_ipStart;
+		delete[] m_dpB;
+		delete[] m_ipType;
+		delete[] m_ipHd;
+		m_ipStart=ipStart;
+		m_dpB=dpB;
+		m_ipType=ipType;
+		m_ipHd=ipHd;
+		m_iCutCap=cap;
+	}
+
+	/**
+	 * The function reallocates memory for at least `nz` entries.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void growEntries(int nz)
+	{
+		int cap=m_iNzCap<<1;
+		if (cap < nz)
+			cap=nz;
+		int* ipCol=new(std::nothrow) int[cap];
+		double* dpVal=new(std::nothrow) double[cap];
+		if (!ipCol || !dpVal) {
+			delete[] ipCol;
+			delete[] dpVal;
+			throw new CMemoryException("CCutBuffer::growEntries");
+		}
+		int used=m_ipStart[m_iCutNum];
+		memcpy(ipCol,m_ipCol,used*sizeof(int));
+		memcpy(dpVal,m_dpVal,used*sizeof(double));
+		delete[] m_ipCol;
+		delete[] m_dpVal;
+		m_ipCol=ipCol;
+		m_dpVal=dpVal;
+		m_iNzCap=cap;
+	}
+
+	/**
+	 * The function sorts entries by columns (Shell sort).
+	 */
+	static void sortEntries(int sz, int* ipCol, double* dpVal)
+	{
+		int gap=1;
+		while (gap < sz/3)
+			gap=3*gap+1;
+		for (; gap > 0; gap/=3) {
+			for (int i=gap; i < sz; ++i) {
+				int c=ipCol[i], k=i;
+				double v=dpVal[i];
+				for (; k >= gap && ipCol[k-gap] > c; k-=gap) {
+					ipCol[k]=ipCol[k-gap];
+					dpVal[k]=dpVal[k-gap];
+				}
+				ipCol[k]=c;
+				dpVal[k]=v;
+			}
+		}
+	}
+};
+
+#endif // __CUTBUFFER_H_
@@ -0,0 +1,285 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file cutHash.h Interface for `CCutHashSet` class
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __CUTHASH_H_
+#define __CUTHASH_H_
+
+#include <new>
+#include "except.h"
+#include "lp.h"
+#include "cutBuffer.h"
+
+/// Hash set of cuts.
+/**
+ * Comparing a new cut with every cut already generated costs time proportional
+ * to the total size of all cuts. `CCutHashSet` stores cuts as they are given (with entries sorted by columns),
+ * so that `getBuffer()` returns the original cuts. Only `CCutBuffer::hash()` and `CCutBuffer::isParallel()`
+ * divide coefficients and sides by the maximum absolute coefficient; so a cut and its positive multiples
+ * have the same hash value, and checking whether a cut is a positive multiple of a stored cut
+ * takes time proportional to the cut size. The hash value does not depend on the cut type and handle.
+ *
+ * Cuts are identified by indices returned by `insert()`. An erased cut is unlinked from its hash chain
+ * but its memory is reused only after `reset()`, so indices of the other cuts do not change.
+ *
+ * The set is not protected by a mutex; a set shared by several threads must be protected by its user.
+ */
+class CCutHashSet
+{
+	CCutBuffer* m_pCuts; ///< stored cuts.
+	CCutBuffer* m_pQuery; ///< cut being looked up (with entries sorted by columns).
+	int m_iCap; ///< size of `m_ipNext` and `m_ipHash`.
+	int* m_ipNext; ///< `m_ipNext[k]` is next cut in the hash chain of cut `k`, `-1` at the chain end, or `-2` if cut `k` has been erased.
+	unsigned* m_ipHash; ///< `m_ipHash[k]` is hash value of cut `k`.
+	int m_iBucketNum; ///< number of hash buckets (a power of `2`).
+	int* m_ipBucket; ///< `m_ipBucket[h]` is first cut in bucket `h`, or `-1`.
+	int m_iSize; ///< number of cuts not erased.
+	int m_iHitNum; ///< number of lookups that found a stored cut.
+
+public:
+	/**
+	 * The constructor.
+	 * \param[in] cutCap initial number of cuts the set can store.
+	 * \throws CMemoryException lack of memory.
+	 */
+	CCutHashSet(int cutCap=256): m_pCuts(0), m_pQuery(0), m_iCap(0), m_ipNext(0), m_ipHash(0),
+		m_iBucketNum(0), m_ipBucket(0), m_iSize(0), m_iHitNum(0)
+	{
+		try {
+			m_pCuts=new CCutBuffer(cutCap,cutCap<<4);
+			m_pQuery=new CCutBuffer(1);
+			allocMem((cutCap > 0)? cutCap: 1);
+		}
+		catch(CException* pe) {
+			clear();
+			throw pe;
+		}
+	}
+
+	~CCutHashSet()
+		{clear();} ///< The destructor.
+
+	/**
+	 * The function removes all cuts from the set but keeps its memory.
+	 */
+	void reset()
+	{
+		m_pCuts->reset();
+		m_iSize=0;
+		for (int h=0; h < m_iBucketNum; ++h)
+			m_ipBucket[h]=-1;
+	}
+
+	int getSize() const
+		{return m_iSize;} ///< \return number of cuts in the set.
+	int getHitNum() const
+		{return m_iHitNum;} ///< \return number of lookups that found a stored cut.
+
+	/**
+	 * \return buffer of stored cuts; index `k` returned by `insert()` is the index of the cut in this buffer.
+	 * The buffer also contains erased cuts (see `isErased()`).
+	 */
+	const CCutBuffer& getBuffer() const
+		{return *m_pCuts;}
+
+	/**
+	 * \param[in] k index returned by `insert()`.
+	 * \return `true` if cut `k` has been erased.
+	 */
+	bool isErased(int k) const
+		{return m_ipNext[k] == -2;}
+
+	/**
+	 * The function looks up a cut.
+	 * \param[in] b1,b2 left and right hand sides;
+	 * \param[in] sz number of nonzero entries;
+	 * \param[in] dpVal,ipCol arrays of size `sz`, `dpVal[i]` is coefficient in column `ipCol[i]`.
+	 * \return index of a stored cut of which the given cut is a positive multiple, or `-1`.
+	 * \throws CMemoryException lack of memory.
+	 */
+	int find(double b1, double b2, int sz, const double* dpVal, const int* ipCol)
+	{
+		setQuery(0,0,b1,b2,sz,dpVal,ipCol);
+		return find(*m_pQuery,0,m_pQuery->hash(0));
+	}
+
+	/**
+	 * \param[in] buf buffer;
+	 * \param[in] k cut index in `buf`.
+	 * \return index of a stored cut of which cut `k` of `buf` is a positive multiple, or `-1`.
+	 */
+	int find(const CCutBuffer &buf, int k)
+		{return find(buf,k,buf.hash(k));}
+
+	/**
+	 * The function adds a cut to the set unless it is a positive multiple of a stored cut.
+	 * \param[in] hd handle of the cut;
+	 * \param[in] type type of the cut;
+	 * \param[in] b1,b2 left and right hand sides;
+	 * \param[in] sz number of nonzero entries;
+	 * \param[in] dpVal,ipCol arrays of size `sz`, `dpVal[i]` is coefficient in column `ipCol[i]`.
+	 * \return index of the inserted cut, or `-1` if the cut is already in the set.
+	 * \throws CMemoryException lack of memory.
+	 */
+	int insert(CLP::tagHANDLE hd, unsigned type, double b1, double b2, int sz, const double* dpVal, const int* ipCol)
+	{
+		setQuery(hd,type,b1,b2,sz,dpVal,ipCol);
+		return insert(*m_pQuery,0);
+	}
+
+	/**
+	 * The function adds cut `k` of `buf` to the set unless it is a positive multiple of a stored cut.
+	 * \param[in] buf buffer;
+	 * \param[in] k cut index in `buf`.
+	 * \return index of the inserted cut, or `-1` if the cut is already in the set.
+	 * \throws CMemoryException lack of memory.
+	 */
+	int insert(const CCutBuffer &buf, int k)
+	{
+		unsigned h=buf.hash(k);
+		if (find(buf,k,h) >= 0)
+			return -1;
+		int num=m_pCuts->getCutNum();
+		if (num == m_iCap)
+			allocMem(m_iCap<<1);
+		CLP::tagHANDLE hd;
+		unsigned type;
+		double b1, b2, *dpVal;
+		int *ipCol, sz=buf.getCut(k,hd,type,b1,b2,dpVal,ipCol);
+		int c=m_pCuts->add(hd,type,b1,b2,sz,dpVal,ipCol);
+		m_ipHash[c]=h;
+		int b=static_cast<int>(h & static_cast<unsigned>(m_iBucketNum-1));
+		m_ipNext[c]=m_ipBucket[b];
+		m_ipBucket[b]=c;
+		++m_iSize;
+		return c;
+	}
+
+	/**
+	 * The function removes a cut from the set (for example, when the cut has been deleted from the matrix).
+	 * \param[in] k index returned by `insert()`.
+	 */
+	void erase(int k)
+	{
+		if (m_ipNext[k] == -2)
+			return;
+		int *ip=m_ipBucket+(m_ipHash[k] & static_cast<unsigned>(m_iBucketNum-1));
+		while (*ip != k)
+			ip=m_ipNext+*ip;
+		*ip=m_ipNext[k];
+		m_ipNext[k]=-2;
+		--m_iSize;
+	}
+
+private:
+	void clear()
+	{
+		if (m_pCuts) {
+			delete m_pCuts;
+			m_pCuts=0;
+		}
+		if (m_pQuery) {
+			delete m_pQuery;
+			m_pQuery=0;
+		}
+		delete[] m_ipNext;
+		delete[] m_ipHash;
+		delete[] m_ipBucket;
+		m_ipNext=m_ipBucket=0;
+		m_ipHash=0;
+		m_iCap=m_iBucketNum=0;
+	}
+
+	/**
+	 * The function writes a cut into `m_pQuery`, which sorts its entries by columns.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void setQuery(CLP::tagHANDLE hd, unsigned type, double b1, double b2, int sz, const double* dpVal, const int* ipCol)
+	{
+		m_pQuery->reset();
+		m_pQuery->add(hd,type,b1,b2,sz,dpVal,ipCol);
+	}
+
+	/**
+	 * \param[in] buf buffer;
+	 * \param[in] k cut index in `buf`;
+	 * \param[in] h hash value of cut `k`.
+	 * \return index of a stored cut of which cut `k` of `buf` is a positive multiple, or `-1`.
+	 */
+	int find(const CCutBuffer &buf, int k, unsigned h)
+	{
+		for (int c=m_ipBucket[h & static_cast<unsigned>(m_iBucketNum-1)]; c >= 0; c=m_ipNext[c])
+			if (m_ipHash[c] == h && buf.isParallel(k,*m_pCuts,c)) {
+				++m_iHitNum;
+				return c;
+			}
+		return -1;
+	}
+
+	/**
+	 * The function enlarges the arrays to store `cap` cuts, and rehashes stored cuts
+	 * so that the load factor of the hash table does not exceed `1`.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void allocMem(int cap)
+	{
+		int bucketNum=1;
+		while (bucketNum < cap)
+			bucketNum<<=1;
+		int* ipNext=new(std::nothrow) int[cap];
+		unsigned* ipHash=new(std::nothrow) unsigned[cap];
+		int* ipBucket=new(std::nothrow) int[bucketNum];
+		if (!ipNext || !ipHash || !ipBucket) {
+			delete[] ipNext;
+			delete[] ipHash;
+			delete[] ipBucket;
+			throw new CMemoryException("CCutHashSet::allocMem");
+		}
+		for (int h=0; h < bucketNum; ++h)
+			ipBucket[h]=-1;
+		int num=m_pCuts->getCutNum();
+		for (int c=num-1; c >= 0; --c) {
+			ipHash[c]=m_ipHash[c];
+			if (m_ipNext[c] == -2)
+				ipNext[c]=-2;
+			else {
+				int b=static_cast<int>(ipHash[c] & static_cast<unsigned>(bucketNum-1));
+				ipNext[c]=ipBucket[b];
+				ipBucket[b]=c;
+			}
+		}
+		delete[] m_ipNext;
+		delete[] m_ipHash;
+		delete[] m_ipBucket;
+		m_ipNext=ipNext;
+		m_ipHash=ipHash;
+		m_ipBucket=ipBucket;
+		m_iCap=cap;
+		m_iBucketNum=bucketNum;
+	}
+};
+
+#endif // __CUTHASH_H_
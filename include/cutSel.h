@@ -0,0 +1,351 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file cutSel.h Interface for `CCutSelector` class
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __CUTSEL_H_
+#define __CUTSEL_H_
+
+#include <cmath>
+#include <new>
+#include "except.h"
+#include "Sort.h"
+#include "cutBuffer.h"
+
+/// Selection of cuts by efficacy, objective parallelism, orthogonality, and density.
+/**
+ * For a cut \f$b_1\le a^Tx\le b_2\f$ and an LP solution \f$x^*\f$:
+ *   - _efficacy_ is the Euclidean distance from \f$x^*\f$ to the violated hyperplane,
+ *     \f$\max\{a^Tx^*-b_2,\, b_1-a^Tx^*\}/\|a\|\f$;
+ *   - _objective parallelism_ is \f$|a^Tc|/(\|a\|\,\|c\|)\f$;
+ *   - _density_ is the fraction of nonzero coefficients.
+ *
+ * Cuts with small efficacy or high density are rejected, and the others are scored by
+ * \f$w_e\cdot\mathrm{efficacy} + w_o\cdot\mathrm{parallelism} + w_d\cdot(1-\mathrm{density})\f$.
+ * Then cuts are taken greedily in order of decreasing score, and a cut is rejected if the absolute value of the cosine of the angle between it
+ * and an already selected cut exceeds `maxParallelism`, or if `maxCutNum` cuts have been selected.
+ * Numbers of rejected cuts are accumulated by reason (see `enReject`).
+ *
+ * The cosine is computed by scattering the normalized candidate into a dense array once,
+ * and gathering it along each selected cut; the gather loop keeps four independent sums,
+ * so that compilers can vectorize it.
+ */
+class CCutSelector
+{
+public:
+	/// Reasons for rejecting cuts.
+	enum enReject {
+		NOT_EFFICACIOUS=0, ///< efficacy is less than the minimum.
+		TOO_DENSE=1, ///< density exceeds the maximum.
+		PARALLEL=2, ///< nearly parallel to a selected cut.
+		LIMIT=3, ///< maximum number of cuts has been selected.
+		REJECT_NUM=4 ///< number of reasons.
+	};
+
+private:
+	int m_iN; ///< maximum number of columns.
+	double m_dWeightEff; ///< weight of efficacy.
+	double m_dWeightObj; ///< weight of objective parallelism.
+	double m_dWeightDens; ///< weight of sparsity.
+	double m_dMinEfficacy; ///< cuts with smaller efficacy are rejected.
+	double m_dMaxParallelism; ///< maximum absolute value of the cosine between two selected cuts.
+	double m_dMaxDensity; ///< cuts with larger density are rejected.
+	int m_iMaxCutNum; ///< maximum number of cuts selected in one call to `select()`.
+	double* m_dpC; ///< objective normalized to unit length, or `0`.
+	double* m_dpDense; ///< dense work array of size `m_iN`, all zeroes between calls.
+	int m_iCap; ///< size of arrays indexed by cuts.
+	double* m_dpScore; ///< scores of cuts.
+	double* m_dpNorm; ///< norms of cuts.
+	int* m_ipOrder; ///< cuts in order of decreasing score.
+	int* m_ipSel; ///< selected cuts.
+	int m_iSelNum; ///< number of cuts selected in the last call to `select()`.
+	int m_iCandNum; ///< total number of candidates.
+	int m_iTotalSelNum; ///< total number of selected cuts.
+	int m_ipRejectNum[REJECT_NUM]; ///< numbers of rejected cuts by reasons.
+
+public:
+	/**
+	 * The constructor.
+	 * \param[in] n maximum number of columns.
+	 * \throws CMemoryException lack of memory.
+	 */
+	CCutSelector(int n): m_iN(n), m_dWeightEff(1.0), m_dWeightObj(0.1), m_dWeightDens(0.1),
+		m_dMinEfficacy(1.0e-4), m_dMaxParallelism(0.9), m_dMaxDensity(1.0), m_iMaxCutNum(100),
+		m_dpC(0), m_dpDense(0), m_iCap(0), m_dpScore(0), m_dpNorm(0), m_ipOrder(0), m_ipSel(0),
+		m_iSelNum(0), m_iCandNum(0), m_iTotalSelNum(0)
+	{
+		if (!(m_dpDense = new(std::nothrow) double[n]))
+			throw new CMemoryException("CCutSelector::CCutSelector");
+		for (int j=0; j < n; ++j)
+			m_dpDense[j]=0.0;
+		resetStat();
+	}
+
+	~CCutSelector()
+		{clear();} ///< The destructor.
+
+	/**
+	 * \param[in] eff,obj,dens weights of efficacy, objective parallelism, and sparsity in the score.
+	 */
+	void setWeights(double eff, double obj, double dens)
+	{
+		m_dWeightEff=eff;
+		m_dWeightObj=obj;
+		m_dWeightDens=dens;
+	}
+
+	/**
+	 * \param[in] minEff cuts with efficacy less than `minEff` are rejected.
+	 */
+	void setMinEfficacy(double minEff)
+		{m_dMinEfficacy=minEff;}
+
+	/**
+	 * \param[in] maxPar a cut is rejected if the absolute value of the cosine of the angle between it and a selected cut exceeds `maxPar`.
+	 */
+	void setMaxParallelism(double maxPar)
+		{m_dMaxParallelism=maxPar;}
+
+	/**
+	 * \param[in] maxDens cuts with more than `maxDens*n` nonzeroes are rejected.
+	 */
+	void setMaxDensity(double maxDens)
+		{m_dMaxDensity=maxDens;}
+
+	/**
+	 * \param[in] maxNum maximum number of cuts selected in one call to `select()`.
+	 */
+	void setMaxCutNum(int maxNum)
+		{m_iMaxCutNum=maxNum;}
+
+	/**
+	 * The function sets the objective used to compute objective parallelism.
+	 * \param[in] n number of columns;
+	 * \param[in] dpC array of size `n`, `dpC[j]` is objective coefficient of column `j`; if `0`, parallelism is not scored.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void setObjective(int n, const double* dpC)
+	{
+		if (!dpC) {
+			delete[] m_dpC;
+			m_dpC=0;
+			return;
+		}
+		if (!m_dpC && !(m_dpC = new(std::nothrow) double[m_iN]))
+			throw new CMemoryException("CCutSelector::setObjective");
+		double norm=0.0;
+		for (int j=0; j < n; ++j)
+			norm+=dpC[j]*dpC[j];
+		norm=(norm > 0.0)? 1.0/sqrt(norm): 0.0;
+		for (int j=0; j < m_iN; ++j)
+			m_dpC[j]=(j < n)? dpC[j]*norm: 0.0;
+	}
+
+	/**
+	 * The function selects cuts.
+	 * \param[in] buf buffer with candidate cuts;
+	 * \param[in] n number of columns;
+	 * \param[in] dpX array of size `n`, LP solution.
+	 * \return number of selected cuts.
+	 * \throws CMemoryException lack of memory.
+	 */
+	int select(const CCutBuffer &buf, int n, const double* dpX)
+	{
+		int num=buf.getCutNum(), candNum=0;
+		allocMem(num);
+		m_iCandNum+=num;
+		m_iSelNum=0;
+		for (int k=0; k < num; ++k) {
+			CLP::tagHANDLE hd;
+			unsigned type;
+			double b1, b2, *dpVal;
+			int* ipCol;
+			int sz=buf.getCut(k,hd,type,b1,b2,dpVal,ipCol);
+			double norm=sqrt(squaredNorm(sz,dpVal)), act=sparseDot(sz,dpVal,ipCol,dpX);
+			if (norm <= 0.0) {
+				++m_ipRejectNum[NOT_EFFICACIOUS];
+				continue;
+			}
+			double viol=0.0;
+			if (b2 < CLP::INF && act-b2 > viol)
+				viol=act-b2;
+			if (b1 > -CLP::INF && b1-act > viol)
+				viol=b1-act;
+			double eff=viol/norm, dens=(n > 0)? static_cast<double>(sz)/n: 1.0;
+			if (eff < m_dMinEfficacy) {
+				++m_ipRejectNum[NOT_EFFICACIOUS];
+				continue;
+			}
+			if (dens > m_dMaxDensity) {
+				++m_ipRejectNum[TOO_DENSE];
+				continue;
+			}
+			double score=m_dWeightEff*eff+m_dWeightDens*(1.0-dens);
+			if (m_dpC)
+				score+=m_dWeightObj*fabs(sparseDot(sz,dpVal,ipCol,m_dpC))/norm;
+			m_dpNorm[k]=norm;
+			m_dpScore[k]=score;
+			m_ipOrder[candNum++]=k;
+		}
+		SORT::decSortDouble(candNum,m_ipOrder,m_dpScore);
+		for (int t=0; t < candNum; ++t) {
+			if (m_iSelNum == m_iMaxCutNum) {
+				m_ipRejectNum[LIMIT]+=candNum-t;
+				break;
+			}
+			int k=m_ipOrder[t];
+			CLP::tagHANDLE hd;
+			unsigned type;
+			double b1, b2, *dpVal;
+			int* ipCol;
+			int sz=buf.getCut(k,hd,type,b1,b2,dpVal,ipCol);
+			double f=1.0/m_dpNorm[k];
+			for (int i=0; i < sz; ++i)
+				m_dpDense[ipCol[i]]=dpVal[i]*f;
+			bool ok=true;
+			for (int s=0; s < m_iSelNum && ok; ++s) {
+				int l=m_ipSel[s];
+				double *dpVal2;
+				int *ipCol2, sz2=buf.getCut(l,hd,type,b1,b2,dpVal2,ipCol2);
+				if (fabs(sparseDot(sz2,dpVal2,ipCol2,m_dpDense)/m_dpNorm[l]) > m_dMaxParallelism)
+					ok=false;
+			}
+			for (int i=0; i < sz; ++i)
+				m_dpDense[ipCol[i]]=0.0;
+			if (ok)
+				m_ipSel[m_iSelNum++]=k;
+			else
+				++m_ipRejectNum[PARALLEL];
+		}
+		m_iTotalSelNum+=m_iSelNum;
+		return m_iSelNum;
+	}
+
+	int getSelectedNum() const
+		{return m_iSelNum;} ///< \return number of cuts selected in the last call to `select()`.
+
+	/**
+	 * \param[in] k index in the list of selected cuts, `0 <= k < getSelectedNum()`.
+	 * \return index in the buffer of the `k`-th selected cut; selected cuts are listed in order of decreasing score.
+	 */
+	int getSelected(int k) const
+		{return m_ipSel[k];}
+
+	int getCandidateNum() const
+		{return m_iCandNum;} ///< \return total number of candidate cuts.
+	int getTotalSelectedNum() const
+		{return m_iTotalSelNum;} ///< \return total number of selected cuts.
+
+	/**
+	 * \param[in] reason reason for rejection.
+	 * \return total number of cuts rejected for `reason`.
+	 */
+	int getRejectNum(enReject reason) const
+		{return m_ipRejectNum[reason];}
+
+	/**
+	 * The function resets all statistics.
+	 */
+	void resetStat()
+	{
+		m_iCandNum=m_iTotalSelNum=0;
+		for (int r=0; r < REJECT_NUM; ++r)
+			m_ipRejectNum[r]=0;
+	}
+
+private:
+	void clear()
+	{
+		delete[] m_dpC;
+		delete[] m_dpDense;
+		delete[] m_dpScore;
+		delete[] m_dpNorm;
+		delete[] m_ipOrder;
+		delete[] m_ipSel;
+		m_dpC=m_dpDense=m_dpScore=m_dpNorm=0;
+		m_ipOrder=m_ipSel=0;
+	}
+
+	/**
+	 * The function allocates memory for `num` cuts.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void allocMem(int num)
+	{
+		if (num <= m_iCap)
+			return;
+		delete[] m_dpScore;
+		delete[] m_dpNorm;
+		delete[] m_ipOrder;
+		delete[] m_ipSel;
+		m_dpScore=m_dpNorm=0;
+		m_ipOrder=m_ipSel=0;
+		m_iCap=0;
+		if (!(m_dpScore = new(std::nothrow) double[num]) ||
+			!(m_dpNorm = new(std::nothrow) double[num]) ||
+			!(m_ipOrder = new(std::nothrow) int[num]) ||
+			!(m_ipSel = new(std::nothrow) int[num]))
+			throw new CMemoryException("CCutSelector::allocMem");
+		m_iCap=num;
+	}
+
+	/**
+	 * \param[in] sz,dpVal,ipCol sparse vector;
+	 * \param[in] dpDense dense vector.
+	 * \return dot product.
+	 */
+	static double sparseDot(int sz, const double* dpVal, const int* ipCol, const double* dpDense)
+	{
+		double s0=0.0, s1=0.0, s2=0.0, s3=0.0;
+		int i=0;
+		for (; i+3 < sz; i+=4) {
+			s0+=dpVal[i]*dpDense[ipCol[i]];
+			s1+=dpVal[i+1]*dpDense[ipCol[i+1]];
+			s2+=dpVal[i+2]*dpDense[ipCol[i+2]];
+			s3+=dpVal[i+3]*dpDense[ipCol[i+3]];
+		}
+		for (; i < sz; ++i)
+			s0+=dpVal[i]*dpDense[ipCol[i]];
+		return (s0+s1)+(s2+s3);
+	}
+
+	/**
+	 * \return squared norm of the sparse vector `(sz,dpVal)`.
+	 */
+	static double squaredNorm(int sz, const double* dpVal)
+	{
+		double s0=0.0, s1=0.0;
+		int i=0;
+		for (; i+1 < sz; i+=2) {
+			s0+=dpVal[i]*dpVal[i];
+			s1+=dpVal[i+1]*dpVal[i+1];
+		}
+		if (i < sz)
+			s0+=dpVal[i]*dpVal[i];
+		return s0+s1;
+	}
+};
+
+#endif // __CUTSEL_H_
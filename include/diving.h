@@ -0,0 +1,517 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file diving.h Interface for `CDivingPortfolio` class
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __DIVING_H_
+#define __DIVING_H_
+
+#include <cmath>
+#include <new>
+#include "except.h"
+#include "lp.h"
+#include "jobPool.h"
+#include "rowProp.h"
+#include "relBranch.h"
+
+/// Portfolio of diving heuristics run in parallel.
+/**
+ * A _dive_ repeatedly selects a fractional integer variable in the current LP solution,
+ * rounds its bound in some direction, and re-solves the LP, until the LP solution becomes
+ * integral (success), the LP becomes infeasible, or its objective value exceeds the cutoff.
+ * The dives differ in how the variable and the direction are selected:
+ *   - `FRACTIONAL`: least fractional variable, rounded to the nearest integer;
+ *   - `COEFFICIENT`: variable with fewest locks in the rounding direction
+ *      (a row _locks_ rounding up of `x_j` if it may be violated when `x_j` increases);
+ *   - `PSEUDOCOST`: direction and variable by pseudocosts taken from a `CPseudocostTable`;
+ *   - `GUIDED`: variable closest to its value in a guide (record) solution, rounded towards that value;
+ *   - `VECTOR_LENGTH`: the smallest objective deterioration per row covered (column length),
+ *      which suits set covering and partitioning models.
+ *
+ * Each worker dives on its own LP built by `newLp()` (usually a clone of the node LP, see `CLP::CLP(const CLP &other, int thread)`);
+ * bounds changed during a dive are restored when the dive ends. `runDives()` is meant to be called when threads are idle.
+ * The dives for a call are chosen by the UCB1 rule on their success rates, so effort shifts
+ * towards the dives that succeed on the given model, while the others are still tried from time to time.
+ *
+ * Variables are identified by indices; the handle of variable `j` must be `j` in every LP.
+ */
+class CDivingPortfolio: private CJobPool
+{
+public:
+	/// Diving rules.
+	enum enDive {
+		FRACTIONAL=0, ///< fractional diving.
+		COEFFICIENT=1, ///< coefficient (lock) diving.
+		PSEUDOCOST=2, ///< pseudocost diving.
+		GUIDED=3, ///< guided diving.
+		VECTOR_LENGTH=4, ///< vector length diving.
+		DIVE_NUM=5 ///< number of diving rules.
+	};
+
+private:
+	int m_iN; ///< number of variables.
+	const CRowPropagator* m_pModel; ///< model rows, integrality, and initial bounds.
+	CPseudocostTable* m_pPc; ///< pseudocosts, or `0`.
+	bool m_bSense; ///< `true` if the objective is maximized.
+	double* m_dpC; ///< objective of the minimization problem (negated if `m_bSense=true`).
+	int* m_ipLock; ///< `m_ipLock[2*j]` and `m_ipLock[2*j+1]` are numbers of rows that lock rounding down and up of `x_j`.
+	double* m_dpGuide; ///< guide solution, or `0`.
+	double m_dCutoff; ///< objective value (of the minimization problem) that dives must improve.
+	double m_dNewCutoff; ///< value passed to `setCutoff()` (in the sense of the problem); the sense is known only in `runDives()`.
+	bool m_bNewCutoff; ///< `true` if `m_dNewCutoff` has not yet been converted to `m_dCutoff`.
+	int m_iMaxDepth; ///< maximum number of bound changes in a dive.
+
+	CLP* m_ppLp[MAX_WORKER_NUM]; ///< `m_ppLp[w]` is LP of worker `w`.
+	double* m_dpX; ///< `m_dpX+w*m_iN` is LP solution of worker `w`.
+	double* m_dpWorkerSol; ///< `m_dpWorkerSol+w*m_iN` is the best solution found by worker `w`.
+	double m_dpWorkerObj[MAX_WORKER_NUM]; ///< objective value of the best solution of worker `w`.
+	int* m_ipTrail; ///< `m_ipTrail+w*m_iMaxDepth` lists variables whose bounds have been changed by worker `w`.
+	double* m_dpTrail; ///< `m_dpTrail+2*w*m_iMaxDepth` stores their old bounds.
+
+	int m_iJobCap; ///< size of `m_ipJobDive` and `m_ipJobRes`.
+	int* m_ipJobDive; ///< rule used by each job of the current call to `runDives()`.
+	int* m_ipJobRes; ///< result of each job: `0` - failure, `1` - solution not better than cutoff, `2` - improving solution.
+
+	int m_ipCallNum[DIVE_NUM]; ///< number of dives of each rule.
+	int m_ipSuccessNum[DIVE_NUM]; ///< number of dives of each rule that found feasible solutions.
+	int m_ipImproveNum[DIVE_NUM]; ///< number of dives of each rule that improved the cutoff.
+
+	bool m_bSolution; ///< `true` if a solution has been found.
+	double* m_dpSol; ///< best solution found.
+
+public:
+	/**
+	 * The constructor.
+	 * \param[in] pModel pointer to a propagator storing the problem rows (after `CRowPropagator::init()` has been called);
+	 * it gives integrality of variables, locks, and column lengths.
+	 * \param[in] maxDepth maximum number of bound changes in a dive.
+	 * \throws CMemoryException lack of memory.
+	 */
+	CDivingPortfolio(const CRowPropagator* pModel, int maxDepth=100):
+		m_iN(pModel->getVarNum()), m_pModel(pModel), m_pPc(0), m_bSense(false), m_dpC(0), m_ipLock(0), m_dpGuide(0),
+		m_dCutoff(CLP::INF), m_dNewCutoff(0.0), m_bNewCutoff(false), m_iMaxDepth((maxDepth > 0)? maxDepth: 1),
+		m_dpX(0), m_dpWorkerSol(0), m_ipTrail(0), m_dpTrail(0), m_iJobCap(0), m_ipJobDive(0), m_ipJobRes(0),
+		m_bSolution(false), m_dpSol(0)
+	{
+		for (int w=0; w < MAX_WORKER_NUM; ++w)
+			m_ppLp[w]=0;
+		for (int d=0; d < DIVE_NUM; ++d)
+			m_ipCallNum[d]=m_ipSuccessNum[d]=m_ipImproveNum[d]=0;
+		int n=m_iN;
+		if (!(m_dpC = new(std::nothrow) double[n]) ||
+			!(m_ipLock = new(std::nothrow) int[n<<1]) ||
+			!(m_dpSol = new(std::nothrow) double[n])) {
+			clear();
+			throw new CMemoryException("CDivingPortfolio::CDivingPortfolio");
+		}
+		for (int j=0; j < n; ++j) {
+			m_dpC[j]=0.0;
+			int down=0, up=0;
+			const int* ipEntry;
+			int sz=pModel->getColumn(j,ipEntry);
+			for (int k=0; k < sz; ++k) {
+				int e=ipEntry[k];
+				double lhs, rhs, a=pModel->getEntryVal(e);
+				const double* dpVal;
+				const int* ipCol;
+				pModel->getRow(pModel->getEntryRow(e),lhs,rhs,dpVal,ipCol);
+				if (rhs < CRowPropagator::INF) {
+					if (a > 0.0)
+						++up;
+					else
+						++down;
+				}
+				if (lhs > -CRowPropagator::INF) {
+					if (a > 0.0)
+						++down;
+					else
+						++up;
+				}
+			}
+			m_ipLock[j<<1]=down;
+			m_ipLock[(j<<1)+1]=up;
+		}
+	}
+
+	virtual ~CDivingPortfolio()
+		{clear();} ///< The destructor.
+
+	using CJobPool::setWorkerNum;
+	using CJobPool::getWorkerNum;
+
+	/**
+	 * \param[in] pPc pointer to pseudocosts used by `PSEUDOCOST` dives; if `0`, those dives select variables as `FRACTIONAL` ones.
+	 */
+	void setPseudocostTable(CPseudocostTable* pPc)
+		{m_pPc=pPc;}
+
+	/**
+	 * The function sets the objective value to be improved; the value is converted
+	 * to the minimization problem by the next call to `runDives()`, which gets the objective sense from the LPs.
+	 * \param[in] objVal objective value of the record solution.
+	 */
+	void setCutoff(double objVal)
+		{m_dNewCutoff=objVal; m_bNewCutoff=true;}
+
+	/**
+	 * The function sets the guide solution for `GUIDED` dives (usually, the record solution).
+	 * \param[in] dpX array of size `n`, `dpX[j]` is value of variable `j`; if `0`, `GUIDED` dives select variables as `FRACTIONAL` ones.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void setGuide(const double* dpX)
+	{
+		if (!dpX) {
+			if (m_dpGuide) {
+				delete[] m_dpGuide;
+				m_dpGuide=0;
+			}
+			return;
+		}
+		if (!m_dpGuide && !(m_dpGuide = new(std::nothrow) double[m_iN]))
+			throw new CMemoryException("CDivingPortfolio::setGuide");
+		for (int j=0; j < m_iN; ++j)
+			m_dpGuide[j]=dpX[j];
+	}
+
+	/**
+	 * The function runs `jobNum` dives in parallel; their rules are chosen by `selectDive()`.
+	 * \param[in] jobNum number of dives; if `jobNum <= 0`, one dive per worker is run.
+	 * \return `true` if a solution better than the cutoff has been found;
+	 * then the cutoff is set to its objective value.
+	 * \throws CMemoryException lack of memory.
+	 * \throws CException any exception thrown by `newLp()`.
+	 */
+	bool runDives(int jobNum=0)
+	{
+		int workerNum=getWorkerNum();
+		if (jobNum <= 0)
+			jobNum=workerNum;
+		allocMem(jobNum);
+		for (int w=0; w < workerNum; ++w)
+			if (!m_ppLp[w])
+				m_ppLp[w]=newLp(w);
+		if (!m_ppLp[0])
+			return false;
+		m_bSense=m_ppLp[0]->getObjSense();
+		if (m_bNewCutoff) {
+			m_dCutoff=(m_bSense)? -m_dNewCutoff: m_dNewCutoff;
+			m_bNewCutoff=false;
+		}
+		for (int w=0; w < workerNum; ++w)
+			m_dpWorkerObj[w]=m_dCutoff;
+		for (int j=0; j < m_iN; ++j)
+			m_dpC[j]=(m_bSense)? -m_ppLp[0]->getObjCoeff(j): m_ppLp[0]->getObjCoeff(j);
+		for (int k=0; k < jobNum; ++k)
+			m_ipJobDive[k]=selectDive(k);
+		runJobs(jobNum);
+		for (int k=0; k < jobNum; ++k) {
+			int d=m_ipJobDive[k];
+			++m_ipCallNum[d];
+			if (m_ipJobRes[k]) {
+				++m_ipSuccessNum[d];
+				if (m_ipJobRes[k] > 1)
+					++m_ipImproveNum[d];
+			}
+		}
+		int wBest=-1;
+		for (int w=0; w < workerNum; ++w)
+			if (m_dpWorkerObj[w] < m_dCutoff) {
+				m_dCutoff=m_dpWorkerObj[w];
+				wBest=w;
+			}
+		if (wBest < 0)
+			return false;
+		const double* dpX=m_dpWorkerSol+wBest*m_iN;
+		for (int j=0; j < m_iN; ++j)
+			m_dpSol[j]=dpX[j];
+		return m_bSolution=true;
+	}
+
+	bool isSolution() const
+		{return m_bSolution;} ///< \return `true` if some dive has found a solution better than the cutoff.
+
+	double getObjVal() const
+	{
+		if (m_bNewCutoff)
+			return m_dNewCutoff;
+		return (m_bSense)? -m_dCutoff: m_dCutoff;
+	} ///< \return objective value of the best solution found (or the cutoff).
+
+	/**
+	 * \param[out] dpX array of size `n`, `dpX[j]` is value of variable `j` in the best solution found.
+	 */
+	void getSolution(double* dpX) const
+	{
+		for (int j=0; j < m_iN; ++j)
+			dpX[j]=m_dpSol[j];
+	}
+
+	/**
+	 * \param[in] d diving rule.
+	 * \return number of dives of rule `d`.
+	 */
+	int getCallNum(enDive d) const
+		{return m_ipCallNum[d];}
+
+	/**
+	 * \param[in] d diving rule.
+	 * \return number of dives of rule `d` that have found feasible solutions.
+	 */
+	int getSuccessNum(enDive d) const
+		{return m_ipSuccessNum[d];}
+
+	/**
+	 * \param[in] d diving rule.
+	 * \return number of dives of rule `d` that have found solutions better than the cutoff.
+	 */
+	int getImproveNum(enDive d) const
+		{return m_ipImproveNum[d];}
+
+protected:
+	/**
+	 * The function must return an LP for worker `w`; it is called by the thread calling `runDives()`.
+	 * \param[in] w worker index.
+	 * \return pointer to an LP allocated by `new`, with all rows and variables of the problem;
+	 * `CDivingPortfolio` deletes it.
+	 */
+	virtual CLP* newLp(int w)=0;
+
+	/**
+	 * The function chooses the rule for job `k` of the current call to `runDives()` by the UCB1 rule:
+	 * a dive `d` that has been used `n_d` times with `s_d` successes gets the score
+	 * \f$s_d/n_d + \sqrt{2\ln N/n_d}\f$, where \f$N=\sum_d n_d\f$; the rules chosen for jobs `0,...,k-1`
+	 * are counted as unsuccessful calls, so that one call to `runDives()` tries several rules.
+	 * \param[in] k job index.
+	 * \return diving rule.
+	 */
+	virtual int selectDive(int k)
+	{
+		int num[DIVE_NUM], total=0;
+		for (int d=0; d < DIVE_NUM; ++d)
+			total+=num[d]=m_ipCallNum[d];
+		for (int i=0; i < k; ++i)
+			++num[m_ipJobDive[i]];
+		total+=k;
+		int best=0;
+		double bestScore=-1.0;
+		for (int d=0; d < DIVE_NUM; ++d) {
+			if (!num[d])
+				return d;
+			double score=static_cast<double>(m_ipSuccessNum[d])/num[d]+sqrt(2.0*log(static_cast<double>(total))/num[d]);
+			if (score > bestScore) {
+				bestScore=score;
+				best=d;
+			}
+		}
+		return best;
+	}
+
+private:
+	void clear()
+	{
+		for (int w=0; w < MAX_WORKER_NUM; ++w)
+			if (m_ppLp[w]) {
+				delete m_ppLp[w];
+				m_ppLp[w]=0;
+			}
+		delete[] m_dpC;
+		delete[] m_ipLock;
+		delete[] m_dpGuide;
+		delete[] m_dpSol;
+		delete[] m_dpX;
+		delete[] m_dpWorkerSol;
+		delete[] m_ipTrail;
+		delete[] m_dpTrail;
+		delete[] m_ipJobDive;
+		delete[] m_ipJobRes;
+		m_dpC=m_dpGuide=m_dpSol=m_dpX=m_dpWorkerSol=m_dpTrail=0;
+		m_ipLock=m_ipTrail=m_ipJobDive=m_ipJobRes=0;
+	}
+
+	/**
+	 * The function allocates per-worker memory, and memory for `jobNum` jobs.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void allocMem(int jobNum)
+	{
+		if (!m_dpX) {
+			size_t n=static_cast<size_t>(m_iN)*MAX_WORKER_NUM;
+			if (!(m_dpX = new(std::nothrow) double[n]) ||
+				!(m_dpWorkerSol = new(std::nothrow) double[n]) ||
+				!(m_ipTrail = new(std::nothrow) int[m_iMaxDepth*MAX_WORKER_NUM]) ||
+				!(m_dpTrail = new(std::nothrow) double[(m_iMaxDepth*MAX_WORKER_NUM)<<1]))
+				throw new CMemoryException("CDivingPortfolio::allocMem");
+		}
+		if (jobNum > m_iJobCap) {
+			delete[] m_ipJobDive;
+			delete[] m_ipJobRes;
+			m_ipJobRes=0;
+			if (!(m_ipJobDive = new(std::nothrow) int[jobNum]) ||
+				!(m_ipJobRes = new(std::nothrow) int[jobNum])) {
+				m_iJobCap=0;
+				throw new CMemoryException("CDivingPortfolio::allocMem");
+			}
+			m_iJobCap=jobNum;
+		}
+	}
+
+	void runJob(int k, int w)
+	{
+		try {
+			m_ipJobRes[k]=dive(m_ipJobDive[k],w);
+		}
+		catch(CException* pe) {
+			delete pe;
+			m_ipJobRes[k]=0;
+		}
+	}
+
+	/**
+	 * The function performs one dive on the LP of worker `w`.
+	 * \param[in] d diving rule;
+	 * \param[in] w worker index.
+	 * \return `0` if the dive failed, `1` if it found a solution not better than the best solution of worker `w`,
+	 * and `2` if the best solution of worker `w` has been improved.
+	 */
+	int dive(int d, int w)
+	{
+		CLP* pLp=m_ppLp[w];
+		double* dpX=m_dpX+w*m_iN;
+		int* ipTrail=m_ipTrail+w*m_iMaxDepth;
+		double* dpTrail=m_dpTrail+((w*m_iMaxDepth)<<1);
+		int depth=0, res=0;
+		for (;;) {
+			pLp->optimize();
+			if (!pLp->isSolution())
+				break;
+			double obj=(m_bSense)? -pLp->getObjVal(): pLp->getObjVal();
+			if (obj >= m_dCutoff-1.0e-9*(1.0+fabs(m_dCutoff)))
+				break;
+			readSolution(pLp,dpX);
+			int j;
+			bool up;
+			if (!select(d,dpX,j,up)) {
+				res=1;
+				if (obj < m_dpWorkerObj[w]) {
+					m_dpWorkerObj[w]=obj;
+					double* dpSol=m_dpWorkerSol+w*m_iN;
+					for (int i=0; i < m_iN; ++i)
+						dpSol[i]=dpX[i];
+					res=2;
+				}
+				break;
+			}
+			if (depth == m_iMaxDepth)
+				break;
+			ipTrail[depth]=j;
+			dpTrail[depth<<1]=pLp->getVarLoBound(j);
+			dpTrail[(depth<<1)+1]=pLp->getVarUpBound(j);
+			++depth;
+			if (up)
+				pLp->setVarLoBound(j,ceil(dpX[j]));
+			else
+				pLp->setVarUpBound(j,floor(dpX[j]));
+		}
+		while (depth--)
+			pLp->setVarBounds(ipTrail[depth],dpTrail[depth<<1],dpTrail[(depth<<1)+1]);
+		return res;
+	}
+
+	/**
+	 * The function copies the current LP solution of `pLp` to `dpX`.
+	 */
+	void readSolution(CLP* pLp, double* dpX) const
+	{
+		double* dpVal=0;
+		int* ipHd=0;
+		int n=pLp->getSolution(dpVal,ipHd);
+		for (int j=0; j < m_iN; ++j)
+			dpX[j]=0.0;
+		for (int i=0; i < n; ++i)
+			if (ipHd[i] >= 0 && ipHd[i] < m_iN)
+				dpX[ipHd[i]]=dpVal[i];
+	}
+
+	/**
+	 * The function selects a variable to be rounded.
+	 * \param[in] d diving rule;
+	 * \param[in] dpX LP solution;
+	 * \param[out] jBest selected variable;
+	 * \param[out] up `true` if `jBest` is rounded up.
+	 * \return `false` if all integer variables are integral in `dpX`.
+	 */
+	bool select(int d, const double* dpX, int &jBest, bool &up) const
+	{
+		if ((d == PSEUDOCOST && !m_pPc) || (d == GUIDED && !m_dpGuide))
+			d=FRACTIONAL;
+		double bestScore=CLP::INF;
+		jBest=-1;
+		for (int j=0; j < m_iN; ++j) {
+			if (!m_pModel->isInt(j))
+				continue;
+			double f=dpX[j]-floor(dpX[j]);
+			if (f < 1.0e-6 || f > 1.0-1.0e-6)
+				continue;
+			bool u;
+			double score;
+			switch (d) {
+				case COEFFICIENT: {
+					int down=m_ipLock[j<<1], upl=m_ipLock[(j<<1)+1];
+					u=(upl < down || (upl == down && f > 0.5));
+					score=(u)? upl+1.0-f: down+f;
+					break;
+				}
+				case PSEUDOCOST: {
+					double gd=m_pPc->get(j,false)*f, gu=m_pPc->get(j,true)*(1.0-f);
+					u=(f > 0.7 || (f >= 0.3 && gu < gd));
+					score=(u)? (gu+1.0e-6)/(gd+1.0e-6): (gd+1.0e-6)/(gu+1.0e-6);
+					break;
+				}
+				case GUIDED:
+					u=(m_dpGuide[j] >= dpX[j]);
+					score=fabs(dpX[j]-m_dpGuide[j]);
+					break;
+				case VECTOR_LENGTH: {
+					const int* ipEntry;
+					double c=m_dpC[j];
+					u=(c >= 0.0);
+					score=(((u)? c*(1.0-f): -c*f)+1.0e-6*((u)? 1.0-f: f))/(m_pModel->getColumn(j,ipEntry)+1.0);
+					break;
+				}
+				default: // FRACTIONAL
+					u=(f > 0.5);
+					score=(u)? 1.0-f: f;
+			}
+			if (score < bestScore) {
+				bestScore=score;
+				jBest=j;
+				up=u;
+			}
+		}
+		return jBest >= 0;
+	}
+};
+
+#endif // __DIVING_H_
@@ -0,0 +1,279 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file dualStab.h Interface for `CDualStabilizer` class
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __DUALSTAB_H_
+#define __DUALSTAB_H_
+
+#include <cstring>
+#include <new>
+#include "except.h"
+
+/// Dual stabilization for column generation.
+/**
+ * Dual values of column generation masters usually oscillate, and many pricing rounds are spent
+ * to generate columns that are useless at the end.
+ * `CDualStabilizer` implements _dual smoothing_: pricing problems are solved
+ * for the dual vector
+ * \f[
+ *     \pi = \alpha \bar{\pi} + (1-\alpha) y,
+ * \f]
+ * where \f$y\f$ is the vector of master duals passed to `CMIP::generateColumns()`,
+ * and \f$\bar{\pi}\f$ is the _stability center_. Optionally, \f$\pi\f$ is projected onto
+ * the box \f$[\bar{\pi}-\delta,\bar{\pi}+\delta]\f$ (_box-step_ stabilization).
+ *
+ *  - In Neame's scheme (default), the center is the dual vector used in the previous pricing round.
+ *  - In Wentges' scheme, the center is the dual vector that gave the best Lagrangian bound;
+ *    the user passes Lagrangian bounds to `updateCenter()`.
+ *
+ * If no column priced out for \f$\pi\f$ has negative reduced cost with respect to \f$y\f$
+ * (_mispricing_), the user calls `mispricing()`, which decreases \f$\alpha\f$
+ * (\f$\alpha_k = \alpha-k(1-\alpha)\f$ after \f$k\f$ mispricings), and eventually
+ * falls back to the true duals \f$y\f$; therefore, column generation stops only
+ * when pricing with true duals fails.
+ *
+ * Typical use in `generateColumns(m,ipRowHd,dpY)`:
+ * ~~~
+ * const double* pi=m_stab.stabilize(m,ipRowHd,dpY);
+ * do {
+ *     // solve pricing problems for `pi`, and add only columns with negative reduced costs for `dpY`
+ *     if (columns have been added) {
+ *         m_stab.columnsGenerated();
+ *         return true;
+ *     }
+ * } while ((pi=m_stab.mispricing()));
+ * return false;
+ * ~~~
+ */
+class CDualStabilizer
+{
+	int m_iSize; ///< size of memory allocated for arrays.
+	int m_iM; ///< number of master rows in the current center.
+	bool m_bCenter; ///< `true` if the stability center is defined.
+	bool m_bWentges; ///< `true` if center is updated only when Lagrangian bound is improved.
+	bool m_bTrueDuals; ///< `true` if the duals of the current pricing are true duals.
+	double m_dAlpha; ///< smoothing parameter, `0 <= m_dAlpha < 1`.
+	double m_dBox; ///< if positive, half-width of the box around the center.
+	double m_dCurAlpha; ///< smoothing parameter used in the current pricing round.
+	double m_dBestBound; ///< best Lagrangian bound (used in Wentges' scheme).
+	int m_iMisNum; ///< number of mispricings in the current pricing round.
+	const double *m_dpY; ///< true duals of the current round.
+	double *m_dpCenter; ///< stability center.
+	double *m_dpPi; ///< stabilized duals.
+	int *m_ipHd; ///< handles of master rows in the current center.
+
+// Statistics
+	int m_iRoundNum; ///< number of pricing rounds.
+	int m_iSmoothedNum; ///< number of rounds in which columns were priced out for stabilized duals.
+	int m_iMisTotal; ///< total number of mispricings.
+	int m_iTrueDualNum; ///< number of times that pricing has been done for true duals after mispricing.
+
+public:
+	/**
+	 * \param[in] alpha smoothing parameter;
+	 * \param[in] box half-width of the box around the center; if `box <= 0`, box-step stabilization is not used.
+	 */
+	CDualStabilizer(double alpha=0.8, double box=0.0): m_iSize(0), m_iM(0), m_bCenter(false), m_bWentges(false), m_bTrueDuals(true),
+		m_dAlpha(alpha), m_dBox(box), m_dCurAlpha(0.0), m_dBestBound(-1.0e20), m_iMisNum(0),
+		m_dpY(0), m_dpCenter(0), m_ipHd(0),
+		m_iRoundNum(0), m_iSmoothedNum(0), m_iMisTotal(0), m_iTrueDualNum(0)
+	{} ///< The constructor.
+
+	~CDualStabilizer()
+	{
+		if (m_dpCenter)
+			delete[] m_dpCenter;
+		if (m_ipHd)
+			delete[] m_ipHd;
+	} ///< The destructor.
+
+	/**
+	 * \param[in] alpha smoothing parameter, `0 <= alpha < 1`; `alpha=0` switches off smoothing.
+	 */
+	void setAlpha(double alpha)
+		{m_dAlpha=(alpha < 0.0)? 0.0: (alpha > 0.99)? 0.99: alpha;}
+
+	/**
+	 * \param[in] box half-width of the box around the center; if `box <= 0`, box-step stabilization is not used.
+	 */
+	void setBox(double box)
+		{m_dBox=box;}
+
+	double getAlpha() const
+		{return m_dAlpha;} ///< \return smoothing parameter.
+	double getBox() const
+		{return m_dBox;} ///< \return half-width of the box around the center.
+
+	/**
+	 * \param[in] flag if `true`, Wentges' scheme is used; otherwise, Neame's scheme.
+	 */
+	void setWentges(bool flag)
+		{m_bWentges=flag;}
+
+	/**
+	 * \return `true` if Wentges' scheme is used.
+	 */
+	bool isWentges() const
+		{return m_bWentges;}
+
+	/**
+	 * The function forgets the current center; it should be called when master duals
+	 * cannot be compared with previous ones (for example, when a new node of the search tree is processed).
+	 */
+	void reset()
+	{
+		m_bCenter=false;
+		m_dBestBound=-1.0e20;
+	}
+
+	/**
+	 * The function starts a new pricing round.
+	 * \param[in] m number of master rows;
+	 * \param[in] ipRowHd,dpY arrays of size `m`, `dpY[i]` is dual value of row with handle `ipRowHd[i]`.
+	 * \return stabilized dual values (an array of size `m`).
+	 * \throws CMemoryException lack of memory.
+	 */
+	const double* stabilize(int m, const int* ipRowHd, const double* dpY)
+	{
+		++m_iRoundNum;
+		m_iMisNum=0;
+		m_dpY=dpY;
+		if (m > m_iSize) {
+			if (m_dpCenter)
+				delete[] m_dpCenter;
+			if (m_ipHd)
+				delete[] m_ipHd;
+			m_ipHd=0;
+			if (!(m_dpCenter = new(std::nothrow) double[2*m]) ||
+				!(m_ipHd = new(std::nothrow) int[m]))
+				throw new CMemoryException("CDualStabilizer::stabilize");
+			m_dpPi=m_dpCenter+m;
+			m_iSize=m;
+			m_bCenter=false;
+		}
+		if (m_bCenter && (m != m_iM || memcmp(m_ipHd,ipRowHd,m*sizeof(int))))
+			reset(); // master rows have been changed
+		m_iM=m;
+		if (!m_bCenter) {
+			memcpy(m_ipHd,ipRowHd,m*sizeof(int));
+			memcpy(m_dpCenter,dpY,m*sizeof(double));
+			m_bCenter=true;
+			m_bTrueDuals=true;
+			m_dCurAlpha=0.0;
+			return dpY;
+		}
+		if ((m_dCurAlpha=m_dAlpha) <= 0.0 && m_dBox <= 0.0) {
+			m_bTrueDuals=true;
+			return dpY;
+		}
+		m_bTrueDuals=false;
+		return computeDuals();
+	}
+
+	/**
+	 * The function is called when pricing for the current stabilized duals
+	 * has not produced any column with negative reduced cost (with respect to true duals).
+	 * \return new stabilized duals, or `0` if last pricing has been done for true duals.
+	 */
+	const double* mispricing()
+	{
+		if (m_bTrueDuals)
+			return 0;
+		++m_iMisNum;
+		++m_iMisTotal;
+		if ((m_dCurAlpha=m_dAlpha-m_iMisNum*(1.0-m_dAlpha)) <= 1.0e-9) {
+			m_dCurAlpha=0.0;
+			m_bTrueDuals=true;
+			++m_iTrueDualNum;
+			m_bCenter=false; // the next round starts from true duals
+			return m_dpY;
+		}
+		return computeDuals();
+	}
+
+	/**
+	 * The function is called when columns have been generated in the current pricing round.
+	 * In Neame's scheme, the current stabilized duals become the new center.
+	 */
+	void columnsGenerated()
+	{
+		if (!m_bTrueDuals) {
+			++m_iSmoothedNum;
+			if (!m_bWentges)
+				memcpy(m_dpCenter,m_dpPi,m_iM*sizeof(double));
+		}
+	}
+
+	/**
+	 * In Wentges' scheme, the center is moved to the current stabilized duals
+	 * if they have given a better Lagrangian bound.
+	 * \param[in] bound Lagrangian bound computed for the current stabilized duals
+	 * (for a maximization master, the bound is to be maximized).
+	 */
+	void updateCenter(double bound)
+	{
+		if (m_bWentges && m_bCenter && bound > m_dBestBound) {
+			m_dBestBound=bound;
+			if (!m_bTrueDuals)
+				memcpy(m_dpCenter,m_dpPi,m_iM*sizeof(double));
+			else
+				memcpy(m_dpCenter,m_dpY,m_iM*sizeof(double));
+		}
+	}
+
+	int getRoundNum() const
+		{return m_iRoundNum;} ///< \return number of pricing rounds.
+	int getSmoothedRoundNum() const
+		{return m_iSmoothedNum;} ///< \return number of rounds in which columns were generated for stabilized duals.
+	int getMispricingNum() const
+		{return m_iMisTotal;} ///< \return total number of mispricings.
+	int getTrueDualNum() const
+		{return m_iTrueDualNum;} ///< \return number of fallbacks to true duals.
+
+private:
+	/**
+	 * The function computes stabilized duals for the current value of smoothing parameter.
+	 */
+	const double* computeDuals()
+	{
+		double a=m_dCurAlpha, b=1.0-a, box=m_dBox;
+		const double *y=m_dpY;
+		double *c=m_dpCenter, *pi=m_dpPi;
+		for (int i=0; i < m_iM; ++i) {
+			double v=a*c[i]+b*y[i];
+			if (box > 0.0) {
+				if (v > c[i]+box)
+					v=c[i]+box;
+				else if (v < c[i]-box)
+					v=c[i]-box;
+			}
+			pi[i]=v;
+		}
+		return pi;
+	}
+};
+
+#endif // __DUALSTAB_H_
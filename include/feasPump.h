@@ -0,0 +1,406 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file feasPump.h Interface for `CFeasibilityPump` class
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __FEASPUMP_H_
+#define __FEASPUMP_H_
+
+#include <cmath>
+#include <new>
+#include "except.h"
+#include "lp.h"
+#include "Sort.h"
+#include "rowProp.h"
+
+/// Objective feasibility pump.
+/**
+ * The feasibility pump alternates between two points: an LP solution \f$x^*\f$, and its rounding \f$\tilde{x}\f$;
+ * the next \f$x^*\f$ is an LP solution closest (in \f$l_1\f$-norm, over integer variables) to \f$\tilde{x}\f$.
+ * The pump stops when \f$x^*\f$ becomes integral.
+ *   - _Objective scaling_: the distance function is combined with the (scaled) original objective
+ *     with weight \f$\alpha\f$, which decreases geometrically.
+ *   - _Perturbation_: if the rounding is the same as in the previous iteration, several variables with largest
+ *     \f$|x^*_j-\tilde{x}_j|\f$ are flipped; longer cycles are broken by a random _restart_.
+ *   - _Propagation_: the variables are rounded one by one, in increasing order of fractionality,
+ *     and each fixing is propagated by `CRowPropagator`, so that later variables are rounded
+ *     into their propagated domains.
+ *
+ * The user builds the problem exactly as for `CLP` (integer variables have type `VAR_INT`),
+ * calls `closeMatrix()`, and then `pump()`. Preprocessing is switched off by the constructor
+ * because the pump accesses rows and variables by their indices. The handle of variable `j` must be `j`.
+ * The solution found can be passed to `CMIP` as the initial record.
+ */
+class CFeasibilityPump: public CLP
+{
+	int m_iN; ///< number of variables.
+	int m_iIntNum; ///< number of integer variables.
+	int* m_ipInt; ///< list of integer variables.
+	double* m_dpC; ///< original objective.
+	double* m_dpX; ///< LP solution.
+	double* m_dpXr; ///< rounded solution.
+	double* m_dpPrev; ///< `m_dpPrev[k]` is value of `m_ipInt[k]` in the previous rounded solution.
+	double* m_dpBest; ///< solution found.
+	double* m_dpFrac; ///< work array.
+	int* m_ipOrder; ///< work array.
+	bool m_bFound; ///< `true` if a feasible solution has been found.
+	double m_dBestObj; ///< objective value of `m_dpBest`.
+	CRowPropagator* m_pProp; ///< propagator.
+	unsigned m_uSeed; ///< state of the random number generator.
+	int m_iItNum; ///< number of pumping iterations done.
+	int m_iFlipNum; ///< number of perturbations.
+	int m_iRestartNum; ///< number of restarts.
+	unsigned m_uHash[3]; ///< hash values of the last three rounded solutions.
+
+public:
+	/**
+	 * The constructor.
+	 * \param[in] name problem name.
+	 */
+	CFeasibilityPump(const char* name): CLP(name), m_iN(0), m_iIntNum(0),
+		m_ipInt(0), m_dpC(0), m_dpX(0), m_dpXr(0), m_dpPrev(0), m_dpBest(0), m_dpFrac(0), m_ipOrder(0),
+		m_bFound(false), m_dBestObj(0.0), m_pProp(0), m_uSeed(12345u), m_iItNum(0), m_iFlipNum(0), m_iRestartNum(0)
+	{
+		preprocOff();
+	}
+
+	virtual ~CFeasibilityPump()
+		{clear();} ///< The destructor.
+
+	/**
+	 * The function runs the feasibility pump.
+	 * \param[in] maxItNum maximum number of pumping iterations;
+	 * \param[in] maxRestartNum maximum number of restarts.
+	 * \return `true` if a feasible solution has been found.
+	 * \throws CMemoryException lack of memory.
+	 */
+	bool pump(int maxItNum=200, int maxRestartNum=5)
+	{
+		if (!init())
+			return false;
+		bool sense=getObjSense();
+		optimize();
+		if (!isSolution())
+			return false;
+		double normC=0.0;
+		for (int j=0; j < m_iN; ++j)
+			normC+=m_dpC[j]*m_dpC[j];
+		double scale=(normC > 0.0)? sqrt(static_cast<double>(m_iIntNum)/normC): 0.0,
+			alpha=1.0;
+		m_uHash[0]=m_uHash[1]=m_uHash[2]=0;
+		for (m_iItNum=0; m_iItNum < maxItNum; ++m_iItNum) {
+			readSolution();
+			if (isIntegral()) {
+				m_bFound=true;
+				m_dBestObj=0.0;
+				for (int j=0; j < m_iN; ++j) {
+					m_dpBest[j]=m_dpX[j];
+					m_dBestObj+=m_dpC[j]*m_dpX[j];
+				}
+				break;
+			}
+			round();
+			unsigned h=hash();
+			if (m_iItNum && isSameRounding()) {
+				flip();
+				h=hash();
+			}
+			else if (h == m_uHash[1] || h == m_uHash[2]) {
+				if (++m_iRestartNum > maxRestartNum)
+					break;
+				perturb();
+				h=hash();
+			}
+			m_uHash[2]=m_uHash[1];
+			m_uHash[1]=m_uHash[0];
+			m_uHash[0]=h;
+			for (int k=0; k < m_iIntNum; ++k)
+				m_dpPrev[k]=m_dpXr[m_ipInt[k]];
+			alpha*=0.9; // the first distance LP uses alpha=0.9, not a pure objective
+			setDistObjective(alpha,(sense)? -scale: scale);
+			optimize();
+			if (!isSolution())
+				break;
+		}
+		for (int j=0; j < m_iN; ++j)
+			setObjCoeff(j,m_dpC[j]);
+		setObjSense(sense);
+		return m_bFound;
+	}
+
+	bool isPumpSolution() const
+		{return m_bFound;} ///< \return `true` if `pump()` has found a feasible solution.
+
+	double getPumpObjVal() const
+		{return m_dBestObj;} ///< \return objective value of the solution found by `pump()`.
+
+	/**
+	 * \param[out] dpX array of size `getVarNum()`, `dpX[j]` is value of variable `j` in the solution found by `pump()`.
+	 */
+	void getPumpSolution(double* dpX) const
+	{
+		for (int j=0; j < m_iN; ++j)
+			dpX[j]=m_dpBest[j];
+	}
+
+	int getItNum() const
+		{return m_iItNum;} ///< \return number of pumping iterations.
+	int getFlipNum() const
+		{return m_iFlipNum;} ///< \return number of perturbations of cycling roundings.
+	int getRestartNum() const
+		{return m_iRestartNum;} ///< \return number of restarts.
+
+private:
+	void clear()
+	{
+		delete[] m_ipInt;
+		delete[] m_dpC;
+		delete[] m_dpX;
+		delete[] m_dpXr;
+		delete[] m_dpPrev;
+		delete[] m_dpBest;
+		delete[] m_dpFrac;
+		delete[] m_ipOrder;
+		m_ipInt=m_ipOrder=0;
+		m_dpC=m_dpX=m_dpXr=m_dpPrev=m_dpBest=m_dpFrac=0;
+		if (m_pProp) {
+			delete m_pProp;
+			m_pProp=0;
+		}
+	}
+
+	/**
+	 * The function allocates memory, stores the original objective, and builds the propagator.
+	 * \return `false` if the propagator has detected infeasibility.
+	 * \throws CMemoryException lack of memory.
+	 */
+	bool init()
+	{
+		clear();
+		int n=m_iN=getVarNum(), m=getCtrNum();
+		if (!(m_ipInt = new(std::nothrow) int[n]) ||
+			!(m_dpC = new(std::nothrow) double[n]) ||
+			!(m_dpX = new(std::nothrow) double[n]) ||
+			!(m_dpXr = new(std::nothrow) double[n]) ||
+			!(m_dpPrev = new(std::nothrow) double[n]) ||
+			!(m_dpBest = new(std::nothrow) double[n]) ||
+			!(m_dpFrac = new(std::nothrow) double[n]) ||
+			!(m_ipOrder = new(std::nothrow) int[n])) {
+			clear();
+			throw new CMemoryException("CFeasibilityPump::init");
+		}
+		m_pProp=new CRowPropagator(m,n,getNonZerosNum());
+		m_iIntNum=0;
+		for (int j=0; j < n; ++j) {
+			bool isInt=(m_ipVarType[j] & VAR_INT)? true: false;
+			if (isInt)
+				m_ipInt[m_iIntNum++]=j;
+			m_dpC[j]=getObjCoeff(j);
+			m_pProp->setVar(j,bound(getVarLoBound(j)),bound(getVarUpBound(j)),isInt);
+		}
+		for (int i=0; i < m; ++i) {
+			int sz=getRow(i,m_dpFrac,m_ipOrder);
+			m_pProp->addRow(bound(getLHS(i)),bound(getRHS(i)),sz,m_dpFrac,m_ipOrder);
+		}
+		m_bFound=false;
+		m_iFlipNum=m_iRestartNum=0;
+		return m_pProp->init();
+	}
+
+	/**
+	 * \return `val` with infinite values replaced by `CRowPropagator::INF` or `-CRowPropagator::INF`.
+	 */
+	static double bound(double val)
+	{
+		if (val >= CRowPropagator::INF)
+			return CRowPropagator::INF;
+		return (val <= -CRowPropagator::INF)? -CRowPropagator::INF: val;
+	}
+
+	/**
+	 * The function copies the current LP solution to `m_dpX`.
+	 */
+	void readSolution()
+	{
+		double* dpX=0;
+		int* ipHd=0;
+		int n=getSolution(dpX,ipHd);
+		for (int j=0; j < m_iN; ++j)
+			m_dpX[j]=0.0;
+		for (int i=0; i < n; ++i)
+			if (ipHd[i] >= 0 && ipHd[i] < m_iN)
+				m_dpX[ipHd[i]]=dpX[i];
+	}
+
+	bool isIntegral() const
+	{
+		for (int k=0; k < m_iIntNum; ++k) {
+			double x=m_dpX[m_ipInt[k]];
+			if (fabs(x-floor(x+0.5)) > 1.0e-6)
+				return false;
+		}
+		return true;
+	} ///< \return `true` if all integer variables take integral values in `m_dpX`.
+
+	/**
+	 * The function rounds integer variables of `m_dpX`, in increasing order of fractionality,
+	 * propagating each fixing; values of continuous variables are copied.
+	 */
+	void round()
+	{
+		for (int j=0; j < m_iN; ++j)
+			m_dpXr[j]=m_dpX[j];
+		for (int k=0; k < m_iIntNum; ++k) {
+			double x=m_dpX[m_ipInt[k]];
+			m_dpFrac[k]=fabs(x-floor(x+0.5));
+			m_ipOrder[k]=k;
+		}
+		SORT::incSortDouble(m_iIntNum,m_ipOrder,m_dpFrac);
+		int base=m_pProp->getMark();
+		for (int t=0; t < m_iIntNum; ++t) {
+			int j=m_ipInt[m_ipOrder[t]];
+			double x=m_dpX[j], lo=m_pProp->getLoBound(j), up=m_pProp->getUpBound(j),
+				v=floor(x+0.5);
+			if (v < lo)
+				v=lo;
+			else if (v > up)
+				v=up;
+			int mark=m_pProp->getMark();
+			if (!m_pProp->setBounds(j,v,v)) {
+				m_pProp->undo(mark);
+				double w=(v > x)? v-1.0: v+1.0;
+				if (w >= lo && w <= up) {
+					if (m_pProp->setBounds(j,w,w))
+						v=w;
+					else
+						m_pProp->undo(mark);
+				}
+			}
+			m_dpXr[j]=v;
+		}
+		m_pProp->undo(base);
+	}
+
+	/**
+	 * \return `true` if integer variables are rounded as in the previous iteration.
+	 */
+	bool isSameRounding() const
+	{
+		for (int k=0; k < m_iIntNum; ++k)
+			if (m_dpXr[m_ipInt[k]] != m_dpPrev[k])
+				return false;
+		return true;
+	}
+
+	/**
+	 * The function changes the rounding of `T` integer variables with largest `|x*_j-x~_j|`,
+	 * where `T` is a random number from `[10,30]`.
+	 */
+	void flip()
+	{
+		int T=10+static_cast<int>(random()*20.0);
+		for (int k=0; k < m_iIntNum; ++k) {
+			int j=m_ipInt[k];
+			m_dpFrac[k]=fabs(m_dpX[j]-m_dpXr[j]);
+			m_ipOrder[k]=k;
+		}
+		if (T > m_iIntNum)
+			T=m_iIntNum;
+		SORT::decSortDouble(m_iIntNum,m_ipOrder,m_dpFrac);
+		for (int t=0; t < T && m_dpFrac[m_ipOrder[t]] > 0.0; ++t)
+			flipVar(m_ipInt[m_ipOrder[t]]);
+		++m_iFlipNum;
+	}
+
+	/**
+	 * The function flips every integer variable `j` with `|x*_j-x~_j|+max(r_j,0) > 0.5`,
+	 * where `r_j` is random from `[-0.3,0.7]`.
+	 */
+	void perturb()
+	{
+		for (int k=0; k < m_iIntNum; ++k) {
+			int j=m_ipInt[k];
+			double r=random()-0.3;
+			if (fabs(m_dpX[j]-m_dpXr[j])+((r > 0.0)? r: 0.0) > 0.5)
+				flipVar(j);
+		}
+	}
+
+	/**
+	 * The function moves `m_dpXr[j]` by one towards `m_dpX[j]` (or away from it if they are equal), keeping it within bounds.
+	 */
+	void flipVar(int j)
+	{
+		double lo=getVarLoBound(j), up=getVarUpBound(j), v=m_dpXr[j];
+		v+=(m_dpX[j] > v || (m_dpX[j] == v && v < up))? 1.0: -1.0;
+		if (v >= lo && v <= up)
+			m_dpXr[j]=v;
+	}
+
+	/**
+	 * The function sets the objective to minimize `(1-alpha)*Delta(x,x~) + alpha*scale*c*x`,
+	 * where `Delta` is the distance over integer variables that are at their bounds in `x~`.
+	 */
+	void setDistObjective(double alpha, double scale)
+	{
+		for (int j=0; j < m_iN; ++j)
+			m_dpFrac[j]=alpha*scale*m_dpC[j];
+		for (int k=0; k < m_iIntNum; ++k) {
+			int j=m_ipInt[k];
+			double v=m_dpXr[j];
+			if (v <= getVarLoBound(j))
+				m_dpFrac[j]+=1.0-alpha;
+			else if (v >= getVarUpBound(j))
+				m_dpFrac[j]-=1.0-alpha;
+		}
+		setObjSense(false);
+		for (int j=0; j < m_iN; ++j)
+			setObjCoeff(j,m_dpFrac[j]);
+	}
+
+	/**
+	 * \return FNV-1a hash of the rounded values of integer variables.
+	 */
+	unsigned hash() const
+	{
+		unsigned h=2166136261u;
+		for (int k=0; k < m_iIntNum; ++k) {
+			h^=static_cast<unsigned>(static_cast<int>(m_dpXr[m_ipInt[k]]));
+			h*=16777619u;
+		}
+		return h;
+	}
+
+	/**
+	 * \return pseudo-random number from `[0,1)`.
+	 */
+	double random()
+	{
+		m_uSeed=m_uSeed*1103515245u+12345u;
+		return static_cast<double>((m_uSeed >> 8) & 0xFFFFFF)/16777216.0;
+	}
+};
+
+#endif // __FEASPUMP_H_
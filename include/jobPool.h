@@ -0,0 +1,363 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file jobPool.h Interface for `CJobPool` class
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __JOBPOOL_H_
+#define __JOBPOOL_H_
+
+#include "thread.h"
+#ifndef __ONE_THREAD_
+#include <atomic>
+#endif
+
+/// This class runs a number of independent jobs on several threads.
+/**
+ * Typical jobs are pricing problems in `CMIP::generateColumns()`,
+ * or subproblems in `CLP::separate()`. Any job writes its result
+ * into memory reserved for that job, and, when `runJobs()` returns,
+ * the calling thread processes the results in the order of job indices;
+ * so, the outcome does not depend on how jobs have been distributed among threads.
+ *
+ * A derived class overloads `runJob()`; the worker index passed to `runJob()`
+ * allows each thread to use its own scratch memory.
+ *
+ * Jobs are scheduled by _work stealing_: initially, each worker gets a block of consecutive jobs
+ * (its own deque), and runs them starting from the front; a worker which has finished its block
+ * steals a half of the remaining jobs from the back of the deque of another worker.
+ * So, workers do not compete for a shared job counter, and load is balanced
+ * even if jobs are of very different sizes.
+ *
+ * In _deterministic mode_ (see `setDeterministic()`), stealing is switched off:
+ * worker `t` always runs the same block of jobs in the same order. This matters
+ * when `runJob()` keeps state between calls in worker's memory (for example, warm started LPs
+ * or random generators owned by workers); then, for the same input and number of workers,
+ * every run gives the same results, though load balancing may be worse.
+ *
+ * Worker threads are started by the first call to `runJobs()` that needs them, and between calls
+ * they sleep on a condition variable; so, calling `runJobs()` many times (once per pricing round,
+ * cut round, etc.) does not pay for creating threads. The threads are stopped by the destructor.
+ *
+ * In single-threaded applications (`__ONE_THREAD_` is defined), all jobs are run
+ * by the calling thread.
+ */
+class CJobPool
+{
+public:
+	enum {
+		MAX_WORKER_NUM=64 ///< maximum number of workers.
+	};
+
+private:
+	int m_iWorkerNum; ///< number of workers (threads) used by `runJobs()`.
+	bool m_bDeterministic; ///< if `true`, jobs are statically assigned to workers.
+#ifndef __ONE_THREAD_
+	/// Deque of jobs of a worker.
+	/**
+	 * Jobs `head,...,tail-1` are packed into one word (`head` in high 32 bits)
+	 * so that both the owner and thieves can update the deque by one atomic operation.
+	 * Each deque occupies its own cache line.
+	 */
+	struct alignas(64) tagDeque {
+		std::atomic<unsigned long long> range; ///< `(head << 32) | tail`.
+	};
+
+	tagDeque m_Deque[MAX_WORKER_NUM]; ///< job deques of workers.
+	int m_iActiveNum; ///< number of workers in the current call to `runJobs()`.
+	std::atomic<int> m_iStealNum; ///< number of successful steals.
+
+	/// Parameter passed to a worker thread.
+	struct tagWorker {
+		CJobPool* pPool; ///< pointer to the pool.
+		int worker; ///< worker index.
+		unsigned epoch; ///< value of `m_uEpoch` when the thread was started.
+	};
+
+	_THREAD m_Thread[MAX_WORKER_NUM]; ///< `m_Thread[t]` is thread of worker `t`, `1 <= t < m_iThreadNum`.
+	tagWorker m_Worker[MAX_WORKER_NUM]; ///< parameters of worker threads.
+	int m_iThreadNum; ///< worker threads `1,...,m_iThreadNum-1` are running.
+	unsigned m_uEpoch; ///< number of calls to `runJobs()` that have waked up worker threads.
+	int m_iBusyNum; ///< number of worker threads that have not finished the current call to `runJobs()`.
+	bool m_bStop; ///< if `true`, worker threads must exit.
+	_MUTEX m_mutex; ///< protects `m_uEpoch`, `m_iActiveNum`, `m_iBusyNum`, and `m_bStop`.
+	_COND m_condWork; ///< signaled when `m_uEpoch` is incremented or `m_bStop` is set.
+	_COND m_condDone; ///< signaled when `m_iBusyNum` becomes zero.
+#endif
+
+public:
+	CJobPool(): m_iWorkerNum(1), m_bDeterministic(false)
+	{
+#ifndef __ONE_THREAD_
+		m_iActiveNum=0;
+		m_iStealNum=0;
+		m_iThreadNum=1;
+		m_uEpoch=0;
+		m_iBusyNum=0;
+		m_bStop=false;
+		_MUTEX_INIT(m_mutex)
+		_COND_INIT(m_condWork)
+		_COND_INIT(m_condDone)
+#endif
+	} ///< The constructor.
+
+	virtual ~CJobPool()
+	{
+#ifndef __ONE_THREAD_
+		stopThreads();
+		_COND_DESTROY(m_condDone)
+		_COND_DESTROY(m_condWork)
+		_MUTEX_DESTROY(m_mutex)
+#endif
+	} ///< The destructor.
+
+	/**
+	 * \param[in] workerNum number of workers; workers `1,...,workerNum-1` are separate threads,
+	 * and worker `0` is the thread calling `runJobs()`.
+	 */
+	void setWorkerNum(int workerNum)
+	{
+#ifdef __ONE_THREAD_
+		workerNum=1;
+#endif
+		if (workerNum < 1)
+			workerNum=1;
+		else if (workerNum > MAX_WORKER_NUM)
+			workerNum=MAX_WORKER_NUM;
+		m_iWorkerNum=workerNum;
+	}
+
+	/**
+	 * \return number of workers.
+	 */
+	int getWorkerNum() const
+		{return m_iWorkerNum;}
+
+	/**
+	 * \param[in] flag if `true`, each worker runs a fixed block of jobs, and jobs are never stolen.
+	 */
+	void setDeterministic(bool flag)
+		{m_bDeterministic=flag;}
+
+	/**
+	 * \return `true` if the pool works in deterministic mode.
+	 */
+	bool isDeterministic() const
+		{return m_bDeterministic;}
+
+	/**
+	 * \return number of successful steals since the pool has been created.
+	 */
+	int getStealNum() const
+	{
+#ifndef __ONE_THREAD_
+		return m_iStealNum;
+#else
+		return 0;
+#endif
+	}
+
+	/**
+	 * The function calls `runJob(job,worker)` for `job=0,...,jobNum-1`, and
+	 * returns when all the jobs have been done.
+	 * \param[in] jobNum number of jobs.
+	 * \attention `runJob()` must not throw exceptions.
+	 */
+	void runJobs(int jobNum)
+	{
+#ifndef __ONE_THREAD_
+		int workerNum=(m_iWorkerNum < jobNum)? m_iWorkerNum: jobNum;
+		if (workerNum > 1) {
+			startThreads(workerNum);
+			for (int t=0; t < workerNum; ++t) {
+				unsigned long long head=(static_cast<long long>(jobNum)*t)/workerNum,
+					tail=(static_cast<long long>(jobNum)*(t+1))/workerNum;
+				m_Deque[t].range=(head << 32) | tail;
+			}
+			_MUTEX* pMutex=&m_mutex;
+			_MUTEX_LOCK(pMutex)
+			m_iActiveNum=workerNum;
+			m_iBusyNum=workerNum-1;
+			++m_uEpoch;
+			_COND_BROADCAST(&m_condWork)
+			_MUTEX_UNLOCK(pMutex)
+			work(0);
+			_MUTEX_LOCK(pMutex)
+			while (m_iBusyNum > 0)
+				_COND_WAIT(&m_condDone,pMutex)
+			_MUTEX_UNLOCK(pMutex)
+			return;
+		}
+#endif
+		for (int job=0; job < jobNum; ++job)
+			runJob(job,0);
+	}
+
+protected:
+	/**
+	 * The function is called to run a job.
+	 * \param[in] job job index;
+	 * \param[in] worker index of the worker running the job, `0 <= worker < getWorkerNum()`.
+	 */
+	virtual void runJob(int job, int worker)=0;
+
+private:
+#ifndef __ONE_THREAD_
+	/**
+	 * \param[in] worker worker index.
+	 * \return job taken from the front of the worker's deque, or `-1` if the deque is empty.
+	 */
+	int popJob(int worker)
+	{
+		std::atomic<unsigned long long> &range=m_Deque[worker].range;
+		unsigned long long r=range.load();
+		for (;;) {
+			unsigned long long head=r >> 32, tail=r & 0xFFFFFFFFull;
+			if (head >= tail)
+				return -1;
+			if (range.compare_exchange_weak(r,((head+1) << 32) | tail))
+				return static_cast<int>(head);
+		}
+	}
+
+	/**
+	 * The function moves a half of the jobs of some other worker to the deque of `worker`.
+	 * \param[in] worker index of the thief.
+	 * \return `false` if all deques are empty.
+	 */
+	bool stealJobs(int worker)
+	{
+		for (int i=1; i < m_iActiveNum; ++i) {
+			int victim=(worker+i) % m_iActiveNum;
+			std::atomic<unsigned long long> &range=m_Deque[victim].range;
+			unsigned long long r=range.load();
+			for (;;) {
+				unsigned long long head=r >> 32, tail=r & 0xFFFFFFFFull;
+				if (head >= tail)
+					break;
+				unsigned long long mid=tail-(tail-head+1)/2;
+				if (range.compare_exchange_weak(r,(head << 32) | mid)) {
+				// jobs mid,...,tail-1 now belong to the thief, whose deque is empty
+					m_Deque[worker].range=(mid << 32) | tail;
+					++m_iStealNum;
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * The worker with index `worker` runs jobs until all deques are empty;
+	 * in deterministic mode, only jobs from its own deque are run.
+	 * \param[in] worker worker index.
+	 */
+	void work(int worker)
+	{
+		do {
+			for (int job; (job=popJob(worker)) >= 0; )
+				runJob(job,worker);
+		} while (!m_bDeterministic && stealJobs(worker));
+	}
+
+	/**
+	 * The function starts worker threads `m_iThreadNum,...,workerNum-1` if they are not running yet.
+	 * \param[in] workerNum number of workers.
+	 */
+	void startThreads(int workerNum)
+	{
+		for (; m_iThreadNum < workerNum; ++m_iThreadNum) {
+			tagWorker &w=m_Worker[m_iThreadNum];
+			w.pPool=this;
+			w.worker=m_iThreadNum;
+			w.epoch=m_uEpoch;
+			_THREAD_CREATE(m_Thread[m_iThreadNum],workerThread,&w);
+		}
+	}
+
+	/**
+	 * The function makes all worker threads exit, and waits for them.
+	 */
+	void stopThreads()
+	{
+		_MUTEX* pMutex=&m_mutex;
+		_MUTEX_LOCK(pMutex)
+		m_bStop=true;
+		_COND_BROADCAST(&m_condWork)
+		_MUTEX_UNLOCK(pMutex)
+		for (int t=1; t < m_iThreadNum; ++t) {
+			_THREAD_JOIN(m_Thread[t]);
+			_THREAD_CLOSE(m_Thread[t]);
+		}
+		m_iThreadNum=1;
+	}
+
+	/**
+	 * The loop of worker thread `worker`: the thread sleeps until `runJobs()` increments `m_uEpoch`,
+	 * then runs jobs if `worker` is one of the workers of that call.
+	 * \param[in] worker worker index;
+	 * \param[in] epoch value of `m_uEpoch` when the thread was started.
+	 */
+	void serve(int worker, unsigned epoch)
+	{
+		_MUTEX* pMutex=&m_mutex;
+		for (;;) {
+			_MUTEX_LOCK(pMutex)
+			while (!m_bStop && m_uEpoch == epoch)
+				_COND_WAIT(&m_condWork,pMutex)
+			if (m_bStop) {
+				_MUTEX_UNLOCK(pMutex)
+				return;
+			}
+			epoch=m_uEpoch;
+			bool active=(worker < m_iActiveNum);
+			_MUTEX_UNLOCK(pMutex)
+			if (active) {
+				work(worker);
+				_MUTEX_LOCK(pMutex)
+				if (--m_iBusyNum == 0)
+					_COND_SIGNAL(&m_condDone)
+				_MUTEX_UNLOCK(pMutex)
+			}
+		}
+	}
+
+	/**
+	 * The start function of worker threads.
+	 * \param[in] pParam pointer to a `tagWorker` structure.
+	 */
+#ifdef _WINDOWS
+	static unsigned int __stdcall workerThread(void* pParam)
+#else
+	static void* workerThread(void* pParam)
+#endif
+	{
+		tagWorker* pWorker=static_cast<tagWorker*>(pParam);
+		pWorker->pPool->serve(pWorker->worker,pWorker->epoch);
+		return 0;
+	}
+#endif
+};
+
+#endif // __JOBPOOL_H_
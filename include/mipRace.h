@@ -0,0 +1,344 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file mipRace.h Interface for `CMipRace` class
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __MIPRACE_H_
+#define __MIPRACE_H_
+
+#include "except.h"
+#include "cmip.h"
+#include "jobPool.h"
+
+#ifndef __ONE_THREAD_
+#include <atomic>
+#endif
+
+/// Racing of several differently configured solvers.
+/**
+ * The time needed to solve a MIP often varies a lot with LP method, branching rule, and cut settings.
+ * `CMipRace` builds several copies (_contestants_) of the same problem, configures
+ * each of them differently, and solves them in parallel; then the contestant that
+ *   - has proven optimality first, or, if none has,
+ *   - has the best bound on the optimal objective value
+ *
+ * is declared the _winner_. The best solution found by any contestant is available
+ * through `getRecordHolder()`.
+ *
+ * A derived class overloads `newContestant()`, which must build a new instance of the problem
+ * (contestants are built one after another by the calling thread), and optionally `diversify()`.
+ *
+ * As soon as one contestant has finished within its time limit (so it has either solved the problem
+ * or proven that it has no solutions), the race is over, and the other contestants should be stopped.
+ * Stopping is cooperative: a contestant calls `checkRace()` from a callback that is invoked
+ * at every node, for example, from an overloaded `CMIP::propagate()`;
+ * `checkRace()` throws an exception that terminates `optimize()` of that contestant.
+ * Contestants that never call `checkRace()` run to completion (or until their time limits expire).
+ * When the race is over, the best solution found by any contestant is passed to the winner
+ * by `CMIP::changeRecord()`; `handOver()` does the same for any other `CMIP` object that continues solving.
+ *
+ * Typical use:
+ * ~~~
+ * CMyRace race(...);
+ * int k=race.race(4,600); // 4 contestants, each with a time limit of 600 seconds
+ * race.getWinner()->printSolution();
+ * ~~~
+ * where the class of contestants (which receive a pointer to `race` and their indices in `newContestant()`) has
+ * ~~~
+ * bool CMyMip::propagate()
+ * {
+ *     m_pRace->checkRace(m_iContestant); // throws if another contestant has finished
+ *     return CMIP::propagate();
+ * }
+ * ~~~
+ * \remark Each contestant may use several threads (`CMIP::setThreadNum()`); usually,
+ * the product of the number of contestants and the number of threads per contestant
+ * should not exceed the number of cores.
+ */
+class CMipRace: private CJobPool
+{
+	int m_iNum; ///< number of contestants.
+	CMIP** m_ppMip; ///< contestants.
+	int* m_ipFinish; ///< `m_ipFinish[k]` is position of contestant `k` in the order of finishing.
+	CException** m_ppErr; ///< `m_ppErr[k]` is an exception thrown by contestant `k`, or `0`.
+	bool* m_bpStopped; ///< `m_bpStopped[k]` is `true` if contestant `k` has been stopped by `checkRace()`.
+	int m_iWinner; ///< index of the winner, or `-1`.
+	int m_iRecHolder; ///< index of the contestant with the best solution, or `-1`.
+	__LONG m_lTimeLimit; ///< time limit for each contestant.
+	double m_dGap; ///< relative gap passed to `CMIP::optimize()`.
+#ifndef __ONE_THREAD_
+	std::atomic<int> m_iFinishNum; ///< number of contestants that have finished.
+	std::atomic<bool> m_bOver; ///< `true` if a contestant has finished within its time limit.
+#else
+	int m_iFinishNum; ///< number of contestants that have finished.
+	bool m_bOver; ///< `true` if a contestant has finished within its time limit.
+#endif
+
+public:
+	CMipRace(): m_iNum(0), m_ppMip(0), m_ipFinish(0), m_ppErr(0), m_bpStopped(0), m_iWinner(-1), m_iRecHolder(-1),
+		m_lTimeLimit(0l), m_dGap(0.0)
+		{m_iFinishNum=0; m_bOver=false;} ///< The constructor.
+
+	virtual ~CMipRace()
+		{clear();} ///< The destructor.
+
+	/**
+	 * The function builds `num` contestants, configures them by calling `diversify()`,
+	 * and runs them in parallel; then the best solution found is passed to the winner.
+	 * \param[in] num number of contestants;
+	 * \param[in] timeLimit time limit (in seconds) for each contestant; `0l` means no limit;
+	 * \param[in] gap relative gap passed to `CMIP::optimize()`.
+	 * \return index of the winner.
+	 * \throws CMemoryException lack of memory;
+	 * \throws CException any exception thrown by `newContestant()`, or by all contestants.
+	 */
+	int race(int num, __LONG timeLimit=0l, double gap=0.0)
+	{
+		clear();
+		if (num < 1)
+			num=1;
+		if (!(m_ppMip = new(std::nothrow) CMIP*[num]) ||
+			!(m_ppErr = new(std::nothrow) CException*[num]) ||
+			!(m_ipFinish = new(std::nothrow) int[num]) ||
+			!(m_bpStopped = new(std::nothrow) bool[num]))
+			throw new CMemoryException("CMipRace::race");
+		for (int k=0; k < num; ++k) {
+			m_ppMip[k]=0;
+			m_ppErr[k]=0;
+			m_bpStopped[k]=false;
+		}
+		m_iNum=num;
+		for (int k=0; k < num; ++k) {
+			m_ppMip[k]=newContestant(k);
+			diversify(m_ppMip[k],k);
+		}
+		m_lTimeLimit=timeLimit;
+		m_dGap=gap;
+		m_iFinishNum=0;
+		m_bOver=false;
+		setWorkerNum(num);
+		runJobs(num);
+		selectWinner();
+		if (m_iRecHolder >= 0 && m_iRecHolder != m_iWinner)
+			handOver(m_ppMip[m_iWinner]);
+		return m_iWinner;
+	}
+
+	/**
+	 * Contestants call this function from a callback invoked at every node (see the class description).
+	 * \param[in] k index of the calling contestant.
+	 * \throws CException if the race is over; `race()` catches it, and contestant `k` is not ranked.
+	 */
+	void checkRace(int k)
+	{
+		if (m_bOver) {
+			m_bpStopped[k]=true;
+			throw new CException("CMipRace::checkRace: the race is over");
+		}
+	}
+
+	bool isOver() const
+		{return m_bOver;} ///< \return `true` if a contestant has finished within its time limit.
+
+	/**
+	 * The function passes the best solution found in the last race to a problem that continues solving
+	 * (the problem must have the same variables as the contestants).
+	 * \param[in,out] pMip pointer to the problem.
+	 * \return `false` if no solution has been found.
+	 */
+	bool handOver(CMIP* pMip) const
+	{
+		if (m_iRecHolder < 0)
+			return false;
+		double* dpX;
+		int* ipHd;
+		CMIP* pRec=m_ppMip[m_iRecHolder];
+		int n=pRec->getSolution(dpX,ipHd);
+		pMip->changeRecord(pRec->getObjVal(),n,dpX,ipHd);
+		return true;
+	}
+
+	int getContestantNum() const
+		{return m_iNum;} ///< \return number of contestants.
+
+	/**
+	 * \param[in] k contestant index.
+	 * \return pointer to contestant `k`.
+	 */
+	CMIP* getContestant(int k) const
+		{return m_ppMip[k];}
+
+	/**
+	 * \return pointer to the winner of the last race, or `0`.
+	 */
+	CMIP* getWinner() const
+		{return (m_iWinner >= 0)? m_ppMip[m_iWinner]: 0;}
+
+	/**
+	 * \return pointer to the contestant that has found the best solution, or `0` if no solution has been found.
+	 */
+	CMIP* getRecordHolder() const
+		{return (m_iRecHolder >= 0)? m_ppMip[m_iRecHolder]: 0;}
+
+	/**
+	 * \param[in] k contestant index.
+	 * \return position (starting from `0`) of contestant `k` in the order of finishing.
+	 */
+	int getFinishPosition(int k) const
+		{return m_ipFinish[k];}
+
+protected:
+	/**
+	 * The function must build a new instance of the problem to be solved.
+	 * \param[in] k contestant index.
+	 * \return pointer to a problem allocated by `new`; `CMipRace` deletes it.
+	 */
+	virtual CMIP* newContestant(int k)=0;
+
+	/**
+	 * The function configures contestant `k`; contestant `0` keeps default settings.
+	 * Other contestants differ in LP method, branching rule, and cut generation effort.
+	 * \param[in,out] pMip pointer to contestant;
+	 * \param[in] k contestant index.
+	 */
+	virtual void diversify(CMIP* pMip, int k)
+	{
+		if (!k)
+			return;
+		static const CLP::enLPmethod method[3]={CLP::AUTO_DETECT,CLP::DUAL_SIMPLEX,CLP::PRIME_SIMPLEX};
+		pMip->setLPmethod(method[k % 3]);
+		if ((k/3) & 1)
+			pMip->setBranchingRule(CMIP::MAX_SCORE);
+		switch ((k/2) % 3) {
+			case 1: // more cut rounds at the root
+				pMip->setAutoCutRounds(50,3);
+				break;
+			case 2: // no dense cuts
+				pMip->setCutTypePattern(CMIP::_DENSE_GOMORY,0,-1);
+				pMip->setCutTypePattern(CMIP::_DENSE_MOD2,0,-1);
+				break;
+		}
+	}
+
+private:
+	void clear()
+	{
+		if (m_ppMip) {
+			for (int k=0; k < m_iNum; ++k)
+				if (m_ppMip[k])
+					delete m_ppMip[k];
+			delete[] m_ppMip;
+			m_ppMip=0;
+		}
+		if (m_ppErr) {
+			for (int k=0; k < m_iNum; ++k)
+				if (m_ppErr[k])
+					delete m_ppErr[k];
+			delete[] m_ppErr;
+			m_ppErr=0;
+		}
+		if (m_ipFinish) {
+			delete[] m_ipFinish;
+			m_ipFinish=0;
+		}
+		if (m_bpStopped) {
+			delete[] m_bpStopped;
+			m_bpStopped=0;
+		}
+		m_iNum=0;
+		m_iWinner=m_iRecHolder=-1;
+	}
+
+	void runJob(int k, int /*worker*/)
+	{
+		try {
+			m_ppMip[k]->optimize(m_lTimeLimit,m_dGap);
+			if (!m_ppMip[k]->timeLimitStop())
+				m_bOver=true;
+		}
+		catch(CException* pe) {
+			if (m_bpStopped[k])
+				delete pe;
+			else m_ppErr[k]=pe;
+		}
+		m_ipFinish[k]=m_iFinishNum++;
+	}
+
+	/**
+	 * \param[in] a,b objective values or bounds;
+	 * \param[in] sense objective sense (`true` for maximization).
+	 * \return `true` if `a` is a better solution value than `b`.
+	 */
+	static bool better(double a, double b, bool sense)
+		{return (sense)? a > b: a < b;}
+
+	/**
+	 * The function sets `m_iWinner` and `m_iRecHolder`.
+	 * Contestants stopped by `checkRace()` are not ranked, but their solutions are taken into account.
+	 * \throws CException the exception thrown by the first contestant if all contestants have failed.
+	 */
+	void selectWinner()
+	{
+		for (int k=0; k < m_iNum; ++k) {
+			if (m_ppErr[k])
+				continue;
+			CMIP* pMip=m_ppMip[k];
+			if (pMip->isSolution()) {
+				if (m_iRecHolder < 0 || better(pMip->getObjVal(),m_ppMip[m_iRecHolder]->getObjVal(),pMip->getObjSense()))
+					m_iRecHolder=k;
+			}
+		}
+		for (int k=0; k < m_iNum; ++k) {
+			if (m_ppErr[k] || m_bpStopped[k])
+				continue;
+			CMIP* pMip=m_ppMip[k];
+			bool sense=pMip->getObjSense();
+			if (m_iWinner < 0) {
+				m_iWinner=k;
+				continue;
+			}
+			CMIP* pWin=m_ppMip[m_iWinner];
+			bool opt=pMip->isSolution() && pMip->isSolutionOptimal(),
+				optWin=pWin->isSolution() && pWin->isSolutionOptimal();
+			if (opt != optWin) {
+				if (opt)
+					m_iWinner=k;
+			}
+			else if (opt) {
+				if (m_ipFinish[k] < m_ipFinish[m_iWinner])
+					m_iWinner=k;
+			}
+			else if (better(pWin->getObjBound(),pMip->getObjBound(),sense)) // bound of `k` is tighter
+				m_iWinner=k;
+		}
+		if (m_iWinner < 0) { // no contestant has been stopped, as none has finished
+			CException* pe=m_ppErr[0];
+			m_ppErr[0]=0;
+			throw pe;
+		}
+	}
+};
+
+#endif // __MIPRACE_H_
@@ -0,0 +1,526 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file mod2.h Interface for `CMod2Matrix` class
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __MOD2_H_
+#define __MOD2_H_
+
+#include <cstring>
+#include <new>
+#include "except.h"
+#include "Sort.h"
+
+/// Binary matrix for separating {0,1/2}-Chvatal-Gomory cuts.
+/**
+ * Row `i` represents the parities of coefficients and of the right hand side of an integer constraint
+ * whose slack at the LP solution is `s_i`; column `j` represents a variable
+ * whose distance to its nearest bound is `w_j`. For a set of rows \f$U\f$ with odd right hand side sum,
+ * the {0,1/2}-cut obtained by adding the rows of \f$U\f$, dividing by `2`, and rounding down,
+ * is violated by \f$(1-\sum_{i\in U} s_i-\sum_{j\in O} w_j)/2\f$, where \f$O\f$ is the set of odd columns of the sum.
+ *
+ * Rows are packed into 64-bit words, so that adding two rows takes one XOR per 64 entries;
+ * the loops over words are simple enough for compilers to vectorize them (for example, with AVX2).
+ * Each row also keeps the set of original rows it is the sum of.
+ *
+ * `preprocess()` removes
+ *   - rows with slack of at least `1`, which cannot be in a violated cut;
+ *   - columns with zero weight, and zero columns;
+ *   - unit rows (one nonzero column `j`, even right hand side): such a row is used
+ *     to make column `j` even whenever its slack is less than `w_j`, so `w_j` is decreased to the row slack;
+ *   - duplicate columns, whose weights are added;
+ *   - duplicate rows, of which the one with the smallest slack is kept.
+ *
+ * `eliminate()` then transforms the matrix by Gauss-Jordan elimination, pivoting on columns in order of decreasing weight,
+ * so that expensive odd columns are cancelled first. `findCuts()` lists the rows with odd right hand sides
+ * that give violated cuts, and `getCutRows()` returns the original rows of such a cut.
+ */
+class CMod2Matrix
+{
+public:
+	typedef unsigned long long tagWORD; ///< 64 packed entries.
+
+private:
+	int m_iM; ///< number of rows.
+	int m_iN; ///< number of columns.
+	int m_iW; ///< number of words in a row; bit `j` is column `j`, bit `n` is right hand side.
+	int m_iU; ///< number of words in a row combination; bit `i` is original row `i`.
+	tagWORD* m_ipA; ///< `m_ipA+i*m_iW` is row `i`.
+	tagWORD* m_ipU; ///< `m_ipU+i*m_iU` is the set of original rows that sum up to row `i`.
+	tagWORD* m_ipMask; ///< mask of active columns and right hand side.
+	double* m_dpSlack; ///< `m_dpSlack[i]` is slack of original row `i`.
+	double* m_dpRowSlack; ///< `m_dpRowSlack[i]` is upper bound on the total slack of the rows summed up to row `i`.
+	double* m_dpW0; ///< `m_dpW0[j]` is weight of column `j` set by the user.
+	double* m_dpW; ///< `m_dpW[j]` is current weight of column `j`.
+	int* m_ipUnitRow; ///< `m_ipUnitRow[j]` is unit row used to make column `j` even, or `-1`.
+	int* m_ipRep; ///< `m_ipRep[j]` is column identical to column `j` that is kept, or `-1` if `j` has been removed.
+	int m_iRowNum; ///< number of active rows.
+	int* m_ipRow; ///< active rows; after `eliminate()`, rows `m_ipRow[0],...,m_ipRow[rank-1]` are pivot rows.
+	int m_iColNum; ///< number of active columns.
+	int* m_ipCol; ///< active columns.
+	unsigned* m_ipHash; ///< hash values of rows or columns.
+	int* m_ipNext; ///< hash chains.
+	int m_iBucketNum; ///< number of hash buckets (a power of `2`).
+	int* m_ipBucket; ///< `m_ipBucket[h]` is first row or column in bucket `h`, or `-1`.
+	int m_iCutNum; ///< number of cuts found by `findCuts()`.
+	int* m_ipCut; ///< `m_ipCut[k]` is row of the `k`-th cut.
+	double* m_dpViol; ///< `m_dpViol[i]` is violation of the cut given by row `i`.
+	int m_iHeavyRowNum; ///< number of rows removed for large slacks.
+	int m_iZeroColNum; ///< number of zero columns and columns of zero weight removed.
+	int m_iUnitRowNum; ///< number of unit rows removed.
+	int m_iDupColNum; ///< number of duplicate columns removed.
+	int m_iDupRowNum; ///< number of duplicate rows removed.
+
+public:
+	/**
+	 * The constructor.
+	 * \param[in] m number of rows;
+	 * \param[in] n number of columns.
+	 * \throws CMemoryException lack of memory.
+	 */
+	CMod2Matrix(int m, int n): m_iM(m), m_iN(n), m_iW((n >> 6)+1), m_iU(((m+63) >> 6)? ((m+63) >> 6): 1),
+		m_ipA(0), m_ipU(0), m_ipMask(0), m_dpSlack(0), m_dpRowSlack(0), m_dpW0(0), m_dpW(0), m_ipUnitRow(0), m_ipRep(0),
+		m_iRowNum(0), m_ipRow(0), m_iColNum(0), m_ipCol(0), m_ipHash(0), m_ipNext(0), m_iBucketNum(1), m_ipBucket(0),
+		m_iCutNum(0), m_ipCut(0), m_dpViol(0)
+	{
+		int k=(m > n)? m: n;
+		while (m_iBucketNum < k)
+			m_iBucketNum<<=1;
+		if (!(m_ipA = new(std::nothrow) tagWORD[static_cast<size_t>(m)*m_iW+1]) ||
+			!(m_ipU = new(std::nothrow) tagWORD[static_cast<size_t>(m)*m_iU+1]) ||
+			!(m_ipMask = new(std::nothrow) tagWORD[m_iW]) ||
+			!(m_dpSlack = new(std::nothrow) double[m+1]) ||
+			!(m_dpRowSlack = new(std::nothrow) double[m+1]) ||
+			!(m_dpViol = new(std::nothrow) double[m+1]) ||
+			!(m_ipRow = new(std::nothrow) int[m+1]) ||
+			!(m_ipCut = new(std::nothrow) int[m+1]) ||
+			!(m_dpW0 = new(std::nothrow) double[n+1]) ||
+			!(m_dpW = new(std::nothrow) double[n+1]) ||
+			!(m_ipUnitRow = new(std::nothrow) int[n+1]) ||
+			!(m_ipRep = new(std::nothrow) int[n+1]) ||
+			!(m_ipCol = new(std::nothrow) int[n+1]) ||
+			!(m_ipHash = new(std::nothrow) unsigned[k+1]) ||
+			!(m_ipNext = new(std::nothrow) int[k+1]) ||
+			!(m_ipBucket = new(std::nothrow) int[m_iBucketNum])) {
+			clear();
+			throw new CMemoryException("CMod2Matrix::CMod2Matrix");
+		}
+		reset();
+	}
+
+	~CMod2Matrix()
+		{clear();} ///< The destructor.
+
+	/**
+	 * The function makes all entries, slacks, and weights zero.
+	 */
+	void reset()
+	{
+		memset(m_ipA,0,static_cast<size_t>(m_iM)*m_iW*sizeof(tagWORD));
+		memset(m_ipU,0,static_cast<size_t>(m_iM)*m_iU*sizeof(tagWORD));
+		for (int i=0; i < m_iM; ++i) {
+			m_ipU[static_cast<size_t>(i)*m_iU+(i >> 6)]=1ull << (i & 63);
+			m_dpSlack[i]=0.0;
+		}
+		for (int j=0; j < m_iN; ++j) {
+			m_dpW0[j]=0.0;
+			m_ipUnitRow[j]=-1;
+			m_ipRep[j]=j;
+		}
+		m_iRowNum=m_iColNum=m_iCutNum=0;
+		m_iHeavyRowNum=m_iZeroColNum=m_iUnitRowNum=m_iDupColNum=m_iDupRowNum=0;
+	}
+
+	/**
+	 * The function makes entry `(i,j)` odd.
+	 * \param[in] i row;
+	 * \param[in] j column.
+	 */
+	void setEntry(int i, int j)
+		{m_ipA[static_cast<size_t>(i)*m_iW+(j >> 6)]|=1ull << (j & 63);}
+
+	/**
+	 * The function makes the right hand side of row `i` odd.
+	 * \param[in] i row.
+	 */
+	void setRhs(int i)
+		{setEntry(i,m_iN);}
+
+	/**
+	 * \param[in] i row;
+	 * \param[in] s slack of row `i` at the LP solution.
+	 */
+	void setRowSlack(int i, double s)
+		{m_dpSlack[i]=s;}
+
+	/**
+	 * \param[in] j column;
+	 * \param[in] w distance from the value of variable `j` to its nearest bound.
+	 */
+	void setColWeight(int j, double w)
+		{m_dpW0[j]=w;}
+
+	int getHeavyRowNum() const
+		{return m_iHeavyRowNum;} ///< \return number of rows removed for large slacks.
+	int getZeroColNum() const
+		{return m_iZeroColNum;} ///< \return number of zero columns and columns of zero weight removed.
+	int getUnitRowNum() const
+		{return m_iUnitRowNum;} ///< \return number of unit rows removed.
+	int getDupColNum() const
+		{return m_iDupColNum;} ///< \return number of duplicate columns removed.
+	int getDupRowNum() const
+		{return m_iDupRowNum;} ///< \return number of duplicate rows removed.
+	int getRowNum() const
+		{return m_iRowNum;} ///< \return number of rows left after preprocessing.
+	int getColNum() const
+		{return m_iColNum;} ///< \return number of columns left after preprocessing.
+
+	/**
+	 * The function removes rows and columns that are not needed for finding violated cuts.
+	 * \param[in] minViol rows with slacks greater than `1-2*minViol` are removed.
+	 */
+	void preprocess(double minViol=1.0e-3)
+	{
+		m_iRowNum=0;
+		for (int i=0; i < m_iM; ++i) {
+			m_dpRowSlack[i]=m_dpSlack[i];
+			if (m_dpSlack[i] > 1.0-2.0*minViol)
+				++m_iHeavyRowNum;
+			else
+				m_ipRow[m_iRowNum++]=i;
+		}
+		for (int j=0; j < m_iN; ++j)
+			if ((m_dpW[j]=m_dpW0[j]) <= 1.0e-9) {
+				m_ipRep[j]=-1;
+				++m_iZeroColNum;
+			}
+		for (;;) {
+			removeZeroColumns();
+			if (!removeUnitRows())
+				break;
+		}
+		removeDuplicateColumns();
+		removeDuplicateRows();
+	}
+
+	/**
+	 * The function transforms the matrix left after preprocessing by Gauss-Jordan elimination.
+	 * \return rank of the matrix.
+	 */
+	int eliminate()
+	{
+		SORT::decSortDouble(m_iColNum,m_ipCol,m_dpW);
+		int rank=0;
+		for (int c=0; c < m_iColNum && rank < m_iRowNum; ++c) {
+			int j=m_ipCol[c], p=-1;
+			size_t word=j >> 6;
+			tagWORD bit=1ull << (j & 63);
+			for (int r=rank; r < m_iRowNum; ++r) {
+				int i=m_ipRow[r];
+				if ((m_ipA[static_cast<size_t>(i)*m_iW+word] & bit) && (p < 0 || m_dpRowSlack[i] < m_dpRowSlack[m_ipRow[p]]))
+					p=r;
+			}
+			if (p < 0)
+				continue;
+			int ip=m_ipRow[p];
+			m_ipRow[p]=m_ipRow[rank];
+			m_ipRow[rank++]=ip;
+			for (int r=0; r < m_iRowNum; ++r) {
+				int i=m_ipRow[r];
+				if (i != ip && (m_ipA[static_cast<size_t>(i)*m_iW+word] & bit)) {
+					addRow(i,ip);
+					m_dpRowSlack[i]+=m_dpRowSlack[ip];
+				}
+			}
+		}
+		return rank;
+	}
+
+	/**
+	 * The function lists rows with odd right hand sides that give violated cuts.
+	 * \param[in] minViol minimum violation of a cut.
+	 * \return number of cuts found; they are listed in order of decreasing violation.
+	 */
+	int findCuts(double minViol=1.0e-3)
+	{
+		size_t rhsWord=m_iN >> 6;
+		tagWORD rhsBit=1ull << (m_iN & 63);
+		m_iCutNum=0;
+		for (int r=0; r < m_iRowNum; ++r) {
+			int i=m_ipRow[r];
+			const tagWORD* ipA=m_ipA+static_cast<size_t>(i)*m_iW;
+			if (!(ipA[rhsWord] & rhsBit))
+				continue;
+			double s=0.0;
+			const tagWORD* ipU=m_ipU+static_cast<size_t>(i)*m_iU;
+			for (int w=0; w < m_iU && s < 1.0; ++w)
+				for (tagWORD u=ipU[w], l=0; u; u>>=1, ++l)
+					if (u & 1)
+						s+=m_dpSlack[(w << 6)+l];
+			for (int c=0; c < m_iColNum && s < 1.0; ++c) {
+				int j=m_ipCol[c];
+				if (ipA[j >> 6] & (1ull << (j & 63)))
+					s+=m_dpW[j];
+			}
+			if ((m_dpViol[i]=0.5*(1.0-s)) >= minViol)
+				m_ipCut[m_iCutNum++]=i;
+		}
+		SORT::decSortDouble(m_iCutNum,m_ipCut,m_dpViol);
+		return m_iCutNum;
+	}
+
+	int getCutNum() const
+		{return m_iCutNum;} ///< \return number of cuts found by the last call to `findCuts()`.
+
+	/**
+	 * \param[in] k cut index, `0 <= k < getCutNum()`.
+	 * \return violation of cut `k`.
+	 */
+	double getCutViolation(int k) const
+		{return m_dpViol[m_ipCut[k]];}
+
+	/**
+	 * The function lists the original rows whose sum, divided by `2` and rounded down, gives cut `k`.
+	 * \param[in] k cut index, `0 <= k < getCutNum()`;
+	 * \param[out] ipRow array of size `m`.
+	 * \return number of rows.
+	 */
+	int getCutRows(int k, int* ipRow) const
+	{
+		int i=m_ipCut[k], sz=0;
+		const tagWORD* ipA=m_ipA+static_cast<size_t>(i)*m_iW;
+		const tagWORD* ipU=m_ipU+static_cast<size_t>(i)*m_iU;
+		for (int w=0; w < m_iU; ++w)
+			for (tagWORD u=ipU[w], l=0; u; u>>=1, ++l)
+				if (u & 1)
+					ipRow[sz++]=static_cast<int>((w << 6)+l);
+		for (int j=0; j < m_iN; ++j) {
+			int r=m_ipRep[j];
+			if (r >= 0 && m_ipUnitRow[j] >= 0 && (ipA[r >> 6] & (1ull << (r & 63))))
+				ipRow[sz++]=m_ipUnitRow[j];
+		}
+		return sz;
+	}
+
+private:
+	void clear()
+	{
+		delete[] m_ipA;
+		delete[] m_ipU;
+		delete[] m_ipMask;
+		delete[] m_dpSlack;
+		delete[] m_dpRowSlack;
+		delete[] m_dpViol;
+		delete[] m_ipRow;
+		delete[] m_ipCut;
+		delete[] m_dpW0;
+		delete[] m_dpW;
+		delete[] m_ipUnitRow;
+		delete[] m_ipRep;
+		delete[] m_ipCol;
+		delete[] m_ipHash;
+		delete[] m_ipNext;
+		delete[] m_ipBucket;
+		m_ipA=m_ipU=m_ipMask=0;
+		m_dpSlack=m_dpRowSlack=m_dpViol=m_dpW0=m_dpW=0;
+		m_ipRow=m_ipCut=m_ipUnitRow=m_ipRep=m_ipCol=m_ipNext=m_ipBucket=0;
+		m_ipHash=0;
+	}
+
+	/**
+	 * The function adds row `k` to row `i` modulo `2`.
+	 */
+	void addRow(int i, int k)
+	{
+		tagWORD *ipA=m_ipA+static_cast<size_t>(i)*m_iW, *ipU=m_ipU+static_cast<size_t>(i)*m_iU;
+		const tagWORD *ipB=m_ipA+static_cast<size_t>(k)*m_iW, *ipV=m_ipU+static_cast<size_t>(k)*m_iU;
+		for (int w=0; w < m_iW; ++w)
+			ipA[w]^=ipB[w];
+		for (int w=0; w < m_iU; ++w)
+			ipU[w]^=ipV[w];
+	}
+
+	/**
+	 * \return `true` if column `j` is odd in row `i`.
+	 */
+	bool isOdd(int i, int j) const
+		{return (m_ipA[static_cast<size_t>(i)*m_iW+(j >> 6)] >> (j & 63)) & 1;}
+
+	/**
+	 * The function removes columns that are zero in all active rows, and clears the bits of removed columns;
+	 * `m_ipCol` is set to the list of the remaining columns.
+	 */
+	void removeZeroColumns()
+	{
+		memset(m_ipMask,0,m_iW*sizeof(tagWORD));
+		for (int r=0; r < m_iRowNum; ++r) {
+			const tagWORD* ipA=m_ipA+static_cast<size_t>(m_ipRow[r])*m_iW;
+			for (int w=0; w < m_iW; ++w)
+				m_ipMask[w]|=ipA[w];
+		}
+		m_iColNum=0;
+		for (int j=0; j < m_iN; ++j)
+			if (m_ipRep[j] == j) {
+				if ((m_ipMask[j >> 6] >> (j & 63)) & 1)
+					m_ipCol[m_iColNum++]=j;
+				else {
+					m_ipRep[j]=-1;
+					++m_iZeroColNum;
+				}
+			}
+		memset(m_ipMask,0,m_iW*sizeof(tagWORD));
+		for (int c=0; c < m_iColNum; ++c)
+			m_ipMask[m_ipCol[c] >> 6]|=1ull << (m_ipCol[c] & 63);
+		m_ipMask[m_iN >> 6]|=1ull << (m_iN & 63);
+		for (int r=0; r < m_iRowNum; ++r) {
+			tagWORD* ipA=m_ipA+static_cast<size_t>(m_ipRow[r])*m_iW;
+			for (int w=0; w < m_iW; ++w)
+				ipA[w]&=m_ipMask[w];
+		}
+	}
+
+	/**
+	 * The function removes unit rows and rows with no odd entries.
+	 * \return `true` if some row has been removed.
+	 */
+	bool removeUnitRows()
+	{
+		int num=0;
+		for (int r=0; r < m_iRowNum; ++r) {
+			int i=m_ipRow[r], j=-1, l=0;
+			const tagWORD* ipA=m_ipA+static_cast<size_t>(i)*m_iW;
+			for (int w=0; w < m_iW && l < 2; ++w)
+				for (tagWORD a=ipA[w], b=0; a && l < 2; a>>=1, ++b)
+					if (a & 1) {
+						j=static_cast<int>((w << 6)+b);
+						++l;
+					}
+			if (l == 0 || (l == 1 && j < m_iN)) {
+				if (l == 1) {
+					if (m_dpSlack[i] < m_dpW[j]) {
+						m_dpW[j]=m_dpSlack[i];
+						m_ipUnitRow[j]=i;
+					}
+					++m_iUnitRowNum;
+				}
+				continue;
+			}
+			m_ipRow[num++]=i;
+		}
+		bool removed=(num < m_iRowNum);
+		m_iRowNum=num;
+		return removed;
+	}
+
+	/**
+	 * The function removes columns identical to other columns in all active rows, and adds their weights.
+	 */
+	void removeDuplicateColumns()
+	{
+		for (int c=0; c < m_iColNum; ++c)
+			m_ipHash[m_ipCol[c]]=2166136261u;
+		for (int r=0; r < m_iRowNum; ++r) {
+			int i=m_ipRow[r];
+			for (int c=0; c < m_iColNum; ++c) {
+				int j=m_ipCol[c];
+				if (isOdd(i,j))
+					m_ipHash[j]=(m_ipHash[j] ^ static_cast<unsigned>(r))*16777619u;
+			}
+		}
+		for (int h=0; h < m_iBucketNum; ++h)
+			m_ipBucket[h]=-1;
+		int num=0;
+		for (int c=0; c < m_iColNum; ++c) {
+			int j=m_ipCol[c], h=static_cast<int>(m_ipHash[j] & static_cast<unsigned>(m_iBucketNum-1)), k=m_ipBucket[h];
+			for (; k >= 0; k=m_ipNext[k])
+				if (m_ipHash[k] == m_ipHash[j] && sameColumns(j,k))
+					break;
+			if (k >= 0) {
+				m_dpW[k]+=m_dpW[j];
+				m_ipRep[j]=k;
+				++m_iDupColNum;
+				continue;
+			}
+			m_ipNext[j]=m_ipBucket[h];
+			m_ipBucket[h]=j;
+			m_ipCol[num++]=j;
+		}
+		if (num < m_iColNum) {
+			for (int j=0; j < m_iN; ++j)
+				if (m_ipRep[j] >= 0 && m_ipRep[j] != j)
+					m_ipMask[j >> 6]&=~(1ull << (j & 63));
+			m_iColNum=num;
+			for (int r=0; r < m_iRowNum; ++r) {
+				tagWORD* ipA=m_ipA+static_cast<size_t>(m_ipRow[r])*m_iW;
+				for (int w=0; w < m_iW; ++w)
+					ipA[w]&=m_ipMask[w];
+			}
+		}
+	}
+
+	/**
+	 * \return `true` if columns `j` and `k` are identical in all active rows.
+	 */
+	bool sameColumns(int j, int k) const
+	{
+		for (int r=0; r < m_iRowNum; ++r)
+			if (isOdd(m_ipRow[r],j) != isOdd(m_ipRow[r],k))
+				return false;
+		return true;
+	}
+
+	/**
+	 * The function removes rows identical to other rows, keeping the row with the smallest slack.
+	 */
+	void removeDuplicateRows()
+	{
+		SORT::incSortDouble(m_iRowNum,m_ipRow,m_dpSlack);
+		for (int h=0; h < m_iBucketNum; ++h)
+			m_ipBucket[h]=-1;
+		int num=0;
+		for (int r=0; r < m_iRowNum; ++r) {
+			int i=m_ipRow[r];
+			const tagWORD* ipA=m_ipA+static_cast<size_t>(i)*m_iW;
+			unsigned hv=2166136261u;
+			for (int w=0; w < m_iW; ++w)
+				hv=(hv ^ static_cast<unsigned>(ipA[w] ^ (ipA[w] >> 32)))*16777619u;
+			int h=static_cast<int>(hv & static_cast<unsigned>(m_iBucketNum-1)), k=m_ipBucket[h];
+			for (; k >= 0; k=m_ipNext[k])
+				if (m_ipHash[k] == hv && !memcmp(ipA,m_ipA+static_cast<size_t>(k)*m_iW,m_iW*sizeof(tagWORD)))
+					break;
+			if (k >= 0) {
+				++m_iDupRowNum;
+				continue;
+			}
+			m_ipHash[i]=hv;
+			m_ipNext[i]=m_ipBucket[h];
+			m_ipBucket[h]=i;
+			m_ipRow[num++]=i;
+		}
+		m_iRowNum=num;
+	}
+};
+
+#endif // __MOD2_H_
@@ -0,0 +1,500 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file nodeStore.h Interface for `CNodeCoder` and `CNodeStore` classes
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __NODESTORE_H_
+#define __NODESTORE_H_
+
+#include <cstdio>
+#include <cstring>
+#include <new>
+#ifndef _WINDOWS
+#include <sys/types.h>
+#endif
+#include "except.h"
+
+/// Compact encoding of node data.
+/**
+ * Node data usually differ from the data of the parent node only in a few positions.
+ * `CNodeCoder` writes such differences into a byte buffer:
+ *   - unsigned integers are written as _varints_ (7 bits per byte, the high bit means "more bytes follow");
+ *   - indices of changed entries are written as differences of consecutive indices;
+ *   - integral bounds are written as varints, other bounds take 9 bytes;
+ *   - bit arrays (for example, bases stored bitwise or branching flags) are written as
+ *     the list of words that differ from the parent words.
+ *
+ * Typical use in `storeNodeData()`:
+ * ~~~
+ * m_coder.clear();
+ * m_coder.putBoundDiff(n,dpLo0,dpUp0,dpLo,dpUp);
+ * // copy m_coder.getSize() bytes starting at m_coder.getData()
+ * ~~~
+ * and in `restoreNodeData()`:
+ * ~~~
+ * const unsigned char* p=CNodeCoder::getBoundDiff(pData,dpLo,dpUp); // dpLo, dpUp hold bounds of the parent
+ * ~~~
+ */
+class CNodeCoder
+{
+	unsigned char* m_cpBuf; ///< buffer for encoded data.
+	int m_iSize; ///< size of `m_cpBuf`.
+	int m_iLen; ///< number of bytes written.
+
+public:
+	CNodeCoder(): m_cpBuf(0), m_iSize(0), m_iLen(0)
+		{} ///< The constructor.
+
+	~CNodeCoder()
+	{
+		if (m_cpBuf)
+			delete[] m_cpBuf;
+	} ///< The destructor.
+
+	void clear()
+		{m_iLen=0;} ///< The function empties the buffer.
+	int getSize() const
+		{return m_iLen;} ///< \return number of bytes written.
+	const unsigned char* getData() const
+		{return m_cpBuf;} ///< \return pointer to encoded data.
+
+	/**
+	 * \param[in] v value to be written as a varint.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void putUInt(unsigned v)
+	{
+		reserve(5);
+		while (v >= 0x80) {
+			m_cpBuf[m_iLen++]=static_cast<unsigned char>(v | 0x80);
+			v>>=7;
+		}
+		m_cpBuf[m_iLen++]=static_cast<unsigned char>(v);
+	}
+
+	/**
+	 * \param[in] v value to be written as a zigzag encoded varint.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void putInt(int v)
+		{putUInt((static_cast<unsigned>(v) << 1) ^ static_cast<unsigned>(v >> 31));}
+
+	/**
+	 * \param[in] v value to be written; integral values of small magnitude take 1 to 5 bytes.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void putDouble(double v)
+	{
+		if (v > -0x3FFFFFFF && v < 0x3FFFFFFF && v == static_cast<int>(v)) {
+			int i=static_cast<int>(v);
+			putUInt(((static_cast<unsigned>(i) << 1) ^ static_cast<unsigned>(i >> 31)) << 1);
+		}
+		else {
+			putUInt(1);
+			reserve(sizeof(double));
+			memcpy(m_cpBuf+m_iLen,&v,sizeof(double));
+			m_iLen+=sizeof(double);
+		}
+	}
+
+	/**
+	 * The function writes the bounds of variables that differ from the bounds in a reference (parent) node.
+	 * \param[in] n number of variables;
+	 * \param[in] dpLo0,dpUp0 arrays of size `n`, lower and upper bounds in the reference node;
+	 * \param[in] dpLo,dpUp arrays of size `n`, lower and upper bounds to be encoded.
+	 * \throws CMemoryException lack of memory.
+	 * \sa getBoundDiff().
+	 */
+	void putBoundDiff(int n, const double* dpLo0, const double* dpUp0, const double* dpLo, const double* dpUp)
+	{
+		int k=0;
+		for (int i=0; i < n; ++i)
+			if (dpLo[i] != dpLo0[i] || dpUp[i] != dpUp0[i])
+				++k;
+		putUInt(k);
+		for (int prev=0, i=0; i < n; ++i) {
+			unsigned flag=((dpLo[i] != dpLo0[i])? 1: 0) | ((dpUp[i] != dpUp0[i])? 2: 0);
+			if (flag) {
+				putUInt((static_cast<unsigned>(i-prev) << 2) | flag);
+				if (flag & 1)
+					putDouble(dpLo[i]);
+				if (flag & 2)
+					putDouble(dpUp[i]);
+				prev=i;
+			}
+		}
+	}
+
+	/**
+	 * The function writes the words of a bit array that differ from the words of a reference array.
+	 * \param[in] n number of words;
+	 * \param[in] upRef,upW arrays of size `n`, reference array and array to be encoded.
+	 * \throws CMemoryException lack of memory.
+	 * \sa getWordDiff().
+	 */
+	void putWordDiff(int n, const unsigned* upRef, const unsigned* upW)
+	{
+		int k=0;
+		for (int i=0; i < n; ++i)
+			if (upW[i] != upRef[i])
+				++k;
+		putUInt(k);
+		for (int prev=0, i=0; i < n; ++i) {
+			if (upW[i] != upRef[i]) {
+				putUInt(i-prev);
+				putUInt(upW[i] ^ upRef[i]);
+				prev=i;
+			}
+		}
+	}
+
+	/**
+	 * \param[in] p pointer to a varint;
+	 * \param[out] v decoded value.
+	 * \return pointer to the byte following the varint.
+	 */
+	static const unsigned char* getUInt(const unsigned char* p, unsigned &v)
+	{
+		v=0;
+		for (int s=0; ; s+=7) {
+			v|=static_cast<unsigned>(*p & 0x7F) << s;
+			if (!(*p++ & 0x80))
+				break;
+		}
+		return p;
+	}
+
+	/**
+	 * \param[in] p pointer to a value written by `putInt()`;
+	 * \param[out] v decoded value.
+	 * \return pointer to the byte following the value.
+	 */
+	static const unsigned char* getInt(const unsigned char* p, int &v)
+	{
+		unsigned u;
+		p=getUInt(p,u);
+		v=static_cast<int>((u >> 1) ^ (~(u & 1)+1));
+		return p;
+	}
+
+	/**
+	 * \param[in] p pointer to a value written by `putDouble()`;
+	 * \param[out] v decoded value.
+	 * \return pointer to the byte following the value.
+	 */
+	static const unsigned char* getDouble(const unsigned char* p, double &v)
+	{
+		unsigned u;
+		p=getUInt(p,u);
+		if (u & 1) {
+			memcpy(&v,p,sizeof(double));
+			return p+sizeof(double);
+		}
+		u>>=1;
+		v=static_cast<int>((u >> 1) ^ (~(u & 1)+1));
+		return p;
+	}
+
+	/**
+	 * The function applies bound changes written by `putBoundDiff()`.
+	 * \param[in] p pointer to encoded data;
+	 * \param[in,out] dpLo,dpUp on input, bounds of the reference node; on output, decoded bounds.
+	 * \return pointer to the byte following the encoded data.
+	 */
+	static const unsigned char* getBoundDiff(const unsigned char* p, double* dpLo, double* dpUp)
+	{
+		unsigned k, u;
+		p=getUInt(p,k);
+		for (int i=0; k; --k) {
+			p=getUInt(p,u);
+			i+=u >> 2;
+			if (u & 1)
+				p=getDouble(p,dpLo[i]);
+			if (u & 2)
+				p=getDouble(p,dpUp[i]);
+		}
+		return p;
+	}
+
+	/**
+	 * The function applies word changes written by `putWordDiff()`.
+	 * \param[in] p pointer to encoded data;
+	 * \param[in,out] upW on input, reference array; on output, decoded array.
+	 * \return pointer to the byte following the encoded data.
+	 */
+	static const unsigned char* getWordDiff(const unsigned char* p, unsigned* upW)
+	{
+		unsigned k, u, x;
+		p=getUInt(p,k);
+		for (int i=0; k; --k) {
+			p=getUInt(p,u);
+			p=getUInt(p,x);
+			upW[i+=u]^=x;
+		}
+		return p;
+	}
+
+private:
+	/**
+	 * The function makes sure that `sz` more bytes can be written.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void reserve(int sz)
+	{
+		if (m_iLen+sz > m_iSize) {
+			int size=2*m_iSize+sz+64;
+			unsigned char* cpBuf=new(std::nothrow) unsigned char[size];
+			if (!cpBuf)
+				throw new CMemoryException("CNodeCoder::reserve");
+			if (m_cpBuf) {
+				memcpy(cpBuf,m_cpBuf,m_iLen);
+				delete[] m_cpBuf;
+			}
+			m_cpBuf=cpBuf;
+			m_iSize=size;
+		}
+	}
+};
+
+/// Storage of node records with bounded memory.
+/**
+ * `CNodeStore` keeps byte records (for example, node data encoded by `CNodeCoder`) in memory
+ * until their total size exceeds a given limit; then the records that have not been used
+ * for the longest time (_cold_ records) are written to a file on local disk, and memory is freed.
+ * A spilled record is read back when `get()` is called for it.
+ *
+ * Records are appended to the file, and space of removed spilled records is not reused;
+ * the file is deleted when the store is destroyed.
+ *
+ * \attention `CNodeStore` is not thread-safe; each thread of the solver should use its own store.
+ */
+class CNodeStore
+{
+	/// Record descriptor.
+	struct tagRecord {
+		unsigned char* pData; ///< record data, or `0` if the record has been spilled to file or removed.
+		int size; ///< record size in bytes, or `-1` if the descriptor is free.
+		long long filePos; ///< position of spilled record in file.
+		unsigned long long lastUse; ///< value of `m_uClock` when the record was used last time.
+	};
+
+	tagRecord* m_pRec; ///< record descriptors.
+	int m_iRecNum; ///< number of used descriptors.
+	int m_iMaxRecNum; ///< size of `m_pRec`.
+	int m_iFreeRec; ///< first free descriptor (free descriptors are linked through `filePos`).
+	size_t m_uMemSize; ///< total size of records kept in memory.
+	size_t m_uMemLimit; ///< memory limit, `0` means no limit.
+	unsigned long long m_uClock; ///< counts calls to `put()` and `get()`.
+	FILE* m_pFile; ///< spill file.
+	long long m_llFileSize; ///< size of spill file (64-bit, as the file may exceed 2GB).
+	int m_iSpillNum; ///< number of records written to file.
+	int m_iLoadNum; ///< number of records read from file.
+
+public:
+	/**
+	 * \param[in] memLimit memory limit in bytes; if `memLimit=0`, records are never spilled.
+	 */
+	CNodeStore(size_t memLimit=0): m_pRec(0), m_iRecNum(0), m_iMaxRecNum(0), m_iFreeRec(-1),
+		m_uMemSize(0), m_uMemLimit(memLimit), m_uClock(0), m_pFile(0), m_llFileSize(0),
+		m_iSpillNum(0), m_iLoadNum(0)
+		{} ///< The constructor.
+
+	~CNodeStore()
+	{
+		if (m_pRec) {
+			for (int i=0; i < m_iRecNum; ++i)
+				if (m_pRec[i].pData)
+					delete[] m_pRec[i].pData;
+			delete[] m_pRec;
+		}
+		if (m_pFile)
+			fclose(m_pFile);
+	} ///< The destructor.
+
+	/**
+	 * \param[in] memLimit memory limit in bytes; if `memLimit=0`, records are never spilled.
+	 */
+	void setMemLimit(size_t memLimit)
+		{m_uMemLimit=memLimit;}
+
+	size_t getMemSize() const
+		{return m_uMemSize;} ///< \return total size of records kept in memory.
+	int getSpillNum() const
+		{return m_iSpillNum;} ///< \return number of records written to file.
+	int getLoadNum() const
+		{return m_iLoadNum;} ///< \return number of records read from file.
+
+	/**
+	 * The function stores a record.
+	 * \param[in] size record size in bytes;
+	 * \param[in] pData record data.
+	 * \return record handle.
+	 * \throws CMemoryException lack of memory;
+	 * \throws CFileException if records cannot be written to file.
+	 */
+	int put(int size, const unsigned char* pData)
+	{
+		int id;
+		if (m_iFreeRec >= 0) {
+			id=m_iFreeRec;
+			m_iFreeRec=static_cast<int>(m_pRec[id].filePos);
+		}
+		else {
+			if (m_iRecNum == m_iMaxRecNum)
+				reallocRecords();
+			id=m_iRecNum++;
+		}
+		tagRecord &rec=m_pRec[id];
+		if (!(rec.pData = new(std::nothrow) unsigned char[size > 0? size: 1]))
+			throw new CMemoryException("CNodeStore::put");
+		memcpy(rec.pData,pData,size);
+		rec.size=size;
+		rec.filePos=-1;
+		rec.lastUse=++m_uClock;
+		m_uMemSize+=size;
+		if (m_uMemLimit && m_uMemSize > m_uMemLimit)
+			spill(id);
+		return id;
+	}
+
+	/**
+	 * The function returns a record; if the record has been spilled, it is read from file.
+	 * \param[in] id record handle;
+	 * \param[out] size record size in bytes.
+	 * \return pointer to record data, which is valid until the next call to `put()`, `get()`, or `remove()`.
+	 * \throws CMemoryException lack of memory;
+	 * \throws CFileException if records cannot be read from or written to file.
+	 */
+	const unsigned char* get(int id, int &size)
+	{
+		tagRecord &rec=m_pRec[id];
+		rec.lastUse=++m_uClock;
+		size=rec.size;
+		if (!rec.pData) {
+			if (!(rec.pData = new(std::nothrow) unsigned char[size > 0? size: 1]))
+				throw new CMemoryException("CNodeStore::get");
+			if (seek(rec.filePos) ||
+				fread(rec.pData,1,size,m_pFile) != static_cast<size_t>(size))
+				throw new CFileException("CNodeStore::get","spill file");
+			++m_iLoadNum;
+			m_uMemSize+=size;
+			if (m_uMemLimit && m_uMemSize > m_uMemLimit)
+				spill(id);
+		}
+		return m_pRec[id].pData;
+	}
+
+	/**
+	 * The function deletes a record.
+	 * \param[in] id record handle.
+	 */
+	void remove(int id)
+	{
+		tagRecord &rec=m_pRec[id];
+		if (rec.pData) {
+			delete[] rec.pData;
+			rec.pData=0;
+			m_uMemSize-=rec.size;
+		}
+		rec.size=-1;
+		rec.filePos=m_iFreeRec;
+		m_iFreeRec=id;
+	}
+
+private:
+	/**
+	 * The function moves the position of the spill file; `fseek()` takes a `long`,
+	 * which is 32-bit on Windows.
+	 * \param[in] pos position in file.
+	 * \return `0` on success.
+	 */
+	int seek(long long pos)
+	{
+#ifdef _WINDOWS
+		return _fseeki64(m_pFile,pos,SEEK_SET);
+#else
+		return fseeko(m_pFile,static_cast<off_t>(pos),SEEK_SET);
+#endif
+	}
+
+	/**
+	 * The function doubles the number of record descriptors.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void reallocRecords()
+	{
+		int maxRecNum=(m_iMaxRecNum)? 2*m_iMaxRecNum: 256;
+		tagRecord* pRec=new(std::nothrow) tagRecord[maxRecNum];
+		if (!pRec)
+			throw new CMemoryException("CNodeStore::reallocRecords");
+		if (m_pRec) {
+			memcpy(pRec,m_pRec,m_iRecNum*sizeof(tagRecord));
+			delete[] m_pRec;
+		}
+		m_pRec=pRec;
+		m_iMaxRecNum=maxRecNum;
+	}
+
+	/**
+	 * The function writes cold records to file until memory used by records
+	 * is reduced to three quarters of the limit. Each pass over records spills
+	 * the older half (by time of last use) of the records in memory.
+	 * \param[in] hot handle of the record that must stay in memory.
+	 * \throws CFileException if records cannot be written to file.
+	 */
+	void spill(int hot)
+	{
+		if (!m_pFile && !(m_pFile=tmpfile()))
+			throw new CFileException("CNodeStore::spill","spill file");
+		size_t target=m_uMemLimit-m_uMemLimit/4;
+		while (m_uMemSize > target) {
+			unsigned long long oldest=m_uClock;
+			for (int i=0; i < m_iRecNum; ++i)
+				if (i != hot && m_pRec[i].pData && m_pRec[i].lastUse < oldest)
+					oldest=m_pRec[i].lastUse;
+			if (oldest == m_uClock)
+				break; // only `hot` is in memory
+			unsigned long long threshold=oldest+(m_uClock-oldest)/2;
+			for (int i=0; i < m_iRecNum && m_uMemSize > target; ++i) {
+				tagRecord &rec=m_pRec[i];
+				if (i == hot || !rec.pData || rec.lastUse > threshold)
+					continue;
+				if (rec.filePos < 0) { // a record read back from file is not written again
+					if (seek(m_llFileSize) ||
+						fwrite(rec.pData,1,rec.size,m_pFile) != static_cast<size_t>(rec.size))
+						throw new CFileException("CNodeStore::spill","spill file");
+					rec.filePos=m_llFileSize;
+					m_llFileSize+=rec.size;
+					++m_iSpillNum;
+				}
+				delete[] rec.pData;
+				rec.pData=0;
+				m_uMemSize-=rec.size;
+			}
+		}
+	}
+};
+
+#endif // __NODESTORE_H_
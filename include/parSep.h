@@ -0,0 +1,251 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file parSep.h Interface for `CParallelSeparator` class
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __PARSEP_H_
+#define __PARSEP_H_
+
+#include <new>
+#include "except.h"
+#include "lp.h"
+#include "jobPool.h"
+#include "cutBuffer.h"
+#include "cutHash.h"
+#include "cutSel.h"
+
+/// Several separators run concurrently in one cut round.
+/**
+ * Separators only read the LP solution, so they can run in parallel. `CParallelSeparator`
+ * runs separators `0,...,sepNum-1` as jobs of a `CJobPool`; separator `s` writes its cuts into its own `CCutBuffer`.
+ * When all separators have finished, the buffers are merged in the order of separator indices
+ * (so the result does not depend on thread timing), and cuts that are positive multiples
+ * of cuts already merged are dropped. If a set of known cuts is attached (see `setKnownCuts()`),
+ * cuts found in that set are dropped as well, and the returned cuts are inserted into it,
+ * so cuts generated in previous rounds are not returned again. If a `CCutSelector` is attached (see `setSelector()`),
+ * only the cuts it selects are returned.
+ *
+ * A derived class overloads `runSeparator()`. Typical use in an overloaded `CMIP::separate()`:
+ * ~~~
+ * int num=m_pSep->separate(n,dpX,ipColHd);
+ * if (genFlag)
+ *     for (int k=0; k < num; ++k) {
+ *         sz=m_pSep->getCut(k,hd,type,b1,b2,dpVal,ipCol);
+ *         safeAddCut(hd,type,b1,b2,sz,dpVal,ipCol);
+ *     }
+ * ~~~
+ * Separators running concurrently must not modify shared data (or must protect it themselves);
+ * per-thread scratch memory can be indexed by the worker index passed to `runSeparator()`.
+ */
+class CParallelSeparator: private CJobPool
+{
+	int m_iSepNum; ///< number of separators.
+	CCutBuffer** m_ppBuf; ///< `m_ppBuf[s]` is buffer of separator `s`.
+	CException** m_ppErr; ///< `m_ppErr[s]` is exception thrown by separator `s`, or `0`.
+	int m_iN; ///< number of columns in the LP solution passed to `separate()`.
+	const double* m_dpX; ///< LP solution passed to `separate()`.
+	const CLP::tagHANDLE* m_ipColHd; ///< column handles passed to `separate()`.
+	CCutHashSet* m_pMerged; ///< merged cuts.
+	CCutHashSet* m_pKnown; ///< cuts returned in previous rounds, or `0`.
+	CCutSelector* m_pSel; ///< cut selector, or `0`.
+	int m_iCutNum; ///< number of cuts returned by the last call to `separate()`.
+	int m_iFoundNum; ///< number of cuts found by all separators in the last call to `separate()`.
+	int m_iDupNum; ///< total number of duplicate cuts dropped.
+
+public:
+	/**
+	 * The constructor.
+	 * \param[in] sepNum number of separators;
+	 * \param[in] workerNum number of threads.
+	 * \throws CMemoryException lack of memory.
+	 */
+	CParallelSeparator(int sepNum, int workerNum): m_iSepNum(sepNum), m_ppBuf(0), m_ppErr(0),
+		m_iN(0), m_dpX(0), m_ipColHd(0), m_pMerged(0), m_pKnown(0), m_pSel(0), m_iCutNum(0),
+		m_iFoundNum(0), m_iDupNum(0)
+	{
+		if (!(m_ppBuf = new(std::nothrow) CCutBuffer*[sepNum]) ||
+			!(m_ppErr = new(std::nothrow) CException*[sepNum])) {
+			clear();
+			throw new CMemoryException("CParallelSeparator::CParallelSeparator");
+		}
+		for (int s=0; s < sepNum; ++s) {
+			m_ppBuf[s]=0;
+			m_ppErr[s]=0;
+		}
+		try {
+			for (int s=0; s < sepNum; ++s)
+				m_ppBuf[s]=new CCutBuffer();
+			m_pMerged=new CCutHashSet();
+		}
+		catch(CException* pe) {
+			clear();
+			throw pe;
+		}
+		setWorkerNum(workerNum);
+	}
+
+	virtual ~CParallelSeparator()
+		{clear();} ///< The destructor.
+
+	using CJobPool::setWorkerNum;
+	using CJobPool::getWorkerNum;
+	using CJobPool::setDeterministic;
+
+	/**
+	 * \param[in] pSel pointer to a cut selector applied to merged cuts, or `0`.
+	 */
+	void setSelector(CCutSelector* pSel)
+		{m_pSel=pSel;}
+
+	/**
+	 * \param[in] pKnown pointer to a set of known cuts, or `0`; when cuts are deleted from the matrix,
+	 * the user should erase them from this set, or reset the set.
+	 */
+	void setKnownCuts(CCutHashSet* pKnown)
+		{m_pKnown=pKnown;}
+
+	/**
+	 * The function runs all separators for a given LP solution, and merges their cuts.
+	 * \param[in] n number of columns;
+	 * \param[in] dpX,ipColHd `dpX[i]` is value of variable with handle `ipColHd[i]`.
+	 * \return number of distinct cuts found, or, if a selector is attached, number of selected cuts.
+	 * \throws CMemoryException lack of memory.
+	 * \throws CException the exception thrown by the first failed separator.
+	 */
+	int separate(int n, const double* dpX, const CLP::tagHANDLE* ipColHd)
+	{
+		m_iN=n;
+		m_dpX=dpX;
+		m_ipColHd=ipColHd;
+		for (int s=0; s < m_iSepNum; ++s)
+			m_ppBuf[s]->reset();
+		runJobs(m_iSepNum);
+		for (int s=0; s < m_iSepNum; ++s)
+			if (m_ppErr[s]) {
+				CException* pe=m_ppErr[s];
+				m_ppErr[s]=0;
+				for (int t=s+1; t < m_iSepNum; ++t)
+					if (m_ppErr[t]) {
+						delete m_ppErr[t];
+						m_ppErr[t]=0;
+					}
+				throw pe;
+			}
+		merge();
+		const CCutBuffer &merged=m_pMerged->getBuffer();
+		m_iCutNum=(m_pSel)? m_pSel->select(merged,n,dpX): merged.getCutNum();
+		if (m_pKnown)
+			for (int k=0; k < m_iCutNum; ++k)
+				m_pKnown->insert(merged,(m_pSel)? m_pSel->getSelected(k): k);
+		return m_iCutNum;
+	}
+
+	int getCutNum() const
+		{return m_iCutNum;} ///< \return number of cuts returned by the last call to `separate()`.
+	int getFoundNum() const
+		{return m_iFoundNum;} ///< \return number of cuts found by all separators in the last call to `separate()`.
+	int getDupNum() const
+		{return m_iDupNum;} ///< \return total number of duplicate cuts dropped.
+
+	/**
+	 * \param[in] k index of returned cut, `0 <= k < getCutNum()`;
+	 * \param[out] hd,type,b1,b2,dpVal,ipCol arguments for `CMIP::addCut()`.
+	 * \return number of nonzero entries.
+	 */
+	int getCut(int k, CLP::tagHANDLE &hd, unsigned &type, double &b1, double &b2, double* &dpVal, int* &ipCol) const
+		{return m_pMerged->getBuffer().getCut((m_pSel)? m_pSel->getSelected(k): k,hd,type,b1,b2,dpVal,ipCol);}
+
+	/**
+	 * \param[in] s separator index.
+	 * \return pointer to the buffer of separator `s`.
+	 */
+	CCutBuffer* getBuffer(int s) const
+		{return m_ppBuf[s];}
+
+protected:
+	/**
+	 * The function runs separator `s`; it must write cuts into `buf`.
+	 * \param[in] s separator index;
+	 * \param[in] worker index of the thread running the separator;
+	 * \param[out] buf buffer for cuts;
+	 * \param[in] n number of columns;
+	 * \param[in] dpX,ipColHd `dpX[i]` is value of variable with handle `ipColHd[i]`.
+	 */
+	virtual void runSeparator(int s, int worker, CCutBuffer &buf, int n, const double* dpX, const CLP::tagHANDLE* ipColHd)=0;
+
+private:
+	void clear()
+	{
+		if (m_ppBuf) {
+			for (int s=0; s < m_iSepNum; ++s)
+				if (m_ppBuf[s])
+					delete m_ppBuf[s];
+			delete[] m_ppBuf;
+			m_ppBuf=0;
+		}
+		if (m_ppErr) {
+			for (int s=0; s < m_iSepNum; ++s)
+				if (m_ppErr[s])
+					delete m_ppErr[s];
+			delete[] m_ppErr;
+			m_ppErr=0;
+		}
+		if (m_pMerged) {
+			delete m_pMerged;
+			m_pMerged=0;
+		}
+	}
+
+	void runJob(int s, int worker)
+	{
+		try {
+			runSeparator(s,worker,*m_ppBuf[s],m_iN,m_dpX,m_ipColHd);
+		}
+		catch(CException* pe) {
+			m_ppErr[s]=pe;
+		}
+	}
+
+	/**
+	 * The function copies cuts of all buffers to `m_pMerged`, dropping duplicates.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void merge()
+	{
+		int num=0;
+		for (int s=0; s < m_iSepNum; ++s)
+			num+=m_ppBuf[s]->getCutNum();
+		m_iFoundNum=num;
+		m_pMerged->reset();
+		for (int s=0; s < m_iSepNum; ++s) {
+			CCutBuffer* pBuf=m_ppBuf[s];
+			for (int k=0; k < pBuf->getCutNum(); ++k)
+				if ((m_pKnown && m_pKnown->find(*pBuf,k) >= 0) || m_pMerged->insert(*pBuf,k) < 0)
+					++m_iDupNum;
+		}
+	}
+};
+
+#endif // __PARSEP_H_
@@ -0,0 +1,560 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file probing.h Interface for `CParallelProber` class
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __PROBING_H_
+#define __PROBING_H_
+
+#include <new>
+#include "except.h"
+#include "jobPool.h"
+#include "rowProp.h"
+
+/// Probing of binary variables on several threads.
+/**
+ * Probing a binary variable \f$x_j\f$ means propagating \f$x_j=0\f$ and \f$x_j=1\f$ in turn. Then
+ *   - if both branches are infeasible, so is the problem;
+ *   - if one branch is infeasible, \f$x_j\f$ is fixed to the other value;
+ *   - a bound implied in both branches is valid for the problem;
+ *   - a binary variable \f$x_i\f$ fixed in branch \f$x_j=v\f$ gives the implication \f$x_j=v\Rightarrow x_i=u\f$.
+ *
+ * `CParallelProber` splits the variables to be probed into batches, which are run as jobs of a `CJobPool`.
+ * Each worker probes on its own copy of the rows and bounds (a `CRowPropagator`), so workers share no writable data;
+ * all variables of one call to `probe()` are probed against the bounds valid at the beginning of the call.
+ * When all batches have been probed, their results are merged in the order of batches:
+ * fixings and bounds are applied to the master copy, and implications are appended to the list.
+ * So the results do not depend on the number of threads. Worker copies are brought up to date
+ * by replaying the bound changes of the master copy when a worker starts its next batch.
+ *
+ * Typical use in presolve: call `probe()` until it returns no new bound changes,
+ * then transfer bounds (`getLoBound()`, `getUpBound()`) and implications (`getImplication()`) to the solver.
+ */
+class CParallelProber: private CJobPool
+{
+	/// Result of probing.
+	struct tagRec {
+		int var; ///< probed variable.
+		int val; ///< `-1` for a bound valid for the problem; otherwise, value of `var` in the branch that implies the bound.
+		int bd; ///< index `(j<<1)+side` of the bound (`side` is `0` for lower bound), or `-1` if the problem is infeasible.
+		double bound; ///< value of the bound.
+	};
+
+	/// Batch of variables probed by one job.
+	struct tagBatch {
+		int first; ///< first variable of the batch in `m_ipProbe`.
+		int num; ///< number of variables in the batch.
+		int recNum; ///< number of results.
+		int recCap; ///< size of `pRec`.
+		tagRec* pRec; ///< results.
+		CException* pErr; ///< exception thrown when probing the batch, or `0`.
+	};
+
+	/// Memory of a worker.
+	struct tagWorker {
+		CRowPropagator* pProp; ///< copy of rows and bounds.
+		double* dpBd; ///< bounds of variables in branch `x_j=0`.
+		double* dpOrig; ///< bounds of variables before branching.
+		int* ipStamp; ///< marks of variables whose bounds have been changed by branching.
+		int* ipList; ///< variables whose bounds have been changed by branching, collected before the branch is undone.
+		int stamp; ///< last mark used.
+		int syncNum; ///< number of changes of the master bounds replayed on `pProp`.
+	};
+
+	int m_iN; ///< number of variables.
+	int m_iBatchSize; ///< number of variables in a batch.
+	CRowPropagator* m_pMaster; ///< master copy of rows and bounds.
+	tagWorker m_Worker[MAX_WORKER_NUM]; ///< memory of workers.
+	int* m_ipProbe; ///< variables probed in the current call to `probe()`.
+	int* m_ipLastProbe; ///< `m_ipLastProbe[j]` is number of changes of the master bounds when `x_j` was last probed, or `-1`.
+	int m_iBatchNum; ///< number of batches in the current call to `probe()`.
+	int m_iBatchCap; ///< size of `m_pBatch`.
+	tagBatch* m_pBatch; ///< batches.
+	int m_iChangeNum; ///< number of changes of the master bounds.
+	int m_iChangeCap; ///< size of `m_ipChange` and `m_dpChange`.
+	int* m_ipChange; ///< `m_ipChange[t]` is index `(j<<1)+side` of bound changed by change `t`.
+	double* m_dpChange; ///< `m_dpChange[t]` is new value of that bound.
+	int m_iImplNum; ///< number of implications.
+	int m_iImplCap; ///< size of `m_pImpl`.
+	tagRec* m_pImpl; ///< implications.
+	bool m_bInfeasible; ///< `true` if infeasibility has been detected.
+	int m_iProbedNum; ///< number of variables probed.
+	int m_iFixedNum; ///< number of variables fixed because one branch is infeasible.
+	int m_iTightenedNum; ///< number of bounds implied by both branches.
+
+public:
+	/**
+	 * The constructor.
+	 * \param[in] pModel pointer to a propagator storing the problem rows (after `CRowPropagator::init()` has been called);
+	 * its bounds are the initial bounds of the prober;
+	 * \param[in] workerNum number of threads;
+	 * \param[in] batchSize number of variables probed by one job.
+	 * \throws CMemoryException lack of memory.
+	 */
+	CParallelProber(const CRowPropagator* pModel, int workerNum, int batchSize=64): m_iN(pModel->getVarNum()),
+		m_iBatchSize((batchSize > 0)? batchSize: 1), m_pMaster(0), m_ipProbe(0), m_ipLastProbe(0), m_iBatchNum(0), m_iBatchCap(0), m_pBatch(0),
+		m_iChangeNum(0), m_iChangeCap(0), m_ipChange(0), m_dpChange(0), m_iImplNum(0), m_iImplCap(0), m_pImpl(0),
+		m_bInfeasible(false), m_iProbedNum(0), m_iFixedNum(0), m_iTightenedNum(0)
+	{
+		for (int w=0; w < MAX_WORKER_NUM; ++w) {
+			tagWorker &worker=m_Worker[w];
+			worker.pProp=0;
+			worker.dpBd=worker.dpOrig=0;
+			worker.ipStamp=worker.ipList=0;
+		}
+		try {
+			if (!(m_ipProbe = new(std::nothrow) int[m_iN+1]) ||
+				!(m_ipLastProbe = new(std::nothrow) int[m_iN+1]))
+				throw new CMemoryException("CParallelProber::CParallelProber");
+			for (int j=0; j < m_iN; ++j)
+				m_ipLastProbe[j]=-1;
+			m_pMaster=copyModel(pModel);
+		}
+		catch(CException* pe) {
+			clear();
+			throw pe;
+		}
+		setWorkerNum(workerNum);
+	}
+
+	virtual ~CParallelProber()
+		{clear();} ///< The destructor.
+
+	using CJobPool::setWorkerNum;
+	using CJobPool::getWorkerNum;
+
+	/**
+	 * The function probes binary variables.
+	 * \param[in] num number of variables in `ipVar`;
+	 * \param[in] ipVar list of variables to be probed; if `ipVar=0`, all variables are probed.
+	 * Only integer variables with bounds `0` and `1` are probed, and a variable is probed again only if some bound has changed since;
+	 * implications found earlier for a variable probed again are replaced with the new ones.
+	 * \return number of bounds changed (including fixings), or `-1` if infeasibility has been detected.
+	 * \throws CMemoryException lack of memory.
+	 */
+	int probe(int num=0, const int* ipVar=0)
+	{
+		if (m_bInfeasible)
+			return -1;
+		if (!ipVar)
+			num=m_iN;
+		int probeNum=0;
+		for (int i=0; i < num; ++i) {
+			int j=(ipVar)? ipVar[i]: i;
+			if (m_pMaster->isInt(j) && m_pMaster->getLoBound(j) == 0.0 && m_pMaster->getUpBound(j) == 1.0 &&
+					m_ipLastProbe[j] < m_iChangeNum)
+				m_ipProbe[probeNum++]=j;
+		}
+		m_iBatchNum=(probeNum+m_iBatchSize-1)/m_iBatchSize;
+		allocBatches();
+		for (int b=0; b < m_iBatchNum; ++b) {
+			tagBatch &batch=m_pBatch[b];
+			batch.first=b*m_iBatchSize;
+			batch.num=(probeNum-batch.first < m_iBatchSize)? probeNum-batch.first: m_iBatchSize;
+			batch.recNum=0;
+			batch.pErr=0;
+		}
+		for (int w=0; w < getWorkerNum(); ++w)
+			if (!m_Worker[w].pProp)
+				allocWorker(m_Worker[w]);
+		runJobs(m_iBatchNum);
+		for (int b=0; b < m_iBatchNum; ++b)
+			if (m_pBatch[b].pErr) {
+				CException* pe=m_pBatch[b].pErr;
+				for (int c=b+1; c < m_iBatchNum; ++c)
+					if (m_pBatch[c].pErr)
+						delete m_pBatch[c].pErr;
+				throw pe;
+			}
+		m_iProbedNum+=probeNum;
+		return merge();
+	}
+
+	bool isInfeasible() const
+		{return m_bInfeasible;} ///< \return `true` if infeasibility has been detected.
+	int getProbedNum() const
+		{return m_iProbedNum;} ///< \return total number of variables probed.
+	int getFixedNum() const
+		{return m_iFixedNum;} ///< \return number of variables fixed because one of their branches is infeasible.
+	int getTightenedNum() const
+		{return m_iTightenedNum;} ///< \return number of bounds implied by both branches of probed variables.
+
+	/**
+	 * \param[in] j variable index.
+	 * \return lower bound of variable `j` after probing.
+	 */
+	double getLoBound(int j) const
+		{return m_pMaster->getLoBound(j);}
+
+	/**
+	 * \param[in] j variable index.
+	 * \return upper bound of variable `j` after probing.
+	 */
+	double getUpBound(int j) const
+		{return m_pMaster->getUpBound(j);}
+
+	int getImplNum() const
+		{return m_iImplNum;} ///< \return number of implications found.
+
+	/**
+	 * The function returns implication `k`, which reads as "`x_j=val` implies `x_i=iVal`".
+	 * \param[in] k implication index, `0 <= k < getImplNum()`;
+	 * \param[out] j,val probed variable and its value;
+	 * \param[out] i,iVal implied binary variable and its value.
+	 */
+	void getImplication(int k, int &j, int &val, int &i, int &iVal) const
+	{
+		const tagRec &rec=m_pImpl[k];
+		j=rec.var;
+		val=rec.val;
+		i=rec.bd >> 1;
+		iVal=static_cast<int>(rec.bound);
+	}
+
+private:
+	void clear()
+	{
+		for (int w=0; w < MAX_WORKER_NUM; ++w) {
+			tagWorker &worker=m_Worker[w];
+			if (worker.pProp) {
+				delete worker.pProp;
+				worker.pProp=0;
+			}
+			delete[] worker.dpBd;
+			delete[] worker.dpOrig;
+			delete[] worker.ipStamp;
+			delete[] worker.ipList;
+			worker.dpBd=worker.dpOrig=0;
+			worker.ipStamp=worker.ipList=0;
+		}
+		if (m_pMaster) {
+			delete m_pMaster;
+			m_pMaster=0;
+		}
+		if (m_pBatch) {
+			for (int b=0; b < m_iBatchCap; ++b)
+				delete[] m_pBatch[b].pRec;
+			delete[] m_pBatch;
+			m_pBatch=0;
+		}
+		delete[] m_ipProbe;
+		delete[] m_ipLastProbe;
+		delete[] m_ipChange;
+		delete[] m_dpChange;
+		delete[] m_pImpl;
+		m_ipProbe=m_ipLastProbe=m_ipChange=0;
+		m_dpChange=0;
+		m_pImpl=0;
+	}
+
+	/**
+	 * \return copy of rows and current bounds of `pModel`.
+	 * \throws CMemoryException lack of memory.
+	 */
+	static CRowPropagator* copyModel(const CRowPropagator* pModel)
+	{
+		int m=pModel->getRowNum(), n=pModel->getVarNum(), nz=0;
+		double lhs, rhs;
+		const double* dpVal;
+		const int* ipCol;
+		for (int i=0; i < m; ++i)
+			nz+=pModel->getRow(i,lhs,rhs,dpVal,ipCol);
+		CRowPropagator* pProp=new CRowPropagator(m,n,(nz > 0)? nz: 1);
+		try {
+			for (int j=0; j < n; ++j)
+				pProp->setVar(j,pModel->getLoBound(j),pModel->getUpBound(j),pModel->isInt(j));
+			for (int i=0; i < m; ++i) {
+				int sz=pModel->getRow(i,lhs,rhs,dpVal,ipCol);
+				pProp->addRow(lhs,rhs,sz,dpVal,ipCol);
+			}
+		}
+		catch(CException* pe) {
+			delete pProp;
+			throw pe;
+		}
+		pProp->init();
+		return pProp;
+	}
+
+	/**
+	 * The function allocates memory of a worker.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void allocWorker(tagWorker &worker)
+	{
+		delete[] worker.dpBd;
+		delete[] worker.dpOrig;
+		delete[] worker.ipStamp;
+		delete[] worker.ipList;
+		worker.dpBd=worker.dpOrig=0;
+		worker.ipStamp=worker.ipList=0;
+		if (!(worker.dpBd = new(std::nothrow) double[(m_iN<<1)+1]) ||
+			!(worker.dpOrig = new(std::nothrow) double[(m_iN<<1)+1]) ||
+			!(worker.ipStamp = new(std::nothrow) int[m_iN+1]) ||
+			!(worker.ipList = new(std::nothrow) int[m_iN+1]))
+			throw new CMemoryException("CParallelProber::allocWorker");
+		for (int j=0; j < m_iN; ++j)
+			worker.ipStamp[j]=0;
+		worker.stamp=0;
+		worker.syncNum=0;
+		worker.pProp=copyModel(m_pMaster);
+		worker.syncNum=m_iChangeNum;
+	}
+
+	/**
+	 * The function enlarges `m_pBatch` to hold `m_iBatchNum` batches.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void allocBatches()
+	{
+		if (m_iBatchNum <= m_iBatchCap)
+			return;
+		int cap=(m_iBatchCap)? m_iBatchCap: 16;
+		while (cap < m_iBatchNum)
+			cap<<=1;
+		tagBatch* pBatch=new(std::nothrow) tagBatch[cap];
+		if (!pBatch)
+			throw new CMemoryException("CParallelProber::allocBatches");
+		for (int b=0; b < cap; ++b) {
+			if (b < m_iBatchCap)
+				pBatch[b]=m_pBatch[b];
+			else {
+				pBatch[b].recNum=pBatch[b].recCap=0;
+				pBatch[b].pRec=0;
+			}
+		}
+		delete[] m_pBatch;
+		m_pBatch=pBatch;
+		m_iBatchCap=cap;
+	}
+
+	/**
+	 * The function appends a result to a list growing the list if needed.
+	 * \throws CMemoryException lack of memory.
+	 */
+	static void addRec(tagRec* &pRec, int &num, int &cap, int var, int val, int bd, double bound)
+	{
+		if (num == cap) {
+			int newCap=(cap)? cap<<1: 64;
+			tagRec* pNew=new(std::nothrow) tagRec[newCap];
+			if (!pNew)
+				throw new CMemoryException("CParallelProber::addRec");
+			for (int k=0; k < num; ++k)
+				pNew[k]=pRec[k];
+			delete[] pRec;
+			pRec=pNew;
+			cap=newCap;
+		}
+		tagRec &rec=pRec[num++];
+		rec.var=var;
+		rec.val=val;
+		rec.bd=bd;
+		rec.bound=bound;
+	}
+
+	void runJob(int b, int w)
+	{
+		tagBatch &batch=m_pBatch[b];
+		tagWorker &worker=m_Worker[w];
+		try {
+			sync(worker);
+			for (int i=batch.first; i < batch.first+batch.num; ++i)
+				probeVar(worker,batch,m_ipProbe[i]);
+		}
+		catch(CException* pe) {
+			batch.pErr=pe;
+		}
+	}
+
+	/**
+	 * The function replays changes of the master bounds on the copy of a worker.
+	 */
+	void sync(tagWorker &worker)
+	{
+		CRowPropagator* pProp=worker.pProp;
+		for (; worker.syncNum < m_iChangeNum; ++worker.syncNum) {
+			int bd=m_ipChange[worker.syncNum];
+			double val=m_dpChange[worker.syncNum];
+			if (bd & 1)
+				pProp->setBounds(bd >> 1,-CRowPropagator::INF,val);
+			else
+				pProp->setBounds(bd >> 1,val,CRowPropagator::INF);
+		}
+	}
+
+	/**
+	 * The function probes variable `j` on the copy of `worker`, and writes results into `batch`.
+	 * An implication \f$x_j=v\Rightarrow x_k=u\f$ is recorded only if \f$x_k\f$ is binary
+	 * before branching, i.e., its bounds are `0` and `1` after the branch has been undone.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void probeVar(tagWorker &worker, tagBatch &batch, int j)
+	{
+		CRowPropagator* pProp=worker.pProp;
+		int* ipList=worker.ipList;
+		int mark=pProp->getMark(), s0=++worker.stamp, num=0;
+		bool feas0=pProp->setBounds(j,0.0,0.0);
+		if (feas0)
+			for (int t=mark; t < pProp->getMark(); ++t) {
+				int k=pProp->getTrailBound(t) >> 1;
+				if (k == j || worker.ipStamp[k] == s0)
+					continue;
+				worker.ipStamp[k]=s0;
+				ipList[num++]=k;
+				worker.dpBd[k<<1]=pProp->getLoBound(k);
+				worker.dpBd[(k<<1)+1]=pProp->getUpBound(k);
+			}
+		pProp->undo(mark);
+		for (int i=0; i < num; ++i) {
+			int k=ipList[i];
+			double lo=worker.dpOrig[k<<1]=pProp->getLoBound(k), up=worker.dpOrig[(k<<1)+1]=pProp->getUpBound(k);
+			if (isBinary(pProp,k,lo,up) && worker.dpBd[k<<1] == worker.dpBd[(k<<1)+1])
+				addRec(batch.pRec,batch.recNum,batch.recCap,j,0,k<<1,worker.dpBd[k<<1]);
+		}
+		int s1=++worker.stamp;
+		bool feas1=pProp->setBounds(j,1.0,1.0);
+		if (!feas0 || !feas1) {
+			pProp->undo(mark);
+			if (!feas0 && !feas1)
+				addRec(batch.pRec,batch.recNum,batch.recCap,j,-1,-1,0.0);
+			else
+				addRec(batch.pRec,batch.recNum,batch.recCap,j,-1,(feas1)? j<<1: (j<<1)+1,(feas1)? 1.0: 0.0);
+			return;
+		}
+		num=0;
+		for (int t=mark; t < pProp->getMark(); ++t) {
+			int k=pProp->getTrailBound(t) >> 1;
+			if (k == j || worker.ipStamp[k] == s1)
+				continue;
+			bool both=(worker.ipStamp[k] == s0);
+			worker.ipStamp[k]=s1;
+			double lo=pProp->getLoBound(k), up=pProp->getUpBound(k);
+			bool fixed=(pProp->isInt(k) && lo == up && (lo == 0.0 || lo == 1.0));
+			if (fixed)
+				ipList[num++]=k;
+			if (both) {
+				if (lo > worker.dpBd[k<<1])
+					lo=worker.dpBd[k<<1];
+				if (up < worker.dpBd[(k<<1)+1])
+					up=worker.dpBd[(k<<1)+1];
+				if (lo > worker.dpOrig[k<<1]+1.0e-9)
+					addRec(batch.pRec,batch.recNum,batch.recCap,j,-1,k<<1,lo);
+				if (up < worker.dpOrig[(k<<1)+1]-1.0e-9)
+					addRec(batch.pRec,batch.recNum,batch.recCap,j,-1,(k<<1)+1,up);
+			}
+			if (fixed)
+				worker.dpBd[k<<1]=pProp->getLoBound(k); // branch 0 bounds of `k` are not used any more
+		}
+		pProp->undo(mark);
+		for (int i=0; i < num; ++i) {
+			int k=ipList[i];
+			if (isBinary(pProp,k,pProp->getLoBound(k),pProp->getUpBound(k)))
+				addRec(batch.pRec,batch.recNum,batch.recCap,j,1,k<<1,worker.dpBd[k<<1]);
+		}
+	}
+
+	/**
+	 * \return `true` if variable `k` is integer and its bounds `lo` and `up` are `0` and `1`.
+	 */
+	static bool isBinary(const CRowPropagator* pProp, int k, double lo, double up)
+		{return pProp->isInt(k) && lo == 0.0 && up == 1.0;}
+
+	/**
+	 * The function applies a bound change to the master copy.
+	 * \return `1` if the bound has been changed, and `0` otherwise.
+	 * \throws CMemoryException lack of memory.
+	 */
+	int applyBound(int bd, double val)
+	{
+		int k=bd >> 1;
+		if ((bd & 1)? val >= m_pMaster->getUpBound(k)-1.0e-9: val <= m_pMaster->getLoBound(k)+1.0e-9)
+			return 0;
+		if (m_iChangeNum == m_iChangeCap) {
+			int cap=(m_iChangeCap)? m_iChangeCap<<1: 256;
+			int* ipChange=new(std::nothrow) int[cap];
+			double* dpChange=new(std::nothrow) double[cap];
+			if (!ipChange || !dpChange) {
+				delete[] ipChange;
+				delete[] dpChange;
+				throw new CMemoryException("CParallelProber::applyBound");
+			}
+			for (int t=0; t < m_iChangeNum; ++t) {
+				ipChange[t]=m_ipChange[t];
+				dpChange[t]=m_dpChange[t];
+			}
+			delete[] m_ipChange;
+			delete[] m_dpChange;
+			m_ipChange=ipChange;
+			m_dpChange=dpChange;
+			m_iChangeCap=cap;
+		}
+		m_ipChange[m_iChangeNum]=bd;
+		m_dpChange[m_iChangeNum++]=val;
+		bool feas=(bd & 1)? m_pMaster->setBounds(k,-CRowPropagator::INF,val): m_pMaster->setBounds(k,val,CRowPropagator::INF);
+		if (!feas)
+			m_bInfeasible=true;
+		return 1;
+	}
+
+	/**
+	 * The function merges results of all batches in the order of batches.
+	 * \return number of bounds changed, or `-1` if infeasibility has been detected.
+	 * \throws CMemoryException lack of memory.
+	 */
+	int merge()
+	{
+		int changeNum=0, implNum=0, probeNum=0;
+		for (int b=0; b < m_iBatchNum; ++b)
+			probeNum+=m_pBatch[b].num;
+		for (int i=0; i < probeNum; ++i)
+			m_ipLastProbe[m_ipProbe[i]]=-2; // marks variables probed in this call
+		for (int k=0; k < m_iImplNum; ++k)
+			if (m_ipLastProbe[m_pImpl[k].var] != -2)
+				m_pImpl[implNum++]=m_pImpl[k];
+		m_iImplNum=implNum;
+		for (int i=0; i < probeNum; ++i)
+			m_ipLastProbe[m_ipProbe[i]]=m_iChangeNum;
+		for (int b=0; b < m_iBatchNum && !m_bInfeasible; ++b) {
+			const tagBatch &batch=m_pBatch[b];
+			for (int r=0; r < batch.recNum && !m_bInfeasible; ++r) {
+				const tagRec &rec=batch.pRec[r];
+				if (rec.val >= 0)
+					addRec(m_pImpl,m_iImplNum,m_iImplCap,rec.var,rec.val,rec.bd,rec.bound);
+				else if (rec.bd < 0)
+					m_bInfeasible=true;
+				else if (applyBound(rec.bd,rec.bound)) {
+					++changeNum;
+					if ((rec.bd >> 1) == rec.var)
+						++m_iFixedNum;
+					else
+						++m_iTightenedNum;
+				}
+			}
+		}
+		return (m_bInfeasible)? -1: changeNum;
+	}
+};
+
+#endif // __PROBING_H_
@@ -0,0 +1,421 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file relBranch.h Interface for `CPseudocostTable` and `CReliabilityBranching` classes
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __RELBRANCH_H_
+#define __RELBRANCH_H_
+
+#include <cmath>
+#include <new>
+#ifndef __ONE_THREAD_
+#include <atomic>
+#endif
+#include "except.h"
+#include "jobPool.h"
+
+/// Pseudocost statistics shared by several threads.
+/**
+ * Pseudocosts are average objective degradations per unit change of a variable
+ * when it is rounded down or up. Sums and counters are per-variable atomics,
+ * so that neither readers nor writers ever block; a reader may see a sum that
+ * already includes a new term while the counter does not yet, which is harmless for branching.
+ */
+class CPseudocostTable
+{
+#ifndef __ONE_THREAD_
+	typedef std::atomic<double> tagSum; ///< type of sums.
+	typedef std::atomic<int> tagNum; ///< type of counters.
+#else
+	typedef double tagSum; ///< type of sums.
+	typedef int tagNum; ///< type of counters.
+#endif
+	int m_iVarNum; ///< number of variables.
+	tagSum* m_dpSum; ///< `m_dpSum[j<<1]` (resp., `m_dpSum[(j<<1)+1]`) is sum of unit gains when variable `j` was rounded down (resp., up).
+	tagNum* m_ipNum; ///< `m_ipNum[j<<1]` (resp., `m_ipNum[(j<<1)+1]`) is number of terms in `m_dpSum[j<<1]` (resp., `m_dpSum[(j<<1)+1]`).
+	tagSum m_dSum[2]; ///< sums of all unit gains for down and up branches.
+	tagNum m_iNum[2]; ///< numbers of terms in `m_dSum[0]` and `m_dSum[1]`.
+
+public:
+	/**
+	 * The constructor.
+	 * \param[in] varNum number of variables.
+	 * \throws CMemoryException lack of memory.
+	 */
+	CPseudocostTable(int varNum): m_iVarNum(varNum), m_dpSum(0), m_ipNum(0)
+	{
+		if (!(m_dpSum = new(std::nothrow) tagSum[varNum<<1]) ||
+			!(m_ipNum = new(std::nothrow) tagNum[varNum<<1])) {
+			if (m_dpSum)
+				delete[] m_dpSum;
+			throw new CMemoryException("CPseudocostTable::CPseudocostTable");
+		}
+		for (int j=(varNum<<1)-1; j >= 0; --j) {
+			m_dpSum[j]=0.0;
+			m_ipNum[j]=0;
+		}
+		m_dSum[0]=m_dSum[1]=0.0;
+		m_iNum[0]=m_iNum[1]=0;
+	}
+
+	~CPseudocostTable()
+	{
+		delete[] m_dpSum;
+		delete[] m_ipNum;
+	} ///< The destructor.
+
+	int getVarNum() const
+		{return m_iVarNum;} ///< \return number of variables.
+
+	/**
+	 * The function adds a new term to pseudocost of a variable.
+	 * \param[in] j variable index;
+	 * \param[in] side `false` for down branch, and `true` for up branch;
+	 * \param[in] gain objective degradation per unit change of variable `j`.
+	 */
+	void update(int j, bool side, double gain)
+	{
+		int k=(j<<1)+side;
+		add(m_dpSum[k],gain);
+		++m_ipNum[k];
+		add(m_dSum[side],gain);
+		++m_iNum[side];
+	}
+
+	/**
+	 * \param[in] j variable index;
+	 * \param[in] side `false` for down branch, and `true` for up branch.
+	 * \return pseudocost of variable `j`; if the pseudocost has never been updated, the average over all variables is returned.
+	 */
+	double get(int j, bool side) const
+	{
+		int k=(j<<1)+side, num=m_ipNum[k];
+		if (num)
+			return m_dpSum[k]/num;
+		return ((num=m_iNum[side]))? m_dSum[side]/num: 1.0;
+	}
+
+	/**
+	 * \param[in] j variable index;
+	 * \param[in] side `false` for down branch, and `true` for up branch.
+	 * \return number of terms in pseudocost of variable `j`.
+	 */
+	int getNum(int j, bool side) const
+		{return m_ipNum[(j<<1)+side];}
+
+private:
+	static void add(tagSum &sum, double val)
+	{
+#ifndef __ONE_THREAD_
+		double s=sum.load(std::memory_order_relaxed);
+		while (!sum.compare_exchange_weak(s,s+val,std::memory_order_relaxed));
+#else
+		sum+=val;
+#endif
+	}
+};
+
+/// Reliability branching with parallel strong branching.
+/**
+ * For each variable, pseudocosts (average objective degradations per unit change of the variable
+ * when it is rounded down or up) are accumulated. A variable is _reliable_ if both its pseudocosts
+ * have been updated at least `m_iReliability` times. `select()` scores reliable candidates
+ * by their pseudocosts, and evaluates at most `m_iMaxCandNum` best unreliable candidates
+ * by strong branching; these evaluations are independent and run in parallel on `getWorkerNum()` threads.
+ *
+ * A derived class implements `evaluate()`, which solves (with a limit on the number of dual simplex iterations)
+ * both child LPs of a candidate; since `evaluate()` is called from several threads at the same time,
+ * each worker must use its own LP (for example, an LP built for worker `worker` before the search starts).
+ * `select()` is to be called from an overloaded `CMIP::getFractional()`; objects used
+ * by different threads of the solver may share one `CPseudocostTable`.
+ */
+class CReliabilityBranching: private CJobPool
+{
+public:
+	/// An `evaluate()` returns this gain for an infeasible child LP.
+	static constexpr double INF_GAIN=1.0e20;
+
+private:
+	int m_iVarNum; ///< number of variables.
+	int m_iReliability; ///< number of pseudocost updates after which a variable is reliable.
+	int m_iMaxCandNum; ///< maximum number of candidates evaluated by strong branching in one call to `select()`.
+	int m_iMaxItNum; ///< limit on the number of dual simplex iterations for one child LP.
+	CPseudocostTable* m_pTable; ///< pseudocosts.
+	bool m_bOwnTable; ///< if `true`, `m_pTable` is deleted by the destructor.
+	int m_iCandNum; ///< number of candidates to be evaluated.
+	int* m_ipCand; ///< `m_ipCand[c]` is index (in lists passed to `select()`) of candidate `c`.
+	double* m_dpCandScore; ///< `m_dpCandScore[c]` is pseudocost score of candidate `c`.
+	double* m_dpGain; ///< `m_dpGain[c<<1]` and `m_dpGain[(c<<1)+1]` are gains computed by `evaluate()` for candidate `c`.
+	bool* m_bpEval; ///< `m_bpEval[c]` is `true` if candidate `c` has been evaluated.
+	const int* m_ipVar; ///< list of variables passed to `select()`.
+	const double* m_dpVal; ///< list of values passed to `select()`.
+	int m_iStrongBrNum; ///< number of candidates evaluated by strong branching.
+
+public:
+	/**
+	 * The constructor.
+	 * \param[in] varNum number of variables;
+	 * \param[in] reliability number of pseudocost updates after which a variable is reliable;
+	 * \param[in] maxCandNum maximum number of candidates evaluated by strong branching in one call to `select()`;
+	 * \param[in] maxItNum limit on the number of dual simplex iterations for one child LP.
+	 * \throws CMemoryException lack of memory.
+	 */
+	CReliabilityBranching(int varNum, int reliability=4, int maxCandNum=8, int maxItNum=20):
+		m_iVarNum(varNum), m_iReliability(reliability), m_iMaxCandNum(maxCandNum), m_iMaxItNum(maxItNum),
+		m_pTable(0), m_bOwnTable(true)
+	{
+		init();
+	}
+
+	/**
+	 * The constructor that uses pseudocosts shared with other objects,
+	 * for example, with objects used by other threads of the solver.
+	 * \param[in] pTable pseudocost table, which must exist as long as this object;
+	 * \param[in] reliability number of pseudocost updates after which a variable is reliable;
+	 * \param[in] maxCandNum maximum number of candidates evaluated by strong branching in one call to `select()`;
+	 * \param[in] maxItNum limit on the number of dual simplex iterations for one child LP.
+	 * \throws CMemoryException lack of memory.
+	 */
+	CReliabilityBranching(CPseudocostTable* pTable, int reliability=4, int maxCandNum=8, int maxItNum=20):
+		m_iVarNum(pTable->getVarNum()), m_iReliability(reliability), m_iMaxCandNum(maxCandNum), m_iMaxItNum(maxItNum),
+		m_pTable(pTable), m_bOwnTable(false)
+	{
+		init();
+	}
+
+	virtual ~CReliabilityBranching()
+		{clear();} ///< The destructor.
+
+	using CJobPool::setWorkerNum;
+	using CJobPool::getWorkerNum;
+
+	CPseudocostTable* getPseudocostTable() const
+		{return m_pTable;} ///< \return pointer to the pseudocost table.
+
+	/**
+	 * The function updates pseudocosts of a variable; it is called by `select()`
+	 * for evaluated candidates, and may be called by the user after a child node LP has been solved.
+	 * \param[in] j variable index;
+	 * \param[in] side `false` for down branch, and `true` for up branch;
+	 * \param[in] gain objective degradation; gains not less than `INF_GAIN` are ignored;
+	 * \param[in] frac change of variable value (distance to the rounded value).
+	 */
+	void update(int j, bool side, double gain, double frac)
+	{
+		if (gain >= INF_GAIN || frac < 1.0e-6)
+			return;
+		if (gain < 0.0)
+			gain=0.0;
+		m_pTable->update(j,side,gain/frac);
+	}
+
+	/**
+	 * \param[in] j variable index;
+	 * \param[in] side `false` for down branch, and `true` for up branch.
+	 * \return pseudocost of variable `j`; if the pseudocost has never been updated, the average over all variables is returned.
+	 */
+	double getPseudocost(int j, bool side) const
+		{return m_pTable->get(j,side);}
+
+	/**
+	 * \param[in] j variable index.
+	 * \return `true` if both pseudocosts of variable `j` are reliable.
+	 */
+	bool isReliable(int j) const
+		{return m_pTable->getNum(j,false) >= m_iReliability && m_pTable->getNum(j,true) >= m_iReliability;}
+
+	int getStrongBrNum() const
+		{return m_iStrongBrNum;} ///< \return number of candidates evaluated by strong branching.
+
+	/**
+	 * The function selects a variable for branching.
+	 * \param[in] num number of candidates;
+	 * \param[in] ipVar,dpVal `dpVal[i]` is value of variable `ipVar[i]` in the node LP solution;
+	 * \param[out] score score of the selected variable.
+	 * \return index `i` of the selected variable `ipVar[i]`, or `-1` if all values `dpVal[i]` are integral.
+	 */
+	int select(int num, const int* ipVar, const double* dpVal, double &score)
+	{
+		int best=-1;
+		score=-1.0;
+		m_iCandNum=0;
+		for (int i=0; i < num; ++i) {
+			int j=ipVar[i];
+			double f=dpVal[i]-floor(dpVal[i]);
+			if (f < 1.0e-6 || f > 1.0-1.0e-6)
+				continue;
+			double s=getScore(f*getPseudocost(j,false),(1.0-f)*getPseudocost(j,true));
+			if (isReliable(j)) {
+				if (s > score) {
+					score=s;
+					best=i;
+				}
+			}
+			else
+				insertCand(i,s);
+		}
+		if (m_iCandNum) {
+			m_ipVar=ipVar;
+			m_dpVal=dpVal;
+			runJobs(m_iCandNum);
+			for (int c=0; c < m_iCandNum; ++c) {
+				int i=m_ipCand[c];
+				double s=m_dpCandScore[c];
+				if (m_bpEval[c]) {
+					int j=ipVar[i];
+					double f=dpVal[i]-floor(dpVal[i]);
+					update(j,false,m_dpGain[c<<1],f);
+					update(j,true,m_dpGain[(c<<1)+1],1.0-f);
+					s=getScore(m_dpGain[c<<1],m_dpGain[(c<<1)+1]);
+					++m_iStrongBrNum;
+				}
+				if (s > score) {
+					score=s;
+					best=i;
+				}
+			}
+		}
+		return best;
+	}
+
+protected:
+	/**
+	 * The function solves the two child LPs of a candidate.
+	 * \param[in] j variable index;
+	 * \param[in] val value of variable `j` in the node LP solution;
+	 * \param[in] maxItNum limit on the number of dual simplex iterations for each child LP;
+	 * \param[in] worker index of the worker (thread) that calls the function;
+	 * \param[out] downGain,upGain objective degradations when `j` is rounded down and up;
+	 *   `INF_GAIN` is returned for an infeasible child LP.
+	 * \return `false` if the candidate has not been evaluated.
+	 */
+	virtual bool evaluate(int j, double val, int maxItNum, int worker, double &downGain, double &upGain)=0;
+
+private:
+	/**
+	 * The function is called by constructors to allocate memory.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void init()
+	{
+		m_iCandNum=m_iStrongBrNum=0;
+		m_ipCand=0;
+		m_dpCandScore=m_dpGain=0;
+		m_bpEval=0;
+		m_ipVar=0;
+		m_dpVal=0;
+		if (m_iMaxCandNum < 1)
+			m_iMaxCandNum=1;
+		try {
+			if (m_bOwnTable)
+				m_pTable=new CPseudocostTable(m_iVarNum);
+		}
+		catch(CMemoryException* pe) {
+			delete pe;
+			m_pTable=0;
+		}
+		if (!m_pTable ||
+			!(m_ipCand = new(std::nothrow) int[m_iMaxCandNum]) ||
+			!(m_dpCandScore = new(std::nothrow) double[m_iMaxCandNum]) ||
+			!(m_dpGain = new(std::nothrow) double[m_iMaxCandNum<<1]) ||
+			!(m_bpEval = new(std::nothrow) bool[m_iMaxCandNum])) {
+			clear();
+			throw new CMemoryException("CReliabilityBranching::init");
+		}
+	}
+
+	void clear()
+	{
+		if (m_pTable) {
+			if (m_bOwnTable)
+				delete m_pTable;
+			m_pTable=0;
+		}
+		if (m_ipCand) {
+			delete[] m_ipCand;
+			m_ipCand=0;
+		}
+		if (m_dpCandScore) {
+			delete[] m_dpCandScore;
+			m_dpCandScore=0;
+		}
+		if (m_dpGain) {
+			delete[] m_dpGain;
+			m_dpGain=0;
+		}
+		if (m_bpEval) {
+			delete[] m_bpEval;
+			m_bpEval=0;
+		}
+	}
+
+	/**
+	 * \return product score of two gains.
+	 */
+	static double getScore(double downGain, double upGain)
+	{
+		if (downGain < 1.0e-6)
+			downGain=1.0e-6;
+		if (upGain < 1.0e-6)
+			upGain=1.0e-6;
+		return downGain*upGain;
+	}
+
+	/**
+	 * The function inserts candidate `i` with score `s` into the list of candidates to be evaluated,
+	 * which is sorted in decreasing order of scores, and which length is at most `m_iMaxCandNum`.
+	 */
+	void insertCand(int i, double s)
+	{
+		int c=m_iCandNum;
+		if (c == m_iMaxCandNum) {
+			if (s <= m_dpCandScore[c-1])
+				return;
+			--c;
+		}
+		else
+			++m_iCandNum;
+		for (; c > 0 && m_dpCandScore[c-1] < s; --c) {
+			m_ipCand[c]=m_ipCand[c-1];
+			m_dpCandScore[c]=m_dpCandScore[c-1];
+		}
+		m_ipCand[c]=i;
+		m_dpCandScore[c]=s;
+	}
+
+	void runJob(int c, int worker)
+	{
+		int i=m_ipCand[c];
+		try {
+			m_bpEval[c]=evaluate(m_ipVar[i],m_dpVal[i],m_iMaxItNum,worker,m_dpGain[c<<1],m_dpGain[(c<<1)+1]);
+		}
+		catch(CException* pe) {
+			delete pe;
+			m_bpEval[c]=false; // the pseudocost score is used
+		}
+	}
+};
+
+#endif // __RELBRANCH_H_
@@ -0,0 +1,468 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file rowProp.h Interface for `CRowPropagator` class
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __ROWPROP_H_
+#define __ROWPROP_H_
+
+#include <cmath>
+#include <cstring>
+#include <new>
+#include "except.h"
+
+/// Bound propagation by activity bounds of rows.
+/**
+ * For each row \f$b_1 \le \sum_j a_j x_j \le b_2\f$, the propagator maintains the minimum and
+ * maximum activities of the row over the current variable bounds, and uses them to tighten
+ * the bounds of the row variables (bounds of integer variables are rounded).
+ * Every bound change is stored on a _trail_, so that all changes done after some moment
+ * (given by `getMark()`) can be undone by `undo()`; this allows heuristics to try a value
+ * of a variable and to backtrack if the propagation detects infeasibility.
+ *
+ * Usage: allocate the propagator, set variable bounds by `setVar()`, add rows by `addRow()`,
+ * call `init()`, and then change bounds by `setBounds()`.
+ */
+class CRowPropagator
+{
+public:
+	static constexpr double INF=1.0e12; ///< bounds with absolute values not less than `INF` are infinite.
+
+private:
+	int m_iM; ///< number of rows added.
+	int m_iN; ///< number of variables.
+	int m_iMmax; ///< maximum number of rows.
+	int m_iNZmax; ///< maximum number of nonzeroes.
+	int* m_ipRowStart; ///< entries of row `i` are `m_ipRowStart[i],...,m_ipRowStart[i+1]-1`.
+	int* m_ipCol; ///< `m_ipCol[e]` is column of entry `e`.
+	double* m_dpVal; ///< `m_dpVal[e]` is coefficient of entry `e`.
+	int* m_ipColStart; ///< entries of column `j` are `m_ipColEntry[m_ipColStart[j]],...,m_ipColEntry[m_ipColStart[j+1]-1]`.
+	int* m_ipColEntry; ///< row entries listed by columns.
+	int* m_ipEntryRow; ///< `m_ipEntryRow[e]` is row of entry `e`.
+	double* m_dpB; ///< `m_dpB[i<<1]` and `m_dpB[(i<<1)+1]` are left and right hand sides of row `i`.
+	double* m_dpD; ///< `m_dpD[j<<1]` and `m_dpD[(j<<1)+1]` are current lower and upper bounds of variable `j`.
+	bool* m_bpInt; ///< `m_bpInt[j]` is `true` if variable `j` is integer.
+	double* m_dpAct; ///< `m_dpAct[i<<1]` and `m_dpAct[(i<<1)+1]` are finite parts of minimum and maximum activities of row `i`.
+	int* m_ipInfNum; ///< `m_ipInfNum[i<<1]` and `m_ipInfNum[(i<<1)+1]` are numbers of infinite contributions to activities of row `i`.
+	int* m_ipQueue; ///< queue of rows to be processed.
+	bool* m_bpInQueue; ///< `m_bpInQueue[i]` is `true` if row `i` is in queue.
+	int m_iTrailCap; ///< size of trail arrays.
+	int m_iTrailSize; ///< number of bound changes on the trail.
+	int* m_ipTrailBd; ///< `m_ipTrailBd[t]` is index `(j<<1)+side` of changed bound.
+	double* m_dpTrailOld; ///< `m_dpTrailOld[t]` is value of that bound before change.
+	int m_iMaxBdChangeNum; ///< limit on the number of bound changes in one call to `setBounds()`.
+
+public:
+	/**
+	 * The constructor.
+	 * \param[in] m maximum number of rows;
+	 * \param[in] n number of variables;
+	 * \param[in] nz maximum number of nonzero coefficients.
+	 * \throws CMemoryException lack of memory.
+	 */
+	CRowPropagator(int m, int n, int nz): m_iM(0), m_iN(n), m_iMmax(m), m_iNZmax(nz),
+		m_iTrailCap(4*n+16), m_iTrailSize(0), m_iMaxBdChangeNum(10*n+100)
+	{
+		m_ipRowStart=m_ipCol=m_ipColStart=m_ipColEntry=m_ipEntryRow=m_ipInfNum=m_ipQueue=m_ipTrailBd=0;
+		m_dpVal=m_dpB=m_dpD=m_dpAct=m_dpTrailOld=0;
+		m_bpInt=m_bpInQueue=0;
+		if (!(m_ipRowStart = new(std::nothrow) int[m+1]) ||
+			!(m_ipCol = new(std::nothrow) int[nz]) ||
+			!(m_dpVal = new(std::nothrow) double[nz]) ||
+			!(m_ipColStart = new(std::nothrow) int[n+1]) ||
+			!(m_ipColEntry = new(std::nothrow) int[nz]) ||
+			!(m_ipEntryRow = new(std::nothrow) int[nz]) ||
+			!(m_dpB = new(std::nothrow) double[m<<1]) ||
+			!(m_dpD = new(std::nothrow) double[n<<1]) ||
+			!(m_bpInt = new(std::nothrow) bool[n]) ||
+			!(m_dpAct = new(std::nothrow) double[m<<1]) ||
+			!(m_ipInfNum = new(std::nothrow) int[m<<1]) ||
+			!(m_ipQueue = new(std::nothrow) int[m]) ||
+			!(m_bpInQueue = new(std::nothrow) bool[m]) ||
+			!(m_ipTrailBd = new(std::nothrow) int[m_iTrailCap]) ||
+			!(m_dpTrailOld = new(std::nothrow) double[m_iTrailCap])) {
+			clear();
+			throw new CMemoryException("CRowPropagator::CRowPropagator");
+		}
+		m_ipRowStart[0]=0;
+		for (int j=0; j < n; ++j) {
+			m_dpD[j<<1]=-INF;
+			m_dpD[(j<<1)+1]=INF;
+			m_bpInt[j]=false;
+		}
+	}
+
+	~CRowPropagator()
+		{clear();} ///< The destructor.
+
+	int getRowNum() const
+		{return m_iM;} ///< \return number of rows.
+	int getVarNum() const
+		{return m_iN;} ///< \return number of variables.
+
+	/**
+	 * The function sets bounds and type of a variable; it must be called before `init()`.
+	 * \param[in] j variable index;
+	 * \param[in] lo,up lower and upper bounds;
+	 * \param[in] isInt `true` if variable `j` is integer.
+	 */
+	void setVar(int j, double lo, double up, bool isInt)
+	{
+		m_dpD[j<<1]=lo;
+		m_dpD[(j<<1)+1]=up;
+		m_bpInt[j]=isInt;
+	}
+
+	/**
+	 * The function adds the row `lhs <= sum(i in 0..sz-1) dpVal[i]*x(ipCol[i]) <= rhs`; it must be called before `init()`.
+	 * \return index of the new row.
+	 * \throws CMemoryException if the limit on the number of rows or nonzeroes is exceeded.
+	 */
+	int addRow(double lhs, double rhs, int sz, const double* dpVal, const int* ipCol)
+	{
+		int e=m_ipRowStart[m_iM];
+		if (m_iM == m_iMmax || e+sz > m_iNZmax)
+			throw new CMemoryException("CRowPropagator::addRow");
+		memcpy(m_ipCol+e,ipCol,sz*sizeof(int));
+		memcpy(m_dpVal+e,dpVal,sz*sizeof(double));
+		m_dpB[m_iM<<1]=lhs;
+		m_dpB[(m_iM<<1)+1]=rhs;
+		m_ipRowStart[m_iM+1]=e+sz;
+		return m_iM++;
+	}
+
+	/**
+	 * The function builds column lists and computes row activities; it must be called after all rows have been added.
+	 * \return `false` if infeasibility has been detected.
+	 */
+	bool init()
+	{
+		int nz=m_ipRowStart[m_iM];
+		memset(m_ipColStart,0,(m_iN+1)*sizeof(int));
+		for (int e=0; e < nz; ++e)
+			++m_ipColStart[m_ipCol[e]+1];
+		for (int j=0; j < m_iN; ++j)
+			m_ipColStart[j+1]+=m_ipColStart[j];
+		for (int i=0; i < m_iM; ++i) {
+			for (int e=m_ipRowStart[i]; e < m_ipRowStart[i+1]; ++e) {
+				m_ipEntryRow[e]=i;
+				m_ipColEntry[m_ipColStart[m_ipCol[e]]++]=e;
+			}
+		}
+		for (int j=m_iN; j > 0; --j)
+			m_ipColStart[j]=m_ipColStart[j-1];
+		m_ipColStart[0]=0;
+		m_iTrailSize=0;
+		int qSize=0;
+		for (int i=0; i < m_iM; ++i) {
+			computeActivity(i);
+			m_ipQueue[qSize++]=i;
+			m_bpInQueue[i]=true;
+		}
+		return propagate(qSize);
+	}
+
+	/**
+	 * \param[in] j variable index.
+	 * \return current lower bound of variable `j`.
+	 */
+	double getLoBound(int j) const
+		{return m_dpD[j<<1];}
+
+	/**
+	 * \param[in] j variable index.
+	 * \return current upper bound of variable `j`.
+	 */
+	double getUpBound(int j) const
+		{return m_dpD[(j<<1)+1];}
+
+	/**
+	 * \param[in] j variable index.
+	 * \return `true` if variable `j` is integer.
+	 */
+	bool isInt(int j) const
+		{return m_bpInt[j];}
+
+	/**
+	 * \param[in] i row index;
+	 * \param[out] lhs,rhs left and right hand sides of row `i`;
+	 * \param[out] dpVal,ipCol pointers to coefficients and columns of row `i`.
+	 * \return number of entries in row `i`.
+	 */
+	int getRow(int i, double &lhs, double &rhs, const double* &dpVal, const int* &ipCol) const
+	{
+		lhs=m_dpB[i<<1];
+		rhs=m_dpB[(i<<1)+1];
+		dpVal=m_dpVal+m_ipRowStart[i];
+		ipCol=m_ipCol+m_ipRowStart[i];
+		return m_ipRowStart[i+1]-m_ipRowStart[i];
+	}
+
+	/**
+	 * \param[in] j variable index;
+	 * \param[out] ipEntry pointer to list of entries of column `j`;
+	 *  use `getEntryRow()` and `getEntryVal()` to access them.
+	 * \return number of entries in column `j`.
+	 */
+	int getColumn(int j, const int* &ipEntry) const
+	{
+		ipEntry=m_ipColEntry+m_ipColStart[j];
+		return m_ipColStart[j+1]-m_ipColStart[j];
+	}
+
+	int getEntryRow(int e) const
+		{return m_ipEntryRow[e];} ///< \return row of entry `e`.
+	double getEntryVal(int e) const
+		{return m_dpVal[e];} ///< \return coefficient of entry `e`.
+
+	int getMark() const
+		{return m_iTrailSize;} ///< \return the current trail size to be passed later to `undo()`.
+
+	/**
+	 * \param[in] t trail position, `0 <= t < getMark()`.
+	 * \return index `(j<<1)+side` of the bound changed at position `t`; `side` is `0` for lower bound, and `1` for upper bound.
+	 */
+	int getTrailBound(int t) const
+		{return m_ipTrailBd[t];}
+
+	/**
+	 * The function restores all bounds changed after the trail had size `mark`.
+	 * \param[in] mark value returned by `getMark()`.
+	 */
+	void undo(int mark)
+	{
+		while (m_iTrailSize > mark) {
+			--m_iTrailSize;
+			int k=m_ipTrailBd[m_iTrailSize];
+			changeBound(k,m_dpTrailOld[m_iTrailSize]);
+		}
+	}
+
+	/**
+	 * The function tightens bounds of a variable and propagates the changes.
+	 * \param[in] j variable index;
+	 * \param[in] lo,up new bounds (only tightenings are applied).
+	 * \return `false` if infeasibility has been detected; in this case, the caller should call `undo()`.
+	 * \throws CMemoryException lack of memory.
+	 */
+	bool setBounds(int j, double lo, double up)
+	{
+		if (lo > m_dpD[(j<<1)+1]+1.0e-9 || up < m_dpD[j<<1]-1.0e-9)
+			return false;
+		int qSize=0;
+		if (lo > m_dpD[j<<1])
+			tighten(j<<1,lo,qSize);
+		if (up < m_dpD[(j<<1)+1])
+			tighten((j<<1)+1,up,qSize);
+		return propagate(qSize);
+	}
+
+private:
+	void clear()
+	{
+		delete[] m_ipRowStart;
+		delete[] m_ipCol;
+		delete[] m_dpVal;
+		delete[] m_ipColStart;
+		delete[] m_ipColEntry;
+		delete[] m_ipEntryRow;
+		delete[] m_dpB;
+		delete[] m_dpD;
+		delete[] m_bpInt;
+		delete[] m_dpAct;
+		delete[] m_ipInfNum;
+		delete[] m_ipQueue;
+		delete[] m_bpInQueue;
+		delete[] m_ipTrailBd;
+		delete[] m_dpTrailOld;
+	}
+
+	/**
+	 * The function computes from scratch activities of row `i`.
+	 */
+	void computeActivity(int i)
+	{
+		double act[2]={0.0,0.0};
+		int inf[2]={0,0};
+		for (int e=m_ipRowStart[i]; e < m_ipRowStart[i+1]; ++e) {
+			int j=m_ipCol[e];
+			double a=m_dpVal[e];
+			for (int s=0; s < 2; ++s) {
+				double d=m_dpD[(j<<1)+((a > 0.0)? s: 1-s)];
+				if (fabs(d) >= INF)
+					++inf[s];
+				else
+					act[s]+=a*d;
+			}
+		}
+		m_dpAct[i<<1]=act[0];
+		m_dpAct[(i<<1)+1]=act[1];
+		m_ipInfNum[i<<1]=inf[0];
+		m_ipInfNum[(i<<1)+1]=inf[1];
+	}
+
+	/**
+	 * The function sets bound `k=(j<<1)+side` to `val` and updates activities of rows containing variable `j`.
+	 */
+	void changeBound(int k, double val)
+	{
+		int j=k >> 1, side=k & 1;
+		double old=m_dpD[k];
+		m_dpD[k]=val;
+		for (int p=m_ipColStart[j]; p < m_ipColStart[j+1]; ++p) {
+			int e=m_ipColEntry[p], i=m_ipEntryRow[e];
+			double a=m_dpVal[e];
+			// the lower bound contributes to the minimum activity if a > 0, and to the maximum one otherwise
+			int s=(i<<1)+((a > 0.0)? side: 1-side);
+			if (fabs(old) >= INF)
+				--m_ipInfNum[s];
+			else
+				m_dpAct[s]-=a*old;
+			if (fabs(val) >= INF)
+				++m_ipInfNum[s];
+			else
+				m_dpAct[s]+=a*val;
+		}
+	}
+
+	/**
+	 * The function changes bound `k` to `val`, stores the old value on the trail, and puts rows of the variable into the queue.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void tighten(int k, double val, int &qSize)
+	{
+		if (m_iTrailSize == m_iTrailCap)
+			extendTrail();
+		m_ipTrailBd[m_iTrailSize]=k;
+		m_dpTrailOld[m_iTrailSize++]=m_dpD[k];
+		changeBound(k,val);
+		int j=k >> 1;
+		for (int p=m_ipColStart[j]; p < m_ipColStart[j+1]; ++p) {
+			int i=m_ipEntryRow[m_ipColEntry[p]];
+			if (!m_bpInQueue[i] && qSize < m_iM) {
+				m_bpInQueue[i]=true;
+				m_ipQueue[qSize++]=i;
+			}
+		}
+	}
+
+	void extendTrail()
+	{
+		int cap=m_iTrailCap << 1;
+		int* ipBd=new(std::nothrow) int[cap];
+		double* dpOld=new(std::nothrow) double[cap];
+		if (!ipBd || !dpOld) {
+			delete[] ipBd;
+			throw new CMemoryException("CRowPropagator::extendTrail");
+		}
+		memcpy(ipBd,m_ipTrailBd,m_iTrailSize*sizeof(int));
+		memcpy(dpOld,m_dpTrailOld,m_iTrailSize*sizeof(double));
+		delete[] m_ipTrailBd;
+		delete[] m_dpTrailOld;
+		m_ipTrailBd=ipBd;
+		m_dpTrailOld=dpOld;
+		m_iTrailCap=cap;
+	}
+
+	/**
+	 * The function processes rows in the queue (used as a stack) until it becomes empty.
+	 * \return `false` if infeasibility has been detected.
+	 */
+	bool propagate(int qSize)
+	{
+		bool ok=true;
+		int changeNum=0;
+		while (qSize > 0) {
+			int i=m_ipQueue[--qSize];
+			m_bpInQueue[i]=false;
+			if (!ok)
+				continue;
+			double minAct=m_dpAct[i<<1], maxAct=m_dpAct[(i<<1)+1],
+				lhs=m_dpB[i<<1], rhs=m_dpB[(i<<1)+1];
+			int minInf=m_ipInfNum[i<<1], maxInf=m_ipInfNum[(i<<1)+1];
+			double tol=1.0e-6*(1.0+fabs(rhs < INF? rhs: lhs));
+			if ((!minInf && rhs < INF && minAct > rhs+tol) || (!maxInf && lhs > -INF && maxAct < lhs-tol)) {
+				ok=false;
+				continue;
+			}
+			if (changeNum > m_iMaxBdChangeNum)
+				continue;
+			for (int e=m_ipRowStart[i]; e < m_ipRowStart[i+1]; ++e) {
+				int j=m_ipCol[e];
+				double a=m_dpVal[e], lo=m_dpD[j<<1], up=m_dpD[(j<<1)+1];
+				double newLo=-INF, newUp=INF;
+				// bounds of x_j that give its contributions to the minimum and maximum activities
+				double bMin=(a > 0.0)? lo: up, bMax=(a > 0.0)? up: lo;
+				bool infMin=fabs(bMin) >= INF, infMax=fabs(bMax) >= INF;
+				if (rhs < INF && minInf == infMin) { // a*x_j <= rhs - (minAct - a*bMin)
+					double r=(rhs-minAct+((infMin)? 0.0: a*bMin))/a;
+					if (a > 0.0)
+						newUp=r;
+					else
+						newLo=r;
+				}
+				if (lhs > -INF && maxInf == infMax) { // a*x_j >= lhs - (maxAct - a*bMax)
+					double r=(lhs-maxAct+((infMax)? 0.0: a*bMax))/a;
+					if (a > 0.0) {
+						if (r > newLo)
+							newLo=r;
+					}
+					else if (r < newUp)
+						newUp=r;
+				}
+				if (m_bpInt[j]) {
+					newLo=ceil(newLo-1.0e-6);
+					newUp=floor(newUp+1.0e-6);
+				}
+				double eps=(m_bpInt[j])? 0.5: 1.0e-3*(1.0+((up-lo < INF)? up-lo: 0.0));
+				if (newLo > lo+eps && newLo > -INF) {
+					if (newLo > up+1.0e-6) {
+						ok=false;
+						break;
+					}
+					tighten(j<<1,(newLo > up)? up: newLo,qSize);
+					++changeNum;
+				}
+				up=m_dpD[(j<<1)+1];
+				lo=m_dpD[j<<1];
+				if (newUp < up-eps && newUp < INF) {
+					if (newUp < lo-1.0e-6) {
+						ok=false;
+						break;
+					}
+					tighten((j<<1)+1,(newUp < lo)? lo: newUp,qSize);
+					++changeNum;
+				}
+				minAct=m_dpAct[i<<1];
+				maxAct=m_dpAct[(i<<1)+1];
+				minInf=m_ipInfNum[i<<1];
+				maxInf=m_ipInfNum[(i<<1)+1];
+			}
+		}
+		return ok;
+	}
+};
+
+#endif // __ROWPROP_H_
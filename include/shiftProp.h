@@ -0,0 +1,366 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file shiftProp.h Interface for `CShiftAndPropagate` class
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __SHIFTPROP_H_
+#define __SHIFTPROP_H_
+
+#include <cmath>
+#include <new>
+#include "except.h"
+#include "cmip.h"
+#include "Sort.h"
+#include "rowProp.h"
+
+/// LP-free shift-and-propagate heuristic.
+/**
+ * The heuristic starts from the point where every variable is at its bound closest to zero,
+ * and processes variables one by one: a variable is _shifted_ to the value in its current domain
+ * that satisfies as many of its rows as possible (ties are broken by the objective), it is fixed at this value,
+ * and the fixing is propagated by `CRowPropagator`, so that the domains of variables still to be processed shrink.
+ * If the fixing is infeasible, the next best value is tried. No LP is solved, so a solution
+ * can be obtained right after preprocessing, before the root LP; its objective value
+ * is a cutoff for the root and for reduced cost fixing.
+ *
+ * Variables occurring in hard rows are processed first. If row types produced by `CMIP::classify()`
+ * are passed to `setRowTypes()`, packing, covering and cardinality rows are treated as easy
+ * (propagation repairs them), other rows as hard; otherwise, all rows are hard, and only equality rows
+ * get a larger weight. Integer variables precede continuous ones.
+ */
+class CShiftAndPropagate
+{
+	CRowPropagator* m_pProp; ///< problem rows and variable domains.
+	int m_iN; ///< number of variables.
+	int m_iM; ///< number of rows.
+	const int* m_ipRowType; ///< row types (bitwise OR of `CMIP::enCtrType` members), or `0`.
+	double* m_dpX; ///< current point.
+	double* m_dpAct; ///< `m_dpAct[i]` is activity of row `i` at `m_dpX`.
+	double* m_dpKey; ///< work array.
+	int* m_ipOrder; ///< order of processing variables.
+	double* m_dpCand; ///< candidate values.
+	bool m_bSolution; ///< `true` if a solution has been found.
+	double* m_dpSol; ///< solution found.
+	double m_dObjVal; ///< its objective value.
+	int m_iFixNum; ///< number of variables fixed in the last call to `run()`.
+	int m_iRetryNum; ///< number of times the best value was infeasible and the next one was tried.
+
+public:
+	/**
+	 * The constructor.
+	 * \param[in] pProp pointer to a propagator that stores problem rows and variable bounds (`CRowPropagator::init()` must have been called);
+	 * `run()` restores all bounds it changes.
+	 * \throws CMemoryException lack of memory.
+	 */
+	CShiftAndPropagate(CRowPropagator* pProp): m_pProp(pProp), m_iN(pProp->getVarNum()), m_iM(pProp->getRowNum()),
+		m_ipRowType(0), m_bSolution(false), m_dObjVal(0.0), m_iFixNum(0), m_iRetryNum(0)
+	{
+		int maxLen=0;
+		for (int j=0; j < m_iN; ++j) {
+			const int* ipEntry;
+			int sz=pProp->getColumn(j,ipEntry);
+			if (sz > maxLen)
+				maxLen=sz;
+		}
+		m_dpAct=m_dpKey=m_dpCand=m_dpSol=0;
+		m_ipOrder=0;
+		if (!(m_dpX = new(std::nothrow) double[m_iN]) ||
+			!(m_dpSol = new(std::nothrow) double[m_iN]) ||
+			!(m_dpKey = new(std::nothrow) double[m_iN]) ||
+			!(m_ipOrder = new(std::nothrow) int[m_iN]) ||
+			!(m_dpAct = new(std::nothrow) double[m_iM]) ||
+			!(m_dpCand = new(std::nothrow) double[(maxLen<<2)+4])) {
+			clear();
+			throw new CMemoryException("CShiftAndPropagate::CShiftAndPropagate");
+		}
+	}
+
+	~CShiftAndPropagate()
+		{clear();} ///< The destructor.
+
+	/**
+	 * \param[in] ipRowType array of size `m`, `ipRowType[i]` is type of row `i` set by `CMIP::classify()`;
+	 * the array must exist while `run()` is called.
+	 */
+	void setRowTypes(const int* ipRowType)
+		{m_ipRowType=ipRowType;}
+
+	/**
+	 * The function runs the heuristic.
+	 * \param[in] dpC array of size `n`, objective coefficients, or `0`;
+	 * \param[in] sense if `true`, the objective is maximized.
+	 * \return `true` if a feasible solution has been found.
+	 */
+	bool run(const double* dpC=0, bool sense=false)
+	{
+		m_bSolution=false;
+		m_iFixNum=m_iRetryNum=0;
+		for (int j=0; j < m_iN; ++j) {
+			double lo=m_pProp->getLoBound(j), up=m_pProp->getUpBound(j);
+			m_dpX[j]=(lo > 0.0)? lo: (up < 0.0)? up: 0.0;
+		}
+		computeActivities();
+		setOrder();
+		int base=m_pProp->getMark();
+		bool ok=true;
+		for (int t=0; t < m_iN && ok; ++t) {
+			int j=m_ipOrder[t];
+			double c=(dpC)? ((sense)? -dpC[j]: dpC[j]): 0.0;
+			ok=shift(j,c);
+		}
+		if (ok && isFeasible()) {
+			m_bSolution=true;
+			m_dObjVal=0.0;
+			for (int j=0; j < m_iN; ++j) {
+				m_dpSol[j]=m_dpX[j];
+				if (dpC)
+					m_dObjVal+=dpC[j]*m_dpX[j];
+			}
+		}
+		m_pProp->undo(base);
+		return m_bSolution;
+	}
+
+	bool isSolution() const
+		{return m_bSolution;} ///< \return `true` if the last call to `run()` has found a solution.
+
+	double getObjVal() const
+		{return m_dObjVal;} ///< \return objective value of the solution found.
+
+	/**
+	 * \param[out] dpX array of size `n`, `dpX[j]` is value of variable `j` in the solution found.
+	 */
+	void getSolution(double* dpX) const
+	{
+		for (int j=0; j < m_iN; ++j)
+			dpX[j]=m_dpSol[j];
+	}
+
+	int getFixNum() const
+		{return m_iFixNum;} ///< \return number of variables fixed in the last call to `run()`.
+
+	int getRetryNum() const
+		{return m_iRetryNum;} ///< \return number of times the best shift value was infeasible in the last call to `run()`.
+
+private:
+	void clear()
+	{
+		delete[] m_dpX;
+		delete[] m_dpSol;
+		delete[] m_dpKey;
+		delete[] m_ipOrder;
+		delete[] m_dpAct;
+		delete[] m_dpCand;
+		m_dpX=m_dpSol=m_dpKey=m_dpAct=m_dpCand=0;
+		m_ipOrder=0;
+	}
+
+	void computeActivities()
+	{
+		for (int i=0; i < m_iM; ++i) {
+			double lhs, rhs, act=0.0;
+			const double* dpVal;
+			const int* ipCol;
+			int sz=m_pProp->getRow(i,lhs,rhs,dpVal,ipCol);
+			for (int k=0; k < sz; ++k)
+				act+=dpVal[k]*m_dpX[ipCol[k]];
+			m_dpAct[i]=act;
+		}
+	}
+
+	/**
+	 * \return weight of row `i` used to order variables.
+	 */
+	double rowWeight(int i) const
+	{
+		if (m_ipRowType)
+			return (m_ipRowType[i] & (CMIP::CTR_PACKING | CMIP::CTR_COVERING | CMIP::CTR_CARDINALITY))? 1.0: 4.0;
+		double lhs, rhs;
+		const double* dpVal;
+		const int* ipCol;
+		m_pProp->getRow(i,lhs,rhs,dpVal,ipCol);
+		return (lhs == rhs)? 2.0: 1.0;
+	}
+
+	/**
+	 * The function lists variables in `m_ipOrder` in non-increasing order of the total weight of their rows,
+	 * integer variables first.
+	 */
+	void setOrder()
+	{
+		for (int j=0; j < m_iN; ++j) {
+			const int* ipEntry;
+			int sz=m_pProp->getColumn(j,ipEntry);
+			double w=0.0;
+			for (int k=0; k < sz; ++k)
+				w+=rowWeight(m_pProp->getEntryRow(ipEntry[k]));
+			m_dpKey[j]=(m_pProp->isInt(j))? w+CRowPropagator::INF: w;
+			m_ipOrder[j]=j;
+		}
+		SORT::decSortDouble(m_iN,m_ipOrder,m_dpKey);
+	}
+
+	/**
+	 * \return number of rows of variable `j` violated if `x_j` is shifted from `m_dpX[j]` to `v`.
+	 */
+	int violationNum(int j, double v) const
+	{
+		const int* ipEntry;
+		int sz=m_pProp->getColumn(j,ipEntry), num=0;
+		double delta=v-m_dpX[j];
+		for (int k=0; k < sz; ++k) {
+			int e=ipEntry[k], i=m_pProp->getEntryRow(e);
+			double lhs, rhs;
+			const double* dpVal;
+			const int* ipCol;
+			m_pProp->getRow(i,lhs,rhs,dpVal,ipCol);
+			double act=m_dpAct[i]+m_pProp->getEntryVal(e)*delta, tol=1.0e-9*(1.0+fabs(act));
+			if (act < lhs-tol || act > rhs+tol)
+				++num;
+		}
+		return num;
+	}
+
+	/**
+	 * The function adds `v` (rounded if variable `j` is integer) to candidate values if `v` lies in `[lo,up]`.
+	 */
+	void addCand(int j, double v, double lo, double up, int &num) const
+	{
+		if (m_pProp->isInt(j)) {
+			double f=floor(v+1.0e-9), c=ceil(v-1.0e-9);
+			if (f >= lo && f <= up)
+				m_dpCand[num++]=f;
+			if (c != f && c >= lo && c <= up)
+				m_dpCand[num++]=c;
+		}
+		else if (v >= lo && v <= up)
+			m_dpCand[num++]=v;
+	}
+
+	/**
+	 * The function shifts variable `j` to the best feasible value, fixes it, and propagates the fixing.
+	 * \param[in] j variable index;
+	 * \param[in] c objective coefficient (of the minimization problem).
+	 * \return `false` if no value of `x_j` is consistent with the propagated domains.
+	 */
+	bool shift(int j, double c)
+	{
+		double lo=m_pProp->getLoBound(j), up=m_pProp->getUpBound(j),
+			cur=m_dpX[j];
+		if (cur < lo)
+			cur=lo;
+		else if (cur > up)
+			cur=up;
+		int num=0;
+		addCand(j,cur,lo,up,num);
+		if (lo > -CRowPropagator::INF)
+			m_dpCand[num++]=lo;
+		if (up < CRowPropagator::INF)
+			m_dpCand[num++]=up;
+		const int* ipEntry;
+		int sz=m_pProp->getColumn(j,ipEntry);
+		for (int k=0; k < sz; ++k) {
+			int e=ipEntry[k], i=m_pProp->getEntryRow(e);
+			double lhs, rhs, a=m_pProp->getEntryVal(e),
+				rest=m_dpAct[i]-a*m_dpX[j];
+			const double* dpVal;
+			const int* ipCol;
+			m_pProp->getRow(i,lhs,rhs,dpVal,ipCol);
+			if (lhs > -CRowPropagator::INF)
+				addCand(j,(lhs-rest)/a,lo,up,num);
+			if (rhs < CRowPropagator::INF)
+				addCand(j,(rhs-rest)/a,lo,up,num);
+		}
+		if (!num)
+			return false;
+		for (int tryNum=0; tryNum < 2; ++tryNum) {
+			int best=-1, bestViol=0;
+			for (int k=0; k < num; ++k) {
+				double v=m_dpCand[k];
+				if (v != v) // rejected on the previous try
+					continue;
+				int viol=violationNum(j,v);
+				if (best < 0 || viol < bestViol ||
+					(viol == bestViol && (c*v < c*m_dpCand[best] ||
+						(c*v == c*m_dpCand[best] && fabs(v-cur) < fabs(m_dpCand[best]-cur))))) {
+					best=k;
+					bestViol=viol;
+				}
+			}
+			if (best < 0)
+				return false;
+			double v=m_dpCand[best];
+			int mark=m_pProp->getMark();
+			if (m_pProp->setBounds(j,v,v)) {
+				move(j,v);
+				++m_iFixNum;
+				return true;
+			}
+			m_pProp->undo(mark);
+			++m_iRetryNum;
+			for (int k=0; k < num; ++k)
+				if (m_dpCand[k] == v)
+					m_dpCand[k]=NAN;
+		}
+		return false;
+	}
+
+	/**
+	 * The function sets `m_dpX[j]=v` and updates row activities.
+	 */
+	void move(int j, double v)
+	{
+		double delta=v-m_dpX[j];
+		if (delta != 0.0) {
+			const int* ipEntry;
+			int sz=m_pProp->getColumn(j,ipEntry);
+			for (int k=0; k < sz; ++k) {
+				int e=ipEntry[k];
+				m_dpAct[m_pProp->getEntryRow(e)]+=m_pProp->getEntryVal(e)*delta;
+			}
+		}
+		m_dpX[j]=v;
+	}
+
+	/**
+	 * \return `true` if `m_dpX` satisfies all rows.
+	 */
+	bool isFeasible()
+	{
+		computeActivities();
+		for (int i=0; i < m_iM; ++i) {
+			double lhs, rhs;
+			const double* dpVal;
+			const int* ipCol;
+			m_pProp->getRow(i,lhs,rhs,dpVal,ipCol);
+			double tol=1.0e-6*(1.0+fabs(m_dpAct[i]));
+			if (m_dpAct[i] < lhs-tol || m_dpAct[i] > rhs+tol)
+				return false;
+		}
+		return true;
+	}
+};
+
+#endif // __SHIFTPROP_H_
@@ -0,0 +1,267 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file solPool.h Interface for `CSolutionPool` class
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __SOLPOOL_H_
+#define __SOLPOOL_H_
+
+#include <cmath>
+#include <cstring>
+#include <new>
+#include "except.h"
+#include "thread.h"
+
+/// Pool of the best distinct solutions.
+/**
+ * `CRecord` keeps only the best solution; `CSolutionPool` keeps up to `k` best solutions
+ * that differ in at least one variable. Solutions are ordered by objective values,
+ * and the pool is protected by a mutex, so solutions found by different threads
+ * (for example, in overloaded `CMIP::roundSolution()` or by heuristics) can be added concurrently.
+ *
+ * The pool is used by the crossover heuristic (`CSubMipHeuristic::startCrossover()`),
+ * which fixes the variables on which several best solutions agree.
+ */
+class CSolutionPool
+{
+	int m_iN; ///< number of variables.
+	int m_iCap; ///< maximum number of solutions.
+	int m_iSize; ///< number of solutions in pool.
+	bool m_bSense; ///< if `true`, the objective is maximized.
+	double* m_dpSol; ///< `m_dpSol+s*m_iN` is solution stored in slot `s`.
+	double* m_dpObj; ///< `m_dpObj[s]` is objective value of solution in slot `s`.
+	unsigned* m_ipHash; ///< `m_ipHash[s]` is hash value of solution in slot `s`.
+	int* m_ipSlot; ///< `m_ipSlot[k]` is slot of the `k`-th best solution.
+	int m_iAddNum; ///< number of solutions inserted.
+	int m_iDupNum; ///< number of rejected duplicates.
+#ifndef __ONE_THREAD_
+	_MUTEX m_mutex; ///< protects the pool.
+#endif
+
+public:
+	/**
+	 * The constructor.
+	 * \param[in] n number of variables;
+	 * \param[in] k maximum number of solutions;
+	 * \param[in] sense if `true`, the objective is maximized.
+	 * \throws CMemoryException lack of memory.
+	 */
+	CSolutionPool(int n, int k, bool sense): m_iN(n), m_iCap((k > 0)? k: 1), m_iSize(0), m_bSense(sense),
+		m_dpSol(0), m_dpObj(0), m_ipHash(0), m_ipSlot(0), m_iAddNum(0), m_iDupNum(0)
+	{
+		if (!(m_dpSol = new(std::nothrow) double[static_cast<size_t>(n)*m_iCap]) ||
+			!(m_dpObj = new(std::nothrow) double[m_iCap]) ||
+			!(m_ipHash = new(std::nothrow) unsigned[m_iCap]) ||
+			!(m_ipSlot = new(std::nothrow) int[m_iCap])) {
+			clear();
+			throw new CMemoryException("CSolutionPool::CSolutionPool");
+		}
+#ifndef __ONE_THREAD_
+		_MUTEX_INIT(m_mutex)
+#endif
+	}
+
+	~CSolutionPool()
+	{
+		clear();
+#ifndef __ONE_THREAD_
+		_MUTEX_DESTROY(m_mutex)
+#endif
+	} ///< The destructor.
+
+	/**
+	 * The function adds a solution to the pool.
+	 * \param[in] objVal objective value;
+	 * \param[in] dpX array of size `n`, `dpX[j]` is value of variable `j`.
+	 * \return position (starting from `0`) of the solution in the pool, or `-1`
+	 * if the solution is already in the pool, or the pool is full and the solution is not better than its worst solution.
+	 */
+	int add(double objVal, const double* dpX)
+	{
+		unsigned h=hash(dpX);
+		int pos=-1;
+#ifndef __ONE_THREAD_
+		_MUTEX* pMutex=&m_mutex;
+		_MUTEX_LOCK(pMutex)
+#endif
+		if (m_iSize < m_iCap || better(objVal,m_dpObj[m_ipSlot[m_iSize-1]])) {
+			bool dup=false;
+			for (int k=0; k < m_iSize; ++k) {
+				int s=m_ipSlot[k];
+				if (m_ipHash[s] == h && equal(m_dpSol+static_cast<size_t>(s)*m_iN,dpX)) {
+					dup=true;
+					break;
+				}
+			}
+			if (dup)
+				++m_iDupNum;
+			else {
+				int s=(m_iSize < m_iCap)? m_iSize++: m_ipSlot[m_iSize-1];
+				memcpy(m_dpSol+static_cast<size_t>(s)*m_iN,dpX,m_iN*sizeof(double));
+				m_dpObj[s]=objVal;
+				m_ipHash[s]=h;
+				for (pos=m_iSize-1; pos > 0 && better(objVal,m_dpObj[m_ipSlot[pos-1]]); --pos)
+					m_ipSlot[pos]=m_ipSlot[pos-1];
+				m_ipSlot[pos]=s;
+				++m_iAddNum;
+			}
+		}
+#ifndef __ONE_THREAD_
+		_MUTEX_UNLOCK(pMutex)
+#endif
+		return pos;
+	}
+
+	int getSize() const
+		{return m_iSize;} ///< \return number of solutions in the pool.
+	int getCapacity() const
+		{return m_iCap;} ///< \return maximum number of solutions.
+	int getVarNum() const
+		{return m_iN;} ///< \return number of variables.
+	bool getObjSense() const
+		{return m_bSense;} ///< \return `true` if the objective is maximized.
+	int getAddNum() const
+		{return m_iAddNum;} ///< \return number of solutions inserted into the pool.
+	int getDupNum() const
+		{return m_iDupNum;} ///< \return number of solutions rejected as duplicates.
+
+	/**
+	 * \param[in] k position of a solution in the pool, `0 <= k < getSize()`.
+	 * \return objective value of the `k`-th best solution.
+	 */
+	double getObjVal(int k) const
+		{return m_dpObj[m_ipSlot[k]];}
+
+	/**
+	 * The function copies a solution from the pool.
+	 * \param[in] k position of a solution in the pool, `0 <= k < getSize()`;
+	 * \param[out] dpX array of size `n`, `dpX[j]` is set to the value of variable `j` in the `k`-th best solution.
+	 * \return objective value of the solution.
+	 */
+	double getSolution(int k, double* dpX)
+	{
+#ifndef __ONE_THREAD_
+		_MUTEX* pMutex=&m_mutex;
+		_MUTEX_LOCK(pMutex)
+#endif
+		int s=m_ipSlot[k];
+		memcpy(dpX,m_dpSol+static_cast<size_t>(s)*m_iN,m_iN*sizeof(double));
+		double objVal=m_dpObj[s];
+#ifndef __ONE_THREAD_
+		_MUTEX_UNLOCK(pMutex)
+#endif
+		return objVal;
+	}
+
+	/**
+	 * The function compares the `num` best solutions.
+	 * \param[in] num number of solutions compared (if `num` exceeds `getSize()`, all solutions are compared);
+	 * \param[out] dpX array of size `n`: if all compared solutions agree on variable `j`, `dpX[j]` is its common value;
+	 * otherwise, `dpX[j]` is `NAN`.
+	 * \return number of variables on which the solutions agree, or `-1` if the pool is empty.
+	 */
+	int getAgreement(int num, double* dpX)
+	{
+		int agreeNum=-1;
+#ifndef __ONE_THREAD_
+		_MUTEX* pMutex=&m_mutex;
+		_MUTEX_LOCK(pMutex)
+#endif
+		if (num > m_iSize)
+			num=m_iSize;
+		if (num > 0) {
+			agreeNum=0;
+			const double* dpBest=m_dpSol+static_cast<size_t>(m_ipSlot[0])*m_iN;
+			for (int j=0; j < m_iN; ++j) {
+				double v=dpBest[j];
+				int k=1;
+				for (; k < num; ++k)
+					if (fabs(m_dpSol[static_cast<size_t>(m_ipSlot[k])*m_iN+j]-v) > 1.0e-6)
+						break;
+				if (k == num) {
+					dpX[j]=v;
+					++agreeNum;
+				}
+				else
+					dpX[j]=NAN;
+			}
+		}
+#ifndef __ONE_THREAD_
+		_MUTEX_UNLOCK(pMutex)
+#endif
+		return agreeNum;
+	}
+
+	/**
+	 * The function removes all solutions from the pool.
+	 */
+	void reset()
+		{m_iSize=0;}
+
+private:
+	void clear()
+	{
+		delete[] m_dpSol;
+		delete[] m_dpObj;
+		delete[] m_ipHash;
+		delete[] m_ipSlot;
+		m_dpSol=m_dpObj=0;
+		m_ipHash=0;
+		m_ipSlot=0;
+	}
+
+	/**
+	 * \return `true` if `a` is a better objective value than `b`.
+	 */
+	bool better(double a, double b) const
+		{return (m_bSense)? a > b: a < b;}
+
+	/**
+	 * \return `true` if solutions `dpX` and `dpY` differ in no variable by more than `1.0e-6`.
+	 */
+	bool equal(const double* dpX, const double* dpY) const
+	{
+		for (int j=0; j < m_iN; ++j)
+			if (fabs(dpX[j]-dpY[j]) > 1.0e-6)
+				return false;
+		return true;
+	}
+
+	/**
+	 * \return FNV-1a hash of the rounded values of `dpX`; solutions equal within tolerance
+	 * may get different hash values only if some values are near half-integers.
+	 */
+	unsigned hash(const double* dpX) const
+	{
+		unsigned h=2166136261u;
+		for (int j=0; j < m_iN; ++j) {
+			h^=static_cast<unsigned>(static_cast<long long>(floor(dpX[j]+0.5)));
+			h*=16777619u;
+		}
+		return h;
+	}
+};
+
+#endif // __SOLPOOL_H_
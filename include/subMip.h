@@ -0,0 +1,417 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file subMip.h Interface for `CSubMipHeuristic` class
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __SUBMIP_H_
+#define __SUBMIP_H_
+
+#include <cmath>
+#include <cstring>
+#include <new>
+#ifndef __ONE_THREAD_
+#include <atomic>
+#endif
+#include "except.h"
+#include "thread.h"
+#include "cmip.h"
+#include "solPool.h"
+
+/// Improvement heuristics that solve restricted sub-MIPs in a background thread.
+/**
+ * Two heuristics are implemented:
+ *   - __RINS__ (relaxation induced neighborhood search) fixes every integer variable
+ *     whose values in the record solution and in a node LP solution are equal;
+ *   - __local branching__ adds the constraint
+ *     \f$\sum_{j: x^*_j=0} x_j + \sum_{j: x^*_j=1} (1-x_j) \le k\f$
+ *     over binary variables, where \f$x^*\f$ is the record solution;
+ *   - __crossover__ fixes every integer variable on which several best solutions
+ *     from a `CSolutionPool` agree (see `startCrossover()`).
+ *
+ * The restricted problem (_sub-MIP_) is a new instance of the problem built by `newSubMip()`;
+ * it is solved with a time limit by a background thread, so the search of the main solver is not blocked.
+ * When the sub-MIP gives a solution better than the record, that solution is stored in a mailbox,
+ * and the main solver takes it by calling `fetchSolution()` from an overloaded `CMIP::roundSolution()`.
+ *
+ * Variables are identified by indices; the handle of variable `j` must be `j`
+ * both in the main problem and in the sub-MIP.
+ */
+class CSubMipHeuristic
+{
+public:
+	/// Heuristics.
+	enum enHeur {
+		RINS, ///< relaxation induced neighborhood search.
+		LOCAL_BRANCHING, ///< local branching.
+		CROSSOVER ///< crossover of pool solutions.
+	};
+
+private:
+	int m_iVarNum; ///< number of variables.
+	enHeur m_eHeur; ///< heuristic being run.
+	int m_iK; ///< right hand side of the local branching constraint.
+	double m_dMinFixRate; ///< RINS and crossover are not run if less than this fraction of integer variables can be fixed.
+	__LONG m_lTimeLimit; ///< time limit for one sub-MIP.
+	double* m_dpRec; ///< record solution passed to `start()`.
+	double* m_dpLpX; ///< LP solution passed to `start()`, or agreement of pool solutions for crossover.
+	double m_dRecObj; ///< objective value of `m_dpRec`.
+	double* m_dpSol; ///< solution in the mailbox.
+	double m_dSolObj; ///< objective value of `m_dpSol`.
+#ifndef __ONE_THREAD_
+	std::atomic<int> m_iRunNum; ///< number of sub-MIPs solved.
+	std::atomic<int> m_iSuccessNum; ///< number of sub-MIPs that improved the record.
+	std::atomic<int> m_iFailNum; ///< number of sub-MIPs that could not be built or solved.
+	std::atomic<bool> m_bRunning; ///< `true` while the background thread is running.
+	std::atomic<bool> m_bSolReady; ///< `true` if the mailbox contains a solution.
+	_THREAD m_thread; ///< background thread.
+	bool m_bJoinable; ///< `true` if `m_thread` must be joined.
+	_MUTEX m_mutex; ///< protects the mailbox.
+#else
+	int m_iRunNum; ///< number of sub-MIPs solved.
+	int m_iSuccessNum; ///< number of sub-MIPs that improved the record.
+	int m_iFailNum; ///< number of sub-MIPs that could not be built or solved.
+	bool m_bRunning; ///< never `true` after `start()` returns.
+	bool m_bSolReady; ///< `true` if the mailbox contains a solution.
+#endif
+
+public:
+	/**
+	 * The constructor.
+	 * \param[in] varNum number of variables.
+	 * \throws CMemoryException lack of memory.
+	 */
+	CSubMipHeuristic(int varNum): m_iVarNum(varNum), m_eHeur(RINS), m_iK(10), m_dMinFixRate(0.3),
+		m_lTimeLimit(60l), m_dpRec(0), m_dpLpX(0), m_dRecObj(0.0), m_dpSol(0), m_dSolObj(0.0)
+	{
+		m_iRunNum=m_iSuccessNum=m_iFailNum=0;
+		m_bRunning=m_bSolReady=false;
+		if (!(m_dpRec = new(std::nothrow) double[varNum]) ||
+			!(m_dpLpX = new(std::nothrow) double[varNum]) ||
+			!(m_dpSol = new(std::nothrow) double[varNum])) {
+			clear();
+			throw new CMemoryException("CSubMipHeuristic::CSubMipHeuristic");
+		}
+#ifndef __ONE_THREAD_
+		m_bJoinable=false;
+		_MUTEX_INIT(m_mutex)
+#endif
+	}
+
+	virtual ~CSubMipHeuristic()
+	{
+		wait();
+		clear();
+#ifndef __ONE_THREAD_
+		_MUTEX_DESTROY(m_mutex)
+#endif
+	} ///< The destructor.
+
+	/**
+	 * \param[in] rate RINS and crossover are not run if less than this fraction of integer variables can be fixed.
+	 */
+	void setMinFixRate(double rate)
+		{m_dMinFixRate=rate;}
+
+	bool isRunning() const
+		{return m_bRunning;} ///< \return `true` if the background thread is solving a sub-MIP.
+
+	int getRunNum() const
+		{return m_iRunNum;} ///< \return number of sub-MIPs solved.
+	int getSuccessNum() const
+		{return m_iSuccessNum;} ///< \return number of sub-MIPs that improved the record.
+	int getFailNum() const
+		{return m_iFailNum;} ///< \return number of sub-MIPs that could not be built or solved.
+
+	/**
+	 * The function starts a heuristic in the background thread; if a heuristic is already running,
+	 * the function does nothing. If the library is built with `__ONE_THREAD_`, the heuristic is run by the calling thread.
+	 * \param[in] heur heuristic;
+	 * \param[in] recObj record;
+	 * \param[in] dpRec record solution, `dpRec[j]` is value of variable `j`;
+	 * \param[in] dpLpX LP solution in the same format (used only by RINS);
+	 * \param[in] timeLimit time limit for the sub-MIP;
+	 * \param[in] k right hand side of the local branching constraint.
+	 * \return `true` if the heuristic has been started.
+	 * \remark Crossover is started by `startCrossover()`.
+	 */
+	bool start(enHeur heur, double recObj, const double* dpRec, const double* dpLpX, __LONG timeLimit, int k=10)
+	{
+		if (m_bRunning || heur == CROSSOVER)
+			return false;
+		wait();
+		m_eHeur=heur;
+		m_dRecObj=recObj;
+		m_lTimeLimit=timeLimit;
+		m_iK=k;
+		memcpy(m_dpRec,dpRec,m_iVarNum*sizeof(double));
+		if (heur == RINS)
+			memcpy(m_dpLpX,dpLpX,m_iVarNum*sizeof(double));
+		launch();
+		return true;
+	}
+
+	/**
+	 * The function starts crossover in the background thread: integer variables
+	 * on which the `parentNum` best solutions of the pool agree are fixed,
+	 * and the sub-MIP is solved to improve the best pool solution.
+	 * `CMIP` has no node limit, so the sub-MIP is limited only by `timeLimit`.
+	 * \param[in] pPool pointer to a solution pool;
+	 * \param[in] parentNum number of solutions to be crossed, at least `2`;
+	 * \param[in] timeLimit time limit for the sub-MIP.
+	 * \return `true` if the heuristic has been started.
+	 */
+	bool startCrossover(CSolutionPool* pPool, int parentNum, __LONG timeLimit)
+	{
+		if (m_bRunning || parentNum < 2 || pPool->getSize() < parentNum)
+			return false;
+		wait();
+		m_eHeur=CROSSOVER;
+		m_lTimeLimit=timeLimit;
+		m_dRecObj=pPool->getSolution(0,m_dpRec);
+		pPool->getAgreement(parentNum,m_dpLpX);
+		launch();
+		return true;
+	}
+
+	/**
+	 * The function waits for the background thread to finish.
+	 */
+	void wait()
+	{
+#ifndef __ONE_THREAD_
+		if (m_bJoinable) {
+			_THREAD_JOIN(m_thread);
+			_THREAD_CLOSE(m_thread);
+			m_bJoinable=false;
+		}
+#endif
+	}
+
+	/**
+	 * The function takes a solution from the mailbox if it is better than a given record;
+	 * it never waits for the background thread.
+	 * \param[in] sense objective sense (`true` for maximization);
+	 * \param[in,out] objVal on input, record of the main solver; on output, objective value of the returned solution;
+	 * \param[in] n number of variables;
+	 * \param[out] dpX,ipHd `dpX[i]` is set to the value of variable with handle `ipHd[i]`.
+	 * \return `true` if a better solution has been returned.
+	 */
+	bool fetchSolution(bool sense, double &objVal, int n, double* dpX, const CLP::tagHANDLE* ipHd)
+	{
+		if (!m_bSolReady)
+			return false;
+		bool ok=false;
+#ifndef __ONE_THREAD_
+		_MUTEX* pMutex=&m_mutex;
+		_MUTEX_LOCK(pMutex)
+#endif
+		if (m_bSolReady && ((sense)? m_dSolObj > objVal: m_dSolObj < objVal)) {
+			for (int i=0; i < n; ++i)
+				dpX[i]=(ipHd[i] >= 0 && ipHd[i] < m_iVarNum)? m_dpSol[ipHd[i]]: 0.0;
+			objVal=m_dSolObj;
+			ok=true;
+		}
+		m_bSolReady=false;
+#ifndef __ONE_THREAD_
+		_MUTEX_UNLOCK(pMutex)
+#endif
+		return ok;
+	}
+
+protected:
+	/**
+	 * The function must build a new instance of the problem: it calls `openMatrix()`,
+	 * adds variables and constraints, but does not call `closeMatrix()`.
+	 * \return pointer to a problem allocated by `new`; `CSubMipHeuristic` deletes it.
+	 */
+	virtual CMIP* newSubMip()=0;
+
+	/**
+	 * \param[in] pMip pointer to the sub-MIP, whose matrix has not been closed yet;
+	 * \param[in] j variable index.
+	 * \return `true` if variable `j` is integer; by default, the type of variable `j` of `pMip` is checked.
+	 */
+	virtual bool isIntVar(const CMIP* pMip, int j) const
+		{return (CVarTypeReader::getType(pMip,j) & CLP::VAR_INT)? true: false;}
+
+private:
+	/// Reads types of variables, which are protected members of `CLP`; objects of this class are never built.
+	struct CVarTypeReader: public CMIP
+	{
+		static unsigned getType(const CMIP* pMip, int j)
+			{return (pMip->*(&CVarTypeReader::m_ipVarType))[j];}
+	};
+
+	void clear()
+	{
+		if (m_dpRec) {
+			delete[] m_dpRec;
+			m_dpRec=0;
+		}
+		if (m_dpLpX) {
+			delete[] m_dpLpX;
+			m_dpLpX=0;
+		}
+		if (m_dpSol) {
+			delete[] m_dpSol;
+			m_dpSol=0;
+		}
+	}
+
+	/**
+	 * The function runs the heuristic in the background thread, or, if `__ONE_THREAD_` is defined, in the calling thread.
+	 */
+	void launch()
+	{
+		m_bRunning=true;
+#ifndef __ONE_THREAD_
+		_THREAD_CREATE(m_thread,heurThread,this);
+		m_bJoinable=true;
+#else
+		run();
+#endif
+	}
+
+	/**
+	 * The function restricts the sub-MIP.
+	 * \return `false` if the neighborhood is too large to be worth searching.
+	 */
+	bool restrict(CMIP* pMip)
+	{
+		int n=m_iVarNum, intNum=0, fixNum=0;
+		if (m_eHeur != LOCAL_BRANCHING) { // RINS or crossover
+			for (int j=0; j < n; ++j) {
+				if (!isIntVar(pMip,j))
+					continue;
+				++intNum;
+				if (fabs(m_dpLpX[j]-m_dpRec[j]) < 1.0e-6) {
+					double v=floor(m_dpRec[j]+0.5);
+					pMip->setVarBounds(j,v,v);
+					++fixNum;
+				}
+			}
+			return intNum && fixNum >= m_dMinFixRate*intNum && fixNum < intNum;
+		}
+		double *dpVal=new(std::nothrow) double[n];
+		int *ipCol=new(std::nothrow) int[n];
+		if (!dpVal || !ipCol) {
+			if (dpVal)
+				delete[] dpVal;
+			throw new CMemoryException("CSubMipHeuristic::restrict");
+		}
+		int sz=0;
+		double rhs=m_iK;
+		for (int j=0; j < n; ++j) {
+			if (!isIntVar(pMip,j) || pMip->getVarLoBound(j) != 0.0 || pMip->getVarUpBound(j) != 1.0)
+				continue;
+			if (m_dpRec[j] > 0.5) {
+				dpVal[sz]=-1.0;
+				rhs-=1.0;
+			}
+			else
+				dpVal[sz]=1.0;
+			ipCol[sz++]=j;
+		}
+		if (sz > m_iK)
+			pMip->safeAddRow(-1,CLP::CTR_RIGHT,-CLP::INF,rhs,sz,dpVal,ipCol);
+		delete[] dpVal;
+		delete[] ipCol;
+		return sz > m_iK;
+	}
+
+	/**
+	 * The function builds, restricts, and solves a sub-MIP, and posts its solution to the mailbox.
+	 */
+	void run()
+	{
+		CMIP* pMip=0;
+		try {
+			pMip=newSubMip();
+			if (restrict(pMip)) {
+#ifndef __ONE_THREAD_
+				pMip->setThreadNum(1);
+#endif
+				pMip->closeMatrix();
+				pMip->optimize(m_lTimeLimit);
+				++m_iRunNum;
+				if (pMip->isSolution())
+					post(pMip);
+			}
+		}
+		catch(CException* pe) {
+			delete pe;
+			++m_iFailNum;
+		}
+		if (pMip)
+			delete pMip;
+		m_bRunning=false;
+	}
+
+	/**
+	 * The function puts the solution of `pMip` to the mailbox if it is better than the record passed to `start()`.
+	 */
+	void post(CMIP* pMip)
+	{
+		double objVal=pMip->getObjVal(), *dpX;
+		int *ipHd;
+		if (!((pMip->getObjSense())? objVal > m_dRecObj+1.0e-9: objVal < m_dRecObj-1.0e-9))
+			return;
+		dpX=0;
+		ipHd=0;
+		int n=pMip->getSolution(dpX,ipHd);
+#ifndef __ONE_THREAD_
+		_MUTEX* pMutex=&m_mutex;
+		_MUTEX_LOCK(pMutex)
+#endif
+		memset(m_dpSol,0,m_iVarNum*sizeof(double));
+		for (int i=0; i < n; ++i)
+			if (ipHd[i] >= 0 && ipHd[i] < m_iVarNum)
+				m_dpSol[ipHd[i]]=dpX[i];
+		m_dSolObj=objVal;
+		m_bSolReady=true;
+#ifndef __ONE_THREAD_
+		_MUTEX_UNLOCK(pMutex)
+#endif
+		++m_iSuccessNum;
+	}
+
+#ifndef __ONE_THREAD_
+	/**
+	 * The start function of the background thread.
+	 * \param[in] pParam pointer to `CSubMipHeuristic` object.
+	 */
+#ifdef _WINDOWS
+	static unsigned int __stdcall heurThread(void* pParam)
+#else
+	static void* heurThread(void* pParam)
+#endif
+	{
+		static_cast<CSubMipHeuristic*>(pParam)->run();
+		return 0;
+	}
+#endif
+};
+
+#endif // __SUBMIP_H_
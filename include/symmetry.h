@@ -0,0 +1,1259 @@
+///////////////////////////////////////////////////////////////
+/**
+ * \file symmetry.h Interface for `CSymmetryCache` and `CSymmetryDetector` classes
+ *
+ * |  __Author__  | N.N. Pisaruk                              |
+ * |-------------:|:------------------------------------------|
+ * |  __e-mail__  | nicolaipisaruk@gmail.com                  |
+ * | __home page__| wwww.mipcl-cpp.appspot.com                |
+ *
+ *   \copyright __2019 Nicolai N. Pisaruk__
+ */
+
+ /*  This file is part of the Mixed Integer Class Library (MIPCL).
+ *
+ *  MIPCL is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 3 of the License, or (at your option) any later version.
+ *
+ *  MIPCL is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with MIPCL; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __SYMMETRY_H_
+#define __SYMMETRY_H_
+
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <new>
+#include "except.h"
+#include "Sort.h"
+#include "thread.h"
+
+class CSymmetryDetector;
+
+/// Cache of automorphism group generators.
+/**
+ * Generators are stored under the _fingerprint_ of a colored graph (see `CSymmetryDetector::getFingerprint()`),
+ * so that when the same model is solved again, `CSymmetryDetector::search()` copies the generators
+ * instead of searching for them. A generator is stored as a list of pairs `(v,pi(v))` for the points it moves.
+ * The cache can be written to and read from a binary file.
+ *
+ * `find()`, `copyGenerators()`, and `store()` are protected by a mutex, as `store()` may reallocate entries;
+ * entries are never removed except by `reset()`, which must not be called while other threads use the cache.
+ */
+class CSymmetryCache
+{
+	/// Generators of one graph.
+	struct tagEntry {
+		unsigned long long fp; ///< fingerprint.
+		int vertNum; ///< number of vertices.
+		int genNum; ///< number of generators.
+		int* ipStart; ///< moved points of generator `k` are pairs `ipStart[k],...,ipStart[k+1]-1`.
+		int* ipMove; ///< `ipMove[p<<1]` is moved to `ipMove[(p<<1)+1]`.
+	};
+
+	int m_iSize; ///< number of entries.
+	int m_iCap; ///< size of `m_pEntry`.
+	tagEntry* m_pEntry; ///< entries.
+	int m_iHitNum; ///< number of successful lookups.
+#ifndef __ONE_THREAD_
+	_MUTEX m_mutex; ///< protects the cache.
+#endif
+
+public:
+	CSymmetryCache(): m_iSize(0), m_iCap(0), m_pEntry(0), m_iHitNum(0)
+	{
+#ifndef __ONE_THREAD_
+		_MUTEX_INIT(m_mutex)
+#endif
+	} ///< The constructor.
+
+	~CSymmetryCache()
+	{
+		reset();
+		delete[] m_pEntry;
+#ifndef __ONE_THREAD_
+		_MUTEX_DESTROY(m_mutex)
+#endif
+	} ///< The destructor.
+
+	/**
+	 * The function removes all entries.
+	 */
+	void reset()
+	{
+		for (int e=0; e < m_iSize; ++e) {
+			delete[] m_pEntry[e].ipStart;
+			delete[] m_pEntry[e].ipMove;
+		}
+		m_iSize=0;
+	}
+
+	int getSize() const
+		{return m_iSize;} ///< \return number of graphs whose generators are stored.
+	int getHitNum() const
+		{return m_iHitNum;} ///< \return number of successful lookups.
+
+	/**
+	 * \param[in] fp fingerprint;
+	 * \param[in] vertNum number of vertices.
+	 * \return entry index, or `-1` if no generators are stored for this graph.
+	 */
+	int find(unsigned long long fp, int vertNum)
+	{
+		int e=-1;
+#ifndef __ONE_THREAD_
+		_MUTEX* pMutex=&m_mutex;
+		_MUTEX_LOCK(pMutex)
+#endif
+		for (int k=0; k < m_iSize; ++k)
+			if (m_pEntry[k].fp == fp && m_pEntry[k].vertNum == vertNum) {
+				e=k;
+				++m_iHitNum;
+				break;
+			}
+#ifndef __ONE_THREAD_
+		_MUTEX_UNLOCK(pMutex)
+#endif
+		return e;
+	}
+
+	/**
+	 * The function adds the generators stored for a graph to a detector.
+	 * \param[in] fp fingerprint;
+	 * \param[in] vertNum number of vertices;
+	 * \param[in,out] det detector.
+	 * \return `false` if no generators are stored for this graph.
+	 * \throws CMemoryException lack of memory.
+	 */
+	bool copyGenerators(unsigned long long fp, int vertNum, CSymmetryDetector &det);
+
+	/**
+	 * The function stores generators of a graph unless generators of this graph are already stored.
+	 * \param[in] fp fingerprint;
+	 * \param[in] vertNum number of vertices;
+	 * \param[in] genNum number of generators;
+	 * \param[in] ipStart,ipMove generators in the format of `tagEntry`.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void store(unsigned long long fp, int vertNum, int genNum, const int* ipStart, const int* ipMove)
+	{
+#ifndef __ONE_THREAD_
+		_MUTEX* pMutex=&m_mutex;
+		_MUTEX_LOCK(pMutex)
+#endif
+		try {
+			int k=0;
+			for (; k < m_iSize; ++k)
+				if (m_pEntry[k].fp == fp && m_pEntry[k].vertNum == vertNum)
+					break;
+			if (k == m_iSize)
+				append(fp,vertNum,genNum,ipStart,ipMove);
+		}
+		catch(CMemoryException* pe) {
+#ifndef __ONE_THREAD_
+			_MUTEX_UNLOCK(pMutex)
+#endif
+			throw pe;
+		}
+#ifndef __ONE_THREAD_
+		_MUTEX_UNLOCK(pMutex)
+#endif
+	}
+
+	/**
+	 * The function writes the cache to a binary file.
+	 * \param[in] fileName file name.
+	 * \throws CFileException if the file cannot be written.
+	 */
+	void write(const char* fileName) const
+	{
+		FILE* pFile=fopen(fileName,"wb");
+		if (!pFile)
+			throw new CFileException("CSymmetryCache::write",fileName);
+		bool ok=fwrite(&m_iSize,sizeof(int),1,pFile) == 1;
+		for (int e=0; ok && e < m_iSize; ++e) {
+			const tagEntry &entry=m_pEntry[e];
+			size_t moveNum=static_cast<size_t>(entry.ipStart[entry.genNum]) << 1;
+			ok=fwrite(&entry.fp,sizeof(unsigned long long),1,pFile) == 1 &&
+				fwrite(&entry.vertNum,sizeof(int),1,pFile) == 1 &&
+				fwrite(&entry.genNum,sizeof(int),1,pFile) == 1 &&
+				fwrite(entry.ipStart,sizeof(int),entry.genNum+1,pFile) == static_cast<size_t>(entry.genNum+1) &&
+				fwrite(entry.ipMove,sizeof(int),moveNum,pFile) == moveNum;
+		}
+		if (fclose(pFile) || !ok)
+			throw new CFileException("CSymmetryCache::write",fileName);
+	}
+
+	/**
+	 * The function adds entries read from a binary file written by `write()`.
+	 * \param[in] fileName file name.
+	 * \return `false` if the file does not exist.
+	 * \throws CFileException if the file is corrupted.
+	 * \throws CMemoryException lack of memory.
+	 */
+	bool read(const char* fileName)
+	{
+		FILE* pFile=fopen(fileName,"rb");
+		if (!pFile)
+			return false;
+		int* ipStart=0;
+		int* ipMove=0;
+		try {
+			int size;
+			if (fread(&size,sizeof(int),1,pFile) != 1 || size < 0)
+				throw new CFileException("CSymmetryCache::read",fileName);
+			for (int e=0; e < size; ++e) {
+				unsigned long long fp;
+				int vertNum, genNum;
+				if (fread(&fp,sizeof(unsigned long long),1,pFile) != 1 ||
+					fread(&vertNum,sizeof(int),1,pFile) != 1 ||
+					fread(&genNum,sizeof(int),1,pFile) != 1 || vertNum < 0 || genNum < 0)
+					throw new CFileException("CSymmetryCache::read",fileName);
+				if (!(ipStart = new(std::nothrow) int[genNum+1]))
+					throw new CMemoryException("CSymmetryCache::read");
+				if (fread(ipStart,sizeof(int),genNum+1,pFile) != static_cast<size_t>(genNum+1) || ipStart[0] != 0)
+					throw new CFileException("CSymmetryCache::read",fileName);
+				for (int k=0; k < genNum; ++k)
+					if (ipStart[k+1] < ipStart[k])
+						throw new CFileException("CSymmetryCache::read",fileName);
+				size_t moveNum=static_cast<size_t>(ipStart[genNum]) << 1;
+				if (!(ipMove = new(std::nothrow) int[moveNum+1]))
+					throw new CMemoryException("CSymmetryCache::read");
+				if (fread(ipMove,sizeof(int),moveNum,pFile) != moveNum)
+					throw new CFileException("CSymmetryCache::read",fileName);
+				for (size_t p=0; p < moveNum; ++p)
+					if (ipMove[p] < 0 || ipMove[p] >= vertNum)
+						throw new CFileException("CSymmetryCache::read",fileName);
+				store(fp,vertNum,genNum,ipStart,ipMove);
+				delete[] ipStart;
+				delete[] ipMove;
+				ipStart=ipMove=0;
+			}
+		}
+		catch(CException* pe) {
+			delete[] ipStart;
+			delete[] ipMove;
+			fclose(pFile);
+			throw pe;
+		}
+		fclose(pFile);
+		return true;
+	}
+
+private:
+	/**
+	 * The function appends a copy of generators to `m_pEntry`.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void append(unsigned long long fp, int vertNum, int genNum, const int* ipStart, const int* ipMove)
+	{
+		if (m_iSize == m_iCap) {
+			int cap=(m_iCap)? m_iCap<<1: 8;
+			tagEntry* pEntry=new(std::nothrow) tagEntry[cap];
+			if (!pEntry)
+				throw new CMemoryException("CSymmetryCache::append");
+			if (m_iSize)
+				memcpy(pEntry,m_pEntry,m_iSize*sizeof(tagEntry));
+			delete[] m_pEntry;
+			m_pEntry=pEntry;
+			m_iCap=cap;
+		}
+		size_t moveNum=static_cast<size_t>(ipStart[genNum]) << 1;
+		tagEntry &entry=m_pEntry[m_iSize];
+		entry.ipStart=new(std::nothrow) int[genNum+1];
+		entry.ipMove=new(std::nothrow) int[moveNum+1];
+		if (!entry.ipStart || !entry.ipMove) {
+			delete[] entry.ipStart;
+			delete[] entry.ipMove;
+			throw new CMemoryException("CSymmetryCache::append");
+		}
+		memcpy(entry.ipStart,ipStart,(genNum+1)*sizeof(int));
+		if (moveNum)
+			memcpy(entry.ipMove,ipMove,moveNum*sizeof(int));
+		entry.fp=fp;
+		entry.vertNum=vertNum;
+		entry.genNum=genNum;
+		++m_iSize;
+	}
+};
+
+/// Automorphisms of a colored graph.
+/**
+ * To compute symmetries of a MIP, the user builds the colored bipartite graph of the formulation:
+ * a vertex for each column, colored by its objective coefficient, type, and bounds;
+ * a vertex for each row, colored by its sides; and an edge for each nonzero entry, colored by its value.
+ * Colors are arbitrary `unsigned` codes; two colors are treated as equal only if their codes are equal.
+ *
+ * `search()` finds generators of the automorphism group in the style of bliss and saucy:
+ *   - the graph is split into connected components, and each component is searched separately;
+ *     generators swapping isomorphic components are found by comparing the first leaves of their search trees;
+ *   - partitions are refined to equitable ones with a queue of splitting cells; when a cell not in the queue is split,
+ *     all its fragments except the largest one are queued; vertices touched by a splitter are moved to the end of their cells,
+ *     so that only they are sorted;
+ *   - every refinement is summarized by a hash value (_trace_) of the split positions and invariant values,
+ *     and search tree nodes whose traces differ from the first path are pruned;
+ *   - the candidates at a level are pruned by the orbits of the generators already found;
+ *   - the search stops when a time limit is exceeded, in which case the generators found so far are returned.
+ *
+ * If a `CSymmetryCache` is passed to `search()`, generators of a graph with the same fingerprint are taken from the cache,
+ * and the generators of a completed search are stored there.
+ */
+class CSymmetryDetector
+{
+	friend class CSymmetryCache; ///< `CSymmetryCache::copyGenerators()` calls `addGenerator()`.
+
+	int m_iVertNum; ///< number of vertices.
+	int m_iEdgeNum; ///< number of edges.
+	int m_iEdgeCap; ///< maximum number of edges before memory is reallocated.
+	unsigned* m_upColor; ///< `m_upColor[v]` is color of vertex `v`.
+	int* m_ipEdge; ///< ends of edge `e` are `m_ipEdge[e<<1]` and `m_ipEdge[(e<<1)+1]`.
+	unsigned* m_upEdgeColor; ///< `m_upEdgeColor[e]` is color of edge `e`.
+	double m_dTimeLimit; ///< time limit in seconds, or `0.0`.
+	std::chrono::steady_clock::time_point m_tStart; ///< (wall clock) time when `search()` was called.
+	bool m_bComplete; ///< `false` if the last search was stopped by the time limit.
+	bool m_bCached; ///< `true` if generators were taken from a cache.
+	__LONG m_lNodeNum; ///< number of search tree nodes.
+
+// adjacency lists (global vertex indices), sorted by neighbors
+	int* m_ipAdjStart; ///< neighbors of `v` are `m_ipAdj[m_ipAdjStart[v]],...,m_ipAdj[m_ipAdjStart[v+1]-1]`.
+	int* m_ipAdj; ///< neighbors.
+	unsigned* m_upAdjColor; ///< colors of edges to neighbors.
+
+// components
+	int m_iCompNum; ///< number of connected components.
+	int* m_ipCompStart; ///< vertices of component `c` are `m_ipCompVert[m_ipCompStart[c]],...,m_ipCompVert[m_ipCompStart[c+1]-1]`.
+	int* m_ipCompVert; ///< vertices grouped by components.
+	int* m_ipCompLeaf; ///< `m_ipCompLeaf[m_ipCompStart[c]+i]` is vertex in position `i` of the first leaf of component `c`.
+	unsigned long long* m_upCompSig; ///< `m_upCompSig[c]` is hash value of all traces along the first path of component `c`.
+
+// partition of the current component (local vertex indices)
+	int m_iN; ///< number of vertices in current component.
+	const int* m_ipGlobal; ///< `m_ipGlobal[v]` is vertex with local index `v` in current component.
+	int* m_ipLocal; ///< `m_ipLocal[v]` is local index of vertex `v`.
+	int* m_ipImage; ///< `m_ipImage[v]` is image of vertex `v` under the map being tested.
+	int* m_ipElem; ///< vertices listed cell by cell.
+	int* m_ipPos; ///< `m_ipPos[v]` is position of `v` in `m_ipElem`.
+	int* m_ipCellOf; ///< `m_ipCellOf[v]` is first position of the cell containing `v`.
+	int* m_ipCellEnd; ///< cell starting at position `f` ends at position `m_ipCellEnd[f]-1`.
+	int m_iCellNum; ///< number of cells.
+	int* m_ipCellCount; ///< `m_ipCellCount[f]` is number of vertices of cell `f` touched by a splitter; they are moved to the end of the cell.
+	char* m_cpInQueue; ///< `m_cpInQueue[f]` is `1` if cell starting at `f` is in splitting queue.
+	char* m_cpTouched; ///< marks vertices and cells touched by a splitter.
+	int* m_ipQueue; ///< splitting queue (circular).
+	int m_iQueueHead; ///< first cell in queue.
+	int m_iQueueNum; ///< number of cells in queue.
+	int* m_ipSplit; ///< stack of splits `(f,k)`, undone by `undo()`.
+	int m_iSplitNum; ///< number of splits in stack.
+	unsigned long long* m_upInv; ///< `m_upInv[v]` is invariant value of `v` computed by a splitter.
+	int* m_ipTouchedVert; ///< vertices touched by a splitter.
+	int* m_ipSplitter; ///< vertices of the splitting cell being processed.
+	int* m_ipTouchedCell; ///< cells touched by a splitter.
+	unsigned long long m_uTrace; ///< trace of the current node.
+
+// first path
+	int m_iDepth; ///< depth of first leaf.
+	unsigned long long* m_upTrace; ///< `m_upTrace[l]` is trace of node at level `l`.
+	int* m_ipLevelCellNum; ///< `m_ipLevelCellNum[l]` is number of cells at level `l`.
+	int* m_ipTarget; ///< `m_ipTarget[l]` is first position of target cell at level `l`.
+	int* m_ipFirst; ///< `m_ipFirst[l]` is vertex individualized at level `l`.
+	int* m_ipMark; ///< `m_ipMark[l]` is size of split stack at level `l`.
+	int* m_ipTried; ///< `m_ipTried[l]` is last vertex individualized at level `l` of the current path.
+	int* m_ipLeaf; ///< first leaf.
+	int* m_ipCand; ///< vertices of the target cell at the level of the first path being processed, in increasing order.
+
+// generators
+	int m_iGenNum; ///< number of generators.
+	int m_iGenCap; ///< size of `m_ipGenStart` minus `1`.
+	int* m_ipGenStart; ///< moved points of generator `k` are pairs `m_ipGenStart[k],...,m_ipGenStart[k+1]-1`.
+	int m_iMoveCap; ///< maximum number of pairs in `m_ipMove`.
+	int* m_ipMove; ///< `m_ipMove[p<<1]` is moved to `m_ipMove[(p<<1)+1]`.
+	int* m_ipOrbit; ///< union-find forest of orbits.
+
+public:
+	/**
+	 * The constructor.
+	 * \param[in] vertNum number of vertices;
+	 * \param[in] edgeCap initial number of edges that can be added without reallocating memory.
+	 * \throws CMemoryException lack of memory.
+	 */
+	CSymmetryDetector(int vertNum, int edgeCap=0): m_iVertNum(vertNum), m_iEdgeNum(0), m_iEdgeCap((edgeCap > 0)? edgeCap: 16),
+		m_upColor(0), m_ipEdge(0), m_upEdgeColor(0), m_dTimeLimit(0.0), m_bComplete(true), m_bCached(false), m_lNodeNum(0),
+		m_ipAdjStart(0), m_ipAdj(0), m_upAdjColor(0), m_iCompNum(0), m_ipCompStart(0), m_ipCompVert(0), m_ipCompLeaf(0), m_upCompSig(0),
+		m_iN(0), m_ipGlobal(0), m_ipLocal(0), m_ipImage(0), m_ipElem(0), m_ipPos(0), m_ipCellOf(0), m_ipCellEnd(0), m_iCellNum(0), m_ipCellCount(0), m_cpInQueue(0), m_cpTouched(0),
+		m_ipQueue(0), m_iQueueHead(0), m_iQueueNum(0), m_ipSplit(0), m_iSplitNum(0), m_upInv(0), m_ipTouchedVert(0), m_ipSplitter(0), m_ipTouchedCell(0),
+		m_uTrace(0), m_iDepth(0), m_upTrace(0), m_ipLevelCellNum(0), m_ipTarget(0), m_ipFirst(0), m_ipMark(0), m_ipTried(0), m_ipLeaf(0), m_ipCand(0),
+		m_iGenNum(0), m_iGenCap(0), m_ipGenStart(0), m_iMoveCap(0), m_ipMove(0), m_ipOrbit(0)
+	{
+		int n=vertNum+1;
+		if (!(m_upColor = new(std::nothrow) unsigned[n]) ||
+			!(m_ipEdge = new(std::nothrow) int[m_iEdgeCap<<1]) ||
+			!(m_upEdgeColor = new(std::nothrow) unsigned[m_iEdgeCap]) ||
+			!(m_ipAdjStart = new(std::nothrow) int[n]) ||
+			!(m_ipCompStart = new(std::nothrow) int[n]) ||
+			!(m_ipCompVert = new(std::nothrow) int[n]) ||
+			!(m_ipCompLeaf = new(std::nothrow) int[n]) ||
+			!(m_upCompSig = new(std::nothrow) unsigned long long[n]) ||
+			!(m_ipLocal = new(std::nothrow) int[n]) ||
+			!(m_ipImage = new(std::nothrow) int[n]) ||
+			!(m_ipElem = new(std::nothrow) int[n]) ||
+			!(m_ipPos = new(std::nothrow) int[n]) ||
+			!(m_ipCellOf = new(std::nothrow) int[n]) ||
+			!(m_ipCellEnd = new(std::nothrow) int[n]) ||
+			!(m_ipCellCount = new(std::nothrow) int[n]) ||
+			!(m_cpInQueue = new(std::nothrow) char[n]) ||
+			!(m_cpTouched = new(std::nothrow) char[n<<1]) ||
+			!(m_ipQueue = new(std::nothrow) int[n]) ||
+			!(m_ipSplit = new(std::nothrow) int[n<<1]) ||
+			!(m_upInv = new(std::nothrow) unsigned long long[n]) ||
+			!(m_ipTouchedVert = new(std::nothrow) int[n]) ||
+			!(m_ipSplitter = new(std::nothrow) int[n]) ||
+			!(m_ipTouchedCell = new(std::nothrow) int[n]) ||
+			!(m_upTrace = new(std::nothrow) unsigned long long[n]) ||
+			!(m_ipLevelCellNum = new(std::nothrow) int[n]) ||
+			!(m_ipTarget = new(std::nothrow) int[n]) ||
+			!(m_ipFirst = new(std::nothrow) int[n]) ||
+			!(m_ipMark = new(std::nothrow) int[n]) ||
+			!(m_ipTried = new(std::nothrow) int[n]) ||
+			!(m_ipLeaf = new(std::nothrow) int[n]) ||
+			!(m_ipCand = new(std::nothrow) int[n]) ||
+			!(m_ipOrbit = new(std::nothrow) int[n])) {
+			clear();
+			throw new CMemoryException("CSymmetryDetector::CSymmetryDetector");
+		}
+		for (int v=0; v < vertNum; ++v)
+			m_upColor[v]=0;
+		memset(m_cpInQueue,0,n);
+		memset(m_cpTouched,0,n<<1);
+		for (int v=0; v < vertNum; ++v) {
+			m_upInv[v]=0;
+			m_ipCellCount[v]=0;
+		}
+	}
+
+	~CSymmetryDetector()
+		{clear();} ///< The destructor.
+
+	/**
+	 * \param[in] v vertex;
+	 * \param[in] color color of `v`.
+	 */
+	void setColor(int v, unsigned color)
+		{m_upColor[v]=color;}
+
+	/**
+	 * The function adds an edge; parallel edges are not allowed.
+	 * \param[in] v,w ends of edge;
+	 * \param[in] color color of edge.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void addEdge(int v, int w, unsigned color)
+	{
+		if (m_iEdgeNum == m_iEdgeCap)
+			growEdges();
+		m_ipEdge[m_iEdgeNum<<1]=v;
+		m_ipEdge[(m_iEdgeNum<<1)+1]=w;
+		m_upEdgeColor[m_iEdgeNum++]=color;
+	}
+
+	/**
+	 * \param[in] timeLimit time limit (in seconds of wall time) for `search()`; `0.0` means no limit.
+	 */
+	void setTimeLimit(double timeLimit)
+		{m_dTimeLimit=timeLimit;}
+
+	/**
+	 * \return hash value of vertex colors and edges, in the order in which they have been set;
+	 * graphs built in the same way from the same model get equal fingerprints.
+	 */
+	unsigned long long getFingerprint() const
+	{
+		unsigned long long h=14695981039346656037ull;
+		h=mix(h,static_cast<unsigned long long>(m_iVertNum));
+		h=mix(h,static_cast<unsigned long long>(m_iEdgeNum));
+		for (int v=0; v < m_iVertNum; ++v)
+			h=mix(h,m_upColor[v]);
+		for (int e=0; e < m_iEdgeNum; ++e) {
+			h=mix(h,(static_cast<unsigned long long>(m_ipEdge[e<<1]) << 32) | static_cast<unsigned>(m_ipEdge[(e<<1)+1]));
+			h=mix(h,m_upEdgeColor[e]);
+		}
+		return h;
+	}
+
+	/**
+	 * The function computes generators of the automorphism group.
+	 * \param[in] pCache pointer to a cache of generators, or `0`.
+	 * \return number of generators.
+	 * \throws CMemoryException lack of memory.
+	 */
+	int search(CSymmetryCache* pCache=0)
+	{
+		m_tStart=std::chrono::steady_clock::now();
+		m_iGenNum=0;
+		m_bComplete=true;
+		m_bCached=false;
+		m_lNodeNum=0;
+		for (int v=0; v < m_iVertNum; ++v)
+			m_ipOrbit[v]=v;
+		if (!m_ipGenStart)
+			growGenerators(0);
+		m_ipGenStart[0]=0;
+		unsigned long long fp=0;
+		if (pCache) {
+			fp=getFingerprint();
+			if (pCache->copyGenerators(fp,m_iVertNum,*this)) {
+				m_bCached=true;
+				return m_iGenNum;
+			}
+		}
+		buildAdjacency();
+		buildComponents();
+		for (int c=0; c < m_iCompNum && m_bComplete; ++c)
+			searchComponent(c);
+		if (m_bComplete)
+			matchComponents();
+		if (pCache && m_bComplete)
+			pCache->store(fp,m_iVertNum,m_iGenNum,m_ipGenStart,m_ipMove);
+		return m_iGenNum;
+	}
+
+	int getGenNum() const
+		{return m_iGenNum;} ///< \return number of generators found by the last call to `search()`.
+	bool isComplete() const
+		{return m_bComplete;} ///< \return `false` if the last search was stopped by the time limit.
+	bool isCached() const
+		{return m_bCached;} ///< \return `true` if generators were taken from a cache.
+	__LONG getNodeNum() const
+		{return m_lNodeNum;} ///< \return number of search tree nodes processed by the last call to `search()`.
+
+	/**
+	 * \param[in] k generator index, `0 <= k < getGenNum()`;
+	 * \param[out] ipMove pointer to pairs `(v,pi(v))` of moved points.
+	 * \return number of moved points.
+	 */
+	int getGenerator(int k, const int* &ipMove) const
+	{
+		ipMove=m_ipMove+(m_ipGenStart[k] << 1);
+		return m_ipGenStart[k+1]-m_ipGenStart[k];
+	}
+
+	/**
+	 * \param[in] k generator index, `0 <= k < getGenNum()`;
+	 * \param[out] ipPi array of size `vertNum`, `ipPi[v]` is image of vertex `v`.
+	 */
+	void getGenerator(int k, int* ipPi) const
+	{
+		for (int v=0; v < m_iVertNum; ++v)
+			ipPi[v]=v;
+		for (int p=m_ipGenStart[k]; p < m_ipGenStart[k+1]; ++p)
+			ipPi[m_ipMove[p<<1]]=m_ipMove[(p<<1)+1];
+	}
+
+	/**
+	 * \param[out] ipOrbit array of size `vertNum`, `ipOrbit[v]` is the smallest vertex in the orbit of `v`.
+	 * \return number of orbits.
+	 */
+	int getOrbits(int* ipOrbit)
+	{
+		int num=0;
+		for (int v=0; v < m_iVertNum; ++v)
+			if ((ipOrbit[v]=findOrbit(v)) == v)
+				++num;
+		return num;
+	}
+
+private:
+	void clear()
+	{
+		delete[] m_upColor;
+		delete[] m_ipEdge;
+		delete[] m_upEdgeColor;
+		delete[] m_ipAdjStart;
+		delete[] m_ipAdj;
+		delete[] m_upAdjColor;
+		delete[] m_ipCompStart;
+		delete[] m_ipCompVert;
+		delete[] m_ipCompLeaf;
+		delete[] m_upCompSig;
+		delete[] m_ipLocal;
+		delete[] m_ipImage;
+		delete[] m_ipElem;
+		delete[] m_ipPos;
+		delete[] m_ipCellOf;
+		delete[] m_ipCellEnd;
+		delete[] m_ipCellCount;
+		delete[] m_cpInQueue;
+		delete[] m_cpTouched;
+		delete[] m_ipQueue;
+		delete[] m_ipSplit;
+		delete[] m_upInv;
+		delete[] m_ipTouchedVert;
+		delete[] m_ipSplitter;
+		delete[] m_ipTouchedCell;
+		delete[] m_upTrace;
+		delete[] m_ipLevelCellNum;
+		delete[] m_ipTarget;
+		delete[] m_ipFirst;
+		delete[] m_ipMark;
+		delete[] m_ipTried;
+		delete[] m_ipLeaf;
+		delete[] m_ipCand;
+		delete[] m_ipGenStart;
+		delete[] m_ipMove;
+		delete[] m_ipOrbit;
+		m_upColor=m_upEdgeColor=m_upAdjColor=0;
+		m_ipEdge=m_ipAdjStart=m_ipAdj=m_ipCompStart=m_ipCompVert=m_ipCompLeaf=0;
+		m_ipLocal=m_ipImage=m_ipElem=m_ipPos=m_ipCellOf=m_ipCellEnd=m_ipCellCount=m_ipQueue=m_ipSplit=0;
+		m_ipTouchedVert=m_ipSplitter=m_ipTouchedCell=m_ipLevelCellNum=m_ipTarget=m_ipFirst=m_ipMark=m_ipTried=m_ipLeaf=m_ipCand=0;
+		m_ipGenStart=m_ipMove=m_ipOrbit=0;
+		m_upCompSig=m_upInv=m_upTrace=0;
+		m_cpInQueue=m_cpTouched=0;
+	}
+
+	/**
+	 * \return FNV-1a step combining hash value `h` with `x`.
+	 */
+	static unsigned long long mix(unsigned long long h, unsigned long long x)
+		{return (h ^ x)*1099511628211ull;}
+
+	/**
+	 * Wall time is measured, since `clock()` counts CPU time of all threads of the process.
+	 * \return `true` if the time limit has been exceeded.
+	 */
+	bool timeIsOut() const
+	{
+		return m_dTimeLimit > 0.0 &&
+			std::chrono::duration<double>(std::chrono::steady_clock::now()-m_tStart).count() > m_dTimeLimit;
+	}
+
+	/**
+	 * The function doubles the maximum number of edges.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void growEdges()
+	{
+		int cap=m_iEdgeCap<<1;
+		int* ipEdge=new(std::nothrow) int[cap<<1];
+		unsigned* upColor=new(std::nothrow) unsigned[cap];
+		if (!ipEdge || !upColor) {
+			delete[] ipEdge;
+			delete[] upColor;
+			throw new CMemoryException("CSymmetryDetector::growEdges");
+		}
+		memcpy(ipEdge,m_ipEdge,(m_iEdgeNum<<1)*sizeof(int));
+		memcpy(upColor,m_upEdgeColor,m_iEdgeNum*sizeof(unsigned));
+		delete[] m_ipEdge;
+		delete[] m_upEdgeColor;
+		m_ipEdge=ipEdge;
+		m_upEdgeColor=upColor;
+		m_iEdgeCap=cap;
+	}
+
+	/**
+	 * The function enlarges generator storage to hold at least `moveNum` moved points.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void growGenerators(int moveNum)
+	{
+		if (m_iGenNum == m_iGenCap) {
+			int cap=(m_iGenCap)? m_iGenCap<<1: 16;
+			int* ipStart=new(std::nothrow) int[cap+1];
+			if (!ipStart)
+				throw new CMemoryException("CSymmetryDetector::growGenerators");
+			if (m_ipGenStart) {
+				memcpy(ipStart,m_ipGenStart,(m_iGenNum+1)*sizeof(int));
+				delete[] m_ipGenStart;
+			}
+			m_ipGenStart=ipStart;
+			m_iGenCap=cap;
+		}
+		if (moveNum > m_iMoveCap) {
+			int cap=(m_iMoveCap)? m_iMoveCap<<1: 256;
+			if (cap < moveNum)
+				cap=moveNum;
+			int* ipMove=new(std::nothrow) int[cap<<1];
+			if (!ipMove)
+				throw new CMemoryException("CSymmetryDetector::growGenerators");
+			if (m_ipMove) {
+				memcpy(ipMove,m_ipMove,(m_ipGenStart[m_iGenNum] << 1)*sizeof(int));
+				delete[] m_ipMove;
+			}
+			m_ipMove=ipMove;
+			m_iMoveCap=cap;
+		}
+	}
+
+	/**
+	 * The function appends a generator and merges orbits of its moved points.
+	 * \param[in] sz number of moved points;
+	 * \param[in] ipMove pairs `(v,pi(v))`.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void addGenerator(int sz, const int* ipMove)
+	{
+		int start=m_ipGenStart[m_iGenNum];
+		growGenerators(start+sz);
+		memmove(m_ipMove+(start << 1),ipMove,(sz << 1)*sizeof(int));
+		m_ipGenStart[++m_iGenNum]=start+sz;
+		for (int p=0; p < sz; ++p) {
+			int r1=findOrbit(ipMove[p<<1]), r2=findOrbit(ipMove[(p<<1)+1]);
+			if (r1 < r2)
+				m_ipOrbit[r2]=r1;
+			else if (r2 < r1)
+				m_ipOrbit[r1]=r2;
+		}
+	}
+
+	/**
+	 * \return root (the smallest vertex) of the orbit containing `v`.
+	 */
+	int findOrbit(int v)
+	{
+		while (m_ipOrbit[v] != v)
+			v=m_ipOrbit[v]=m_ipOrbit[m_ipOrbit[v]];
+		return v;
+	}
+
+	/**
+	 * The function builds adjacency lists sorted by neighbors.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void buildAdjacency()
+	{
+		delete[] m_ipAdj;
+		delete[] m_upAdjColor;
+		m_ipAdj=0;
+		m_upAdjColor=0;
+		int sz=(m_iEdgeNum<<1)+1;
+		if (!(m_ipAdj = new(std::nothrow) int[sz]) ||
+			!(m_upAdjColor = new(std::nothrow) unsigned[sz]))
+			throw new CMemoryException("CSymmetryDetector::buildAdjacency");
+		for (int v=0; v <= m_iVertNum; ++v)
+			m_ipAdjStart[v]=0;
+		for (int e=0; e < (m_iEdgeNum<<1); ++e)
+			++m_ipAdjStart[m_ipEdge[e]+1];
+		for (int v=0; v < m_iVertNum; ++v)
+			m_ipAdjStart[v+1]+=m_ipAdjStart[v];
+		for (int e=0; e < m_iEdgeNum; ++e) {
+			int v=m_ipEdge[e<<1], w=m_ipEdge[(e<<1)+1];
+			m_ipAdj[m_ipAdjStart[v]]=w;
+			m_upAdjColor[m_ipAdjStart[v]++]=m_upEdgeColor[e];
+			m_ipAdj[m_ipAdjStart[w]]=v;
+			m_upAdjColor[m_ipAdjStart[w]++]=m_upEdgeColor[e];
+		}
+		for (int v=m_iVertNum; v > 0; --v)
+			m_ipAdjStart[v]=m_ipAdjStart[v-1];
+		m_ipAdjStart[0]=0;
+		for (int v=0; v < m_iVertNum; ++v) {
+			int f=m_ipAdjStart[v], deg=m_ipAdjStart[v+1]-f, gap=1;
+			int* ipAdj=m_ipAdj+f;
+			unsigned* upColor=m_upAdjColor+f;
+			while (gap < deg/3)
+				gap=3*gap+1;
+			for (; gap > 0; gap/=3)
+				for (int i=gap; i < deg; ++i) {
+					int w=ipAdj[i], k=i;
+					unsigned c=upColor[i];
+					for (; k >= gap && ipAdj[k-gap] > w; k-=gap) {
+						ipAdj[k]=ipAdj[k-gap];
+						upColor[k]=upColor[k-gap];
+					}
+					ipAdj[k]=w;
+					upColor[k]=c;
+				}
+		}
+	}
+
+	/**
+	 * The function splits the graph into connected components.
+	 */
+	void buildComponents()
+	{
+		for (int v=0; v < m_iVertNum; ++v)
+			m_ipLocal[v]=-1;
+		int num=0;
+		m_iCompNum=0;
+		for (int s=0; s < m_iVertNum; ++s) {
+			if (m_ipLocal[s] >= 0)
+				continue;
+			m_ipCompStart[m_iCompNum++]=num;
+			m_ipLocal[s]=0;
+			m_ipCompVert[num++]=s;
+			for (int i=num-1; i < num; ++i) {
+				int v=m_ipCompVert[i];
+				for (int a=m_ipAdjStart[v]; a < m_ipAdjStart[v+1]; ++a)
+					if (m_ipLocal[m_ipAdj[a]] < 0) {
+						m_ipLocal[m_ipAdj[a]]=0;
+						m_ipCompVert[num++]=m_ipAdj[a];
+					}
+			}
+		}
+		m_ipCompStart[m_iCompNum]=num;
+	}
+
+	/**
+	 * The function splits the cell starting at position `f` at position `k`.
+	 */
+	void split(int f, int k)
+	{
+		int e=m_ipCellEnd[f];
+		m_ipCellEnd[k]=e;
+		m_ipCellEnd[f]=k;
+		for (int i=k; i < e; ++i)
+			m_ipCellOf[m_ipElem[i]]=k;
+		m_ipSplit[m_iSplitNum<<1]=f;
+		m_ipSplit[(m_iSplitNum++<<1)+1]=k;
+		++m_iCellNum;
+	}
+
+	/**
+	 * The function undoes splits until `mark` splits are left.
+	 */
+	void undo(int mark)
+	{
+		while (m_iSplitNum > mark) {
+			--m_iSplitNum;
+			int f=m_ipSplit[m_iSplitNum<<1], k=m_ipSplit[(m_iSplitNum<<1)+1], e=m_ipCellEnd[k];
+			for (int i=k; i < e; ++i)
+				m_ipCellOf[m_ipElem[i]]=f;
+			m_ipCellEnd[f]=e;
+			--m_iCellNum;
+		}
+	}
+
+	void enqueue(int f)
+	{
+		if (!m_cpInQueue[f]) {
+			m_cpInQueue[f]=1;
+			m_ipQueue[(m_iQueueHead+m_iQueueNum++)%m_iN]=f;
+		}
+	} ///< The function adds the cell starting at position `f` to the splitting queue.
+
+	/**
+	 * The function sorts vertices in positions `f,...,e-1` by their invariant values.
+	 */
+	void sortCell(int f, int e)
+	{
+		int sz=e-f, gap=1, *ipElem=m_ipElem+f;
+		while (gap < sz/3)
+			gap=3*gap+1;
+		for (; gap > 0; gap/=3)
+			for (int i=gap; i < sz; ++i) {
+				int v=ipElem[i], k=i;
+				unsigned long long x=m_upInv[v];
+				for (; k >= gap && m_upInv[ipElem[k-gap]] > x; k-=gap)
+					ipElem[k]=ipElem[k-gap];
+				ipElem[k]=v;
+			}
+		for (int i=f; i < e; ++i)
+			m_ipPos[m_ipElem[i]]=i;
+	}
+
+	/**
+	 * The function splits the cell starting at position `f` by invariant values,
+	 * queues its fragments, and updates the trace. Only the touched vertices, which are at the end of the cell, are sorted;
+	 * the other vertices have zero invariant values.
+	 */
+	void splitCell(int f)
+	{
+		int e=m_ipCellEnd[f], t=e-m_ipCellCount[f];
+		m_ipCellCount[f]=0;
+		sortCell(t,e);
+		m_uTrace=mix(m_uTrace,static_cast<unsigned long long>(f));
+		if (m_upInv[m_ipElem[f]] == m_upInv[m_ipElem[e-1]]) {
+			m_uTrace=mix(m_uTrace,m_upInv[m_ipElem[f]]);
+			return;
+		}
+		bool inQueue=(m_cpInQueue[f] != 0);
+		for (int i=(t > f)? t: f+1, cur=f; i < e; ++i)
+			if (m_upInv[m_ipElem[i]] != m_upInv[m_ipElem[i-1]]) {
+				m_uTrace=mix(mix(m_uTrace,m_upInv[m_ipElem[i-1]]),static_cast<unsigned long long>(i));
+				split(cur,i);
+				cur=i;
+			}
+		m_uTrace=mix(m_uTrace,m_upInv[m_ipElem[e-1]]);
+		int largest=f;
+		if (!inQueue)
+			for (int s=m_ipCellEnd[f]; s < e; s=m_ipCellEnd[s])
+				if (m_ipCellEnd[s]-s > m_ipCellEnd[largest]-largest)
+					largest=s;
+		for (int s=f; s < e; s=m_ipCellEnd[s])
+			if (inQueue || s != largest)
+				enqueue(s);
+	}
+
+	/**
+	 * The function refines the partition to an equitable one by processing the splitting queue.
+	 */
+	void refine()
+	{
+		while (m_iQueueNum) {
+			int w=m_ipQueue[m_iQueueHead];
+			m_iQueueHead=(m_iQueueHead+1)%m_iN;
+			--m_iQueueNum;
+			m_cpInQueue[w]=0;
+			int vertNum=0, cellNum=0, sz=m_ipCellEnd[w]-w;
+			memcpy(m_ipSplitter,m_ipElem+w,sz*sizeof(int)); // touched vertices are moved inside their cells
+			for (int i=0; i < sz; ++i) {
+				int v=m_ipGlobal[m_ipSplitter[i]];
+				for (int a=m_ipAdjStart[v]; a < m_ipAdjStart[v+1]; ++a) {
+					int u=m_ipLocal[m_ipAdj[a]], f=m_ipCellOf[u];
+					if (m_ipCellEnd[f]-f == 1)
+						continue;
+					if (!m_cpTouched[u]) {
+						m_cpTouched[u]=1;
+						m_ipTouchedVert[vertNum++]=u;
+						int p=m_ipCellEnd[f]-(++m_ipCellCount[f]), x=m_ipElem[p];
+						m_ipElem[m_ipPos[u]]=x;
+						m_ipPos[x]=m_ipPos[u];
+						m_ipElem[p]=u;
+						m_ipPos[u]=p;
+						if (!m_cpTouched[m_iN+f]) {
+							m_cpTouched[m_iN+f]=1;
+							m_ipTouchedCell[cellNum++]=f;
+						}
+					}
+					m_upInv[u]+=mix(14695981039346656037ull,m_upAdjColor[a])|1;
+				}
+			}
+			sortInt(cellNum,m_ipTouchedCell);
+			for (int t=0; t < cellNum; ++t) {
+				splitCell(m_ipTouchedCell[t]);
+				m_cpTouched[m_iN+m_ipTouchedCell[t]]=0;
+			}
+			for (int t=0; t < vertNum; ++t) {
+				m_upInv[m_ipTouchedVert[t]]=0;
+				m_cpTouched[m_ipTouchedVert[t]]=0;
+			}
+		}
+	}
+
+	/**
+	 * The function sorts `sz` integers in increasing order.
+	 */
+	static void sortInt(int sz, int* ipVal)
+	{
+		int gap=1;
+		while (gap < sz/3)
+			gap=3*gap+1;
+		for (; gap > 0; gap/=3)
+			for (int i=gap; i < sz; ++i) {
+				int x=ipVal[i], k=i;
+				for (; k >= gap && ipVal[k-gap] > x; k-=gap)
+					ipVal[k]=ipVal[k-gap];
+				ipVal[k]=x;
+			}
+	}
+
+	/**
+	 * The function individualizes vertex `v` and refines the partition.
+	 */
+	void individualize(int v)
+	{
+		int f=m_ipCellOf[v], p=m_ipPos[v], u=m_ipElem[f];
+		m_ipElem[f]=v;
+		m_ipPos[v]=f;
+		m_ipElem[p]=u;
+		m_ipPos[u]=p;
+		split(f,f+1);
+		enqueue(f);
+		refine();
+		++m_lNodeNum;
+	}
+
+	/**
+	 * \return `true` if the current node matches the node of the first path at level `l`.
+	 */
+	bool matches(int l) const
+		{return m_uTrace == m_upTrace[l] && m_iCellNum == m_ipLevelCellNum[l];}
+
+	/**
+	 * \param[in] f first position of a cell.
+	 * \return vertex with the smallest index greater than `last` in cell `f`, or `-1`.
+	 */
+	int nextCandidate(int f, int last) const
+	{
+		int v=-1;
+		for (int i=f, e=m_ipCellEnd[f]; i < e; ++i) {
+			int u=m_ipElem[i];
+			if (u > last && (v < 0 || u < v))
+				v=u;
+		}
+		return v;
+	}
+
+	/**
+	 * The function searches for automorphisms of component `c`.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void searchComponent(int c)
+	{
+		const int* ipGlobal=m_ipGlobal=m_ipCompVert+m_ipCompStart[c];
+		m_iN=m_ipCompStart[c+1]-m_ipCompStart[c];
+		for (int v=0; v < m_iN; ++v) {
+			m_ipLocal[ipGlobal[v]]=v;
+			m_ipElem[v]=v;
+			m_upInv[v]=m_upColor[ipGlobal[v]];
+		}
+		sortCell(0,m_iN);
+		m_iSplitNum=0;
+		m_iCellNum=1;
+		m_ipCellEnd[0]=m_iN;
+		for (int v=0; v < m_iN; ++v)
+			m_ipCellOf[v]=0;
+		m_iQueueHead=m_iQueueNum=0;
+		m_uTrace=mix(14695981039346656037ull,static_cast<unsigned long long>(m_iN));
+		for (int i=1, cur=0; i <= m_iN; ++i)
+			if (i == m_iN || m_upInv[m_ipElem[i]] != m_upInv[m_ipElem[i-1]]) {
+				m_uTrace=mix(mix(m_uTrace,m_upInv[m_ipElem[i-1]]),static_cast<unsigned long long>(i));
+				if (i < m_iN)
+					split(cur,i);
+				enqueue(cur);
+				cur=i;
+			}
+		for (int v=0; v < m_iN; ++v)
+			m_upInv[v]=0;
+		m_iSplitNum=0; // the initial partition is never undone
+		refine();
+		int l=0;
+		for (;;) {
+			m_upTrace[l]=m_uTrace;
+			m_ipLevelCellNum[l]=m_iCellNum;
+			m_ipMark[l]=m_iSplitNum;
+			if (m_iCellNum == m_iN)
+				break;
+			int f=0;
+			while (m_ipCellEnd[f]-f == 1)
+				f=m_ipCellEnd[f];
+			m_ipTarget[l]=f;
+			m_ipFirst[l]=m_ipElem[f];
+			individualize(m_ipElem[f]);
+			++l;
+		}
+		m_iDepth=l;
+		unsigned long long sig=m_uTrace;
+		for (l=0; l < m_iDepth; ++l)
+			sig=mix(sig,m_upTrace[l]);
+		m_upCompSig[c]=sig;
+		for (int i=0; i < m_iN; ++i) {
+			m_ipLeaf[i]=m_ipElem[i];
+			m_ipCompLeaf[m_ipCompStart[c]+i]=ipGlobal[m_ipElem[i]];
+		}
+		for (l=m_iDepth-1; l >= 0; --l) {
+			undo(m_ipMark[l]);
+			int f=m_ipTarget[l], sz=m_ipCellEnd[f]-f;
+			memcpy(m_ipCand,m_ipElem+f,sz*sizeof(int));
+			sortInt(sz,m_ipCand);
+			for (int i=0; i < sz; ++i) {
+				int w=m_ipCand[i];
+				if (findOrbit(ipGlobal[w]) == findOrbit(ipGlobal[m_ipFirst[l]]))
+					continue;
+				if (timeIsOut()) {
+					m_bComplete=false;
+					return;
+				}
+				searchFrom(l,w);
+				undo(m_ipMark[l]);
+			}
+		}
+	}
+
+	/**
+	 * The function searches the subtree of the node obtained by individualizing `w` at level `l` of the first path
+	 * for a leaf equivalent to the first leaf.
+	 * \return `true` if an automorphism has been found.
+	 * \throws CMemoryException lack of memory.
+	 */
+	bool searchFrom(int l, int w)
+	{
+		m_uTrace=m_upTrace[l];
+		individualize(w);
+		if (!matches(l+1))
+			return false;
+		int k=l+1;
+		m_ipTried[k]=-1;
+		for (;;) {
+			if (m_iCellNum == m_iN) {
+				if (isAutomorphism()) {
+					recordAutomorphism();
+					return true;
+				}
+				if (--k == l)
+					return false;
+				undo(m_ipMark[k]);
+			}
+			if (timeIsOut()) {
+				m_bComplete=false;
+				return false;
+			}
+			int f=m_ipTarget[k], u=nextCandidate(f,m_ipTried[k]);
+			if (u < 0) {
+				if (--k == l)
+					return false;
+				undo(m_ipMark[k]);
+				continue;
+			}
+			m_ipTried[k]=u;
+			m_uTrace=m_upTrace[k];
+			individualize(u);
+			if (!matches(k+1)) {
+				undo(m_ipMark[k]);
+				continue;
+			}
+			m_ipTried[++k]=-1;
+		}
+	}
+
+	/**
+	 * \return `true` if the map from the first leaf to the current leaf is an automorphism.
+	 */
+	bool isAutomorphism()
+	{
+		for (int i=0; i < m_iN; ++i)
+			m_ipImage[m_ipGlobal[m_ipLeaf[i]]]=m_ipGlobal[m_ipElem[i]];
+		for (int i=0; i < m_iN; ++i)
+			if (!mapsEdges(m_ipGlobal[i]))
+				return false;
+		return true;
+	}
+
+	/**
+	 * The function records the automorphism stored in `m_ipImage` for the current component.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void recordAutomorphism()
+	{
+		int sz=0;
+		for (int i=0; i < m_iN; ++i) {
+			int v=m_ipGlobal[i];
+			if (m_ipImage[v] != v)
+				++sz;
+		}
+		growGenerators(m_ipGenStart[m_iGenNum]+sz);
+		int* ipMove=m_ipMove+(m_ipGenStart[m_iGenNum] << 1);
+		for (int i=0, p=0; i < m_iN; ++i) {
+			int v=m_ipGlobal[i];
+			if (m_ipImage[v] != v) {
+				ipMove[p++]=v;
+				ipMove[p++]=m_ipImage[v];
+			}
+		}
+		addGenerator(sz,ipMove);
+	}
+
+	/**
+	 * \param[in] v vertex.
+	 * \return `true` if `v` and its image in `m_ipImage` have equal colors and degrees,
+	 * and every edge at `v` is mapped to an edge of the same color.
+	 */
+	bool mapsEdges(int v) const
+	{
+		int w=m_ipImage[v];
+		if (m_upColor[v] != m_upColor[w] || m_ipAdjStart[v+1]-m_ipAdjStart[v] != m_ipAdjStart[w+1]-m_ipAdjStart[w])
+			return false;
+		for (int a=m_ipAdjStart[v]; a < m_ipAdjStart[v+1]; ++a) {
+			int u=m_ipImage[m_ipAdj[a]], lo=m_ipAdjStart[w], hi=m_ipAdjStart[w+1]-1;
+			while (lo < hi) {
+				int mid=(lo+hi) >> 1;
+				if (m_ipAdj[mid] < u)
+					lo=mid+1;
+				else
+					hi=mid;
+			}
+			if (lo > hi || m_ipAdj[lo] != u || m_upAdjColor[lo] != m_upAdjColor[a])
+				return false;
+		}
+		return true;
+	}
+
+	/**
+	 * The function finds generators that swap isomorphic components: components with equal sizes and
+	 * signatures are mapped onto each other position by position of their first leaves.
+	 * \throws CMemoryException lack of memory.
+	 */
+	void matchComponents()
+	{
+		int* ipComp=m_ipTouchedVert;
+		for (int c=0; c < m_iCompNum; ++c)
+			ipComp[c]=c;
+		int gap=1;
+		while (gap < m_iCompNum/3)
+			gap=3*gap+1;
+		for (; gap > 0; gap/=3)
+			for (int i=gap; i < m_iCompNum; ++i) {
+				int c=ipComp[i], k=i;
+				for (; k >= gap && m_upCompSig[ipComp[k-gap]] > m_upCompSig[c]; k-=gap)
+					ipComp[k]=ipComp[k-gap];
+				ipComp[k]=c;
+			}
+		for (int i=0, first=0; i < m_iCompNum; ++i) {
+			int a=ipComp[first], b=ipComp[i];
+			if (m_upCompSig[a] != m_upCompSig[b]) {
+				first=i;
+				continue;
+			}
+			int sz=m_ipCompStart[a+1]-m_ipCompStart[a];
+			if (a == b || sz != m_ipCompStart[b+1]-m_ipCompStart[b])
+				continue;
+			const int *ipLeafA=m_ipCompLeaf+m_ipCompStart[a], *ipLeafB=m_ipCompLeaf+m_ipCompStart[b];
+			for (int k=0; k < sz; ++k) {
+				m_ipImage[ipLeafA[k]]=ipLeafB[k];
+				m_ipImage[ipLeafB[k]]=ipLeafA[k];
+			}
+			int k=0;
+			while (k < sz && mapsEdges(ipLeafA[k]))
+				++k;
+			if (k < sz)
+				continue;
+			growGenerators(m_ipGenStart[m_iGenNum]+(sz << 1));
+			int* ipMove=m_ipMove+(m_ipGenStart[m_iGenNum] << 1);
+			for (k=0; k < sz; ++k) {
+				ipMove[k<<2]=ipLeafA[k];
+				ipMove[(k<<2)+1]=ipLeafB[k];
+				ipMove[(k<<2)+2]=ipLeafB[k];
+				ipMove[(k<<2)+3]=ipLeafA[k];
+			}
+			addGenerator(sz << 1,ipMove);
+		}
+	}
+};
+
+inline bool CSymmetryCache::copyGenerators(unsigned long long fp, int vertNum, CSymmetryDetector &det)
+{
+	bool found=false;
+#ifndef __ONE_THREAD_
+	_MUTEX* pMutex=&m_mutex;
+	_MUTEX_LOCK(pMutex)
+#endif
+	try {
+		for (int e=0; e < m_iSize; ++e) {
+			const tagEntry &entry=m_pEntry[e];
+			if (entry.fp == fp && entry.vertNum == vertNum) {
+				for (int k=0; k < entry.genNum; ++k)
+					det.addGenerator(entry.ipStart[k+1]-entry.ipStart[k],entry.ipMove+(entry.ipStart[k] << 1));
+				++m_iHitNum;
+				found=true;
+				break;
+			}
+		}
+	}
+	catch(CMemoryException* pe) {
+#ifndef __ONE_THREAD_
+		_MUTEX_UNLOCK(pMutex)
+#endif
+		throw pe;
+	}
+#ifndef __ONE_THREAD_
+	_MUTEX_UNLOCK(pMutex)
+#endif
+	return found;
+} // end of CSymmetryCache::copyGenerators()
+
+#endif // __SYMMETRY_H_
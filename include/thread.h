@@ -33,10 +33,12 @@
 #include <thread>
 #include <mutex>
 #include <shared_mutex>
+#include <condition_variable>
 
 typedef std::thread _THREAD;  ///< Alias for `pthread_t`.
 typedef std::mutex _MUTEX; ///< Alias for `pthread_mutex_t`.
 typedef std::shared_mutex _RWLOCK; ///< Alias for `pthread_rwlock_t`.
+typedef std::condition_variable_any _COND; ///< Alias for `pthread_cond_t`.
 
 #define _THREAD_CREATE(_thread,start_thread,param) \
 		_thread = std::thread(start_thread,param); ///< Creates a new thread with start function `start_thread()`, that gets `param` as an argument.
@@ -84,6 +86,15 @@ typedef std::shared_mutex _RWLOCK; ///< Alias for `pthread_rwlock_t`.
 #define _MUTEX_ASSIGN_P(pmutex,value) \
 	pmutex=value; ///< Assigns the value of `value` to mutex pointer `pmutex`.
 
+#define _COND_INIT(cond) ///< Initializes the condition variable represented by `cond`.
+#define _COND_DESTROY(cond) ///< Destroys the condition variable represented by `cond`.
+#define _COND_WAIT(pcond,pmutex) \
+	(pcond)->wait(*(pmutex)); ///< Unlocks the mutex pointed by `pmutex`, waits on the condition variable pointed by `pcond`, and locks the mutex again.
+#define _COND_SIGNAL(pcond) \
+	(pcond)->notify_one(); ///< Wakes up one thread waiting on the condition variable pointed by `pcond`.
+#define _COND_BROADCAST(pcond) \
+	(pcond)->notify_all(); ///< Wakes up all threads waiting on the condition variable pointed by `pcond`.
+
 ///////////////////////////////// end for C++ 17 threads
 #else
 #ifdef _WINDOWS
@@ -95,6 +106,7 @@ typedef std::shared_mutex _RWLOCK; ///< Alias for `pthread_rwlock_t`.
 typedef HANDLE _THREAD; ///< Alias for `HANDLE`.
 typedef CRITICAL_SECTION _MUTEX; ///< Alias for `CRITICAL_SECTION`.
 typedef SRWLOCK _RWLOCK; ///< Alias for `SRWLOCK`.
+typedef CONDITION_VARIABLE _COND; ///< Alias for `CONDITION_VARIABLE`.
 
 #define _THREAD_CREATE(thread,start_thread,param) \
 		{thread = (HANDLE)_beginthreadex(0,0,&(start_thread),param,0,0);} ///< Creates a new thread with start function `start_thread()`, that gets `param` as an argument.
@@ -147,6 +159,16 @@ typedef SRWLOCK _RWLOCK; ///< Alias for `SRWLOCK`.
 	ReleaseSRWLockExclusive(rwLock);  ///< A safer version of `_RWLOCK_UNLOCK()`.
 #define _RWLOCK_ASSIGN_P(plock,pvalue) \
 	plock=pvalue; ///< Assigns the value of `pvalue` to `_RWLOCK` pointer `plock`.
+
+#define _COND_INIT(cond) \
+	InitializeConditionVariable(&cond); ///< Initializes the condition variable represented by `cond`.
+#define _COND_DESTROY(cond) ///< Destroys the condition variable represented by `cond`.
+#define _COND_WAIT(pcond,pmutex) \
+	SleepConditionVariableCS(pcond,pmutex,INFINITE); ///< Leaves critical section pointed by `pmutex`, waits on the condition variable pointed by `pcond`, and enters the critical section again.
+#define _COND_SIGNAL(pcond) \
+	WakeConditionVariable(pcond); ///< Wakes up one thread waiting on the condition variable pointed by `pcond`.
+#define _COND_BROADCAST(pcond) \
+	WakeAllConditionVariable(pcond); ///< Wakes up all threads waiting on the condition variable pointed by `pcond`.
 ///////////////////////////////// end for WINDOWS threads
 #else
 #include <unistd.h>
@@ -155,6 +177,7 @@ typedef SRWLOCK _RWLOCK; ///< Alias for `SRWLOCK`.
 typedef pthread_t _THREAD;  ///< Alias for `pthread_t`.
 typedef pthread_mutex_t _MUTEX; ///< Alias for `pthread_mutex_t`.
 typedef pthread_rwlock_t _RWLOCK; ///< Alias for `pthread_rwlock_t`.
+typedef pthread_cond_t _COND; ///< Alias for `pthread_cond_t`.
 
 #define _THREAD_CREATE(thread,start_thread,param) \
 		pthread_create(&(thread),NULL,start_thread,param); ///< Creates a new thread with start function `start_thread()`, that gets `param` as an argument.
@@ -205,6 +228,17 @@ typedef pthread_rwlock_t _RWLOCK; ///< Alias for `pthread_rwlock_t`.
 		pthread_mutex_unlock(pmutex); ///< A safer version of `_MUTEX_UNLOCK()`.
 #define _MUTEX_ASSIGN_P(pmutex,value) \
 	pmutex=value; ///< Assigns the value of `value` to mutex pointer `pmutex`.
+
+#define _COND_INIT(cond) \
+	pthread_cond_init(&cond,NULL); ///< Initializes the condition variable represented by `cond`.
+#define _COND_DESTROY(cond) \
+	pthread_cond_destroy(&cond); ///< Destroys the condition variable represented by `cond`.
+#define _COND_WAIT(pcond,pmutex) \
+	pthread_cond_wait(pcond,pmutex); ///< Unlocks the mutex pointed by `pmutex`, waits on the condition variable pointed by `pcond`, and locks the mutex again.
+#define _COND_SIGNAL(pcond) \
+	pthread_cond_signal(pcond); ///< Wakes up one thread waiting on the condition variable pointed by `pcond`.
+#define _COND_BROADCAST(pcond) \
+	pthread_cond_broadcast(pcond); ///< Wakes up all threads waiting on the condition variable pointed by `pcond`.
 #endif /* #elif _WINDOWS */
 #endif /* #ifdef _CPP_THREADFS */
 #else